@@ -0,0 +1,135 @@
+#ifndef NABLA_ALIGNED_ACCESSOR_HPP
+#define NABLA_ALIGNED_ACCESSOR_HPP
+
+#include <concepts>
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+#include "nabla/types.hpp"
+#include "nabla/default_accessor.hpp"
+
+namespace nabla {
+
+// Accessor over plain memory whose data handle is aligned to ByteAlignment
+// bytes, e.g. a span of a TensorArray backed by aligned_vector. Element
+// access and the evaluator's kernels see the pointer through
+// std::assume_aligned. Offsetting the handle loses the guarantee, so
+// subspans fall back to default_accessor.
+template <typename T, std::size_t ByteAlignment = 64>
+class aligned_accessor;
+
+template <typename T, std::size_t ByteAlignment>
+class aligned_accessor<const T, ByteAlignment> {
+    static_assert(ByteAlignment >= alignof(T) && (ByteAlignment & (ByteAlignment - 1)) == 0,
+                  "nabla::aligned_accessor: alignment must be a power of two no less than alignof(T)");
+
+    public:
+        using element_type = const T;
+        using reference = const T&;
+        using data_handle_type = T*;
+        using offset_policy = default_accessor<const T>;
+        using read_accessor_type = aligned_accessor;
+        using write_accessor_type = aligned_accessor<T, ByteAlignment>;
+
+        static constexpr std::size_t byte_alignment = ByteAlignment;
+
+        constexpr aligned_accessor() noexcept = default;
+
+        template <typename OtherElementType, std::size_t OtherByteAlignment>
+            requires std::is_convertible_v<OtherElementType(*)[], element_type(*)[]> && (OtherByteAlignment >= ByteAlignment)
+        constexpr aligned_accessor(aligned_accessor<OtherElementType, OtherByteAlignment>) noexcept {}
+
+        constexpr operator default_accessor<const T>() const noexcept {
+            return {};
+        }
+
+        constexpr reference access(data_handle_type p, std::size_t i) const noexcept {
+            return std::assume_aligned<ByteAlignment>(p)[i];
+        }
+
+        constexpr typename offset_policy::data_handle_type offset(data_handle_type p, std::size_t i) const noexcept {
+            return p + i;
+        }
+
+        write_accessor_type to_write() const noexcept {
+            return {};
+        }
+};
+
+template <typename T, std::size_t ByteAlignment>
+class aligned_accessor : public aligned_accessor<const T, ByteAlignment> {
+    public:
+        using element_type = T;
+        using reference = T&;
+        using data_handle_type = T*;
+        using offset_policy = default_accessor<T>;
+        using read_accessor_type = aligned_accessor<const T, ByteAlignment>;
+        using write_accessor_type = aligned_accessor;
+
+        constexpr aligned_accessor() noexcept = default;
+
+        template <typename OtherElementType, std::size_t OtherByteAlignment>
+            requires std::is_convertible_v<OtherElementType(*)[], element_type(*)[]> && (OtherByteAlignment >= ByteAlignment)
+        constexpr aligned_accessor(aligned_accessor<OtherElementType, OtherByteAlignment>) noexcept {}
+
+        constexpr operator default_accessor<T>() const noexcept {
+            return {};
+        }
+
+        constexpr reference access(data_handle_type p, std::size_t i) const noexcept {
+            return std::assume_aligned<ByteAlignment>(p)[i];
+        }
+
+        constexpr typename offset_policy::data_handle_type offset(data_handle_type p, std::size_t i) const noexcept {
+            return p + i;
+        }
+
+        write_accessor_type to_write() const noexcept {
+            return {};
+        }
+};
+
+namespace detail {
+
+    // Alignment in bytes that Accessor guarantees for its data handle, 0
+    // when it does not read plain memory through the handle
+    template <typename Accessor>
+    inline constexpr std::size_t pointer_alignment = 0;
+
+    template <typename T>
+    inline constexpr std::size_t pointer_alignment<default_accessor<T>> = alignof(T);
+
+    template <typename T, std::size_t ByteAlignment>
+    inline constexpr std::size_t pointer_alignment<aligned_accessor<T, ByteAlignment>> = ByteAlignment;
+
+    // Accessors whose data handle owns or tracks plain memory, such as a
+    // shared_ptr, opt in to the pointer fast paths with a member
+    // raw_pointer(p) such that access(p, i) is raw_pointer(p)[i]. Kernels
+    // resolve the pointer once per traversal instead of passing the handle
+    // to every access.
+    template <typename Accessor>
+    concept HasRawPointer = requires(const Accessor& a, const typename Accessor::data_handle_type& p) {
+        { a.raw_pointer(p) } -> std::same_as<typename Accessor::element_type*>;
+    };
+
+    // Accessors that read elements straight from memory
+    template <typename Accessor>
+    concept IsPlainMemoryAccessor =
+        HasRawPointer<Accessor> ||
+        (std::is_pointer_v<typename Accessor::data_handle_type> && pointer_alignment<Accessor> != 0);
+
+    template <typename Accessor>
+        requires IsPlainMemoryAccessor<Accessor>
+    constexpr typename Accessor::element_type* raw_pointer(const Accessor& a, const typename Accessor::data_handle_type& p) noexcept {
+        if constexpr (HasRawPointer<Accessor>) {
+            return a.raw_pointer(p);
+        } else {
+            return p;
+        }
+    }
+
+} // namespace detail
+
+} // namespace nabla
+
+#endif // NABLA_ALIGNED_ACCESSOR_HPP
@@ -0,0 +1,150 @@
+#ifndef NABLA_ALIGNED_ALLOCATOR_HPP
+#define NABLA_ALIGNED_ALLOCATOR_HPP
+
+#include <cerrno>
+#include <cstddef>
+#include <limits>
+#include <new>
+#include <sstream>
+#include <stacktrace>
+#include <system_error>
+#include <type_traits>
+#include <vector>
+
+#if __has_include(<sys/mman.h>)
+#include <sys/mman.h>
+#define NABLA_HAS_MMAN 1
+#else
+#define NABLA_HAS_MMAN 0
+#endif
+
+// Allocator for TensorArray containers with a guaranteed alignment, so that
+// kernels may use aligned vector loads from the first element, e.g.
+//
+//     nb::TensorArray<float, nb::dims<2>, nb::LeftStride, nb::aligned_vector<float>> a(n, n);
+//
+// Hints ask the OS for transparent huge pages, cutting TLB misses on large
+// tensors, and for the pages to be locked in memory. Huge pages are a best
+// effort hint; failing to lock throws. Both are ignored on systems without
+// <sys/mman.h>.
+
+namespace nabla {
+
+enum class memory_hint : unsigned {
+    none = 0,
+    huge_pages = 1, // madvise(MADV_HUGEPAGE) allocations of at least one huge page
+    locked = 2,     // mlock the allocation
+};
+
+constexpr memory_hint operator|(memory_hint a, memory_hint b) noexcept {
+    return static_cast<memory_hint>(static_cast<unsigned>(a) | static_cast<unsigned>(b));
+}
+
+constexpr bool has_hint(memory_hint hints, memory_hint h) noexcept {
+    return (static_cast<unsigned>(hints) & static_cast<unsigned>(h)) != 0;
+}
+
+template <typename T, std::size_t Alignment = 64, memory_hint Hints = memory_hint::none>
+class aligned_allocator {
+    static_assert(Alignment >= alignof(T) && (Alignment & (Alignment - 1)) == 0,
+                  "nabla::aligned_allocator: alignment must be a power of two no less than alignof(T)");
+
+    public:
+        using value_type = T;
+        using size_type = std::size_t;
+        using difference_type = std::ptrdiff_t;
+        using is_always_equal = std::true_type;
+        using propagate_on_container_move_assignment = std::true_type;
+
+        static constexpr std::size_t alignment = Alignment;
+        static constexpr memory_hint hints = Hints;
+        // size and alignment of the transparent huge pages on x86-64 and aarch64
+        static constexpr std::size_t huge_page_size = std::size_t(1) << 21;
+
+        template <typename U>
+        struct rebind {
+            using other = aligned_allocator<U, Alignment, Hints>;
+        };
+
+        constexpr aligned_allocator() noexcept = default;
+
+        template <typename U>
+        constexpr aligned_allocator(const aligned_allocator<U, Alignment, Hints>&) noexcept {}
+
+        [[nodiscard]] T* allocate(std::size_t n) {
+            if (n > std::numeric_limits<std::size_t>::max() / sizeof(T)) {
+                throw std::bad_array_new_length();
+            }
+            const auto [bytes, align] = _layout(n);
+            void* p = ::operator new(bytes, std::align_val_t{align});
+#if NABLA_HAS_MMAN
+            if constexpr (has_hint(Hints, memory_hint::huge_pages)) {
+                if (align == huge_page_size) {
+                    ::madvise(p, bytes, MADV_HUGEPAGE);
+                }
+            }
+            if constexpr (has_hint(Hints, memory_hint::locked)) {
+                if (::mlock(p, bytes) != 0) {
+                    const int error = errno;
+                    ::operator delete(p, bytes, std::align_val_t{align});
+                    std::stringstream ss;
+                    ss << "nabla::aligned_allocator error: mlock of " << bytes << " bytes failed"
+                        << "\n\n"
+                        << std::stacktrace::current() << std::endl;
+                    throw std::system_error(error, std::generic_category(), ss.str());
+                }
+            }
+#endif
+            return static_cast<T*>(p);
+        }
+
+        void deallocate(T* p, std::size_t n) noexcept {
+            const auto [bytes, align] = _layout(n);
+#if NABLA_HAS_MMAN
+            if constexpr (has_hint(Hints, memory_hint::locked)) {
+                ::munlock(p, bytes);
+            }
+#endif
+            ::operator delete(p, bytes, std::align_val_t{align});
+        }
+
+        template <typename U>
+        friend constexpr bool operator==(const aligned_allocator&, const aligned_allocator<U, Alignment, Hints>&) noexcept {
+            return true;
+        }
+
+    private:
+        struct layout {
+            std::size_t bytes;
+            std::size_t align;
+        };
+
+        // Allocations that span a huge page are aligned to and padded to
+        // whole huge pages, so that madvise covers all of them
+        static constexpr layout _layout(std::size_t n) noexcept {
+            const std::size_t bytes = n * sizeof(T);
+            if constexpr (has_hint(Hints, memory_hint::huge_pages) && Alignment < huge_page_size) {
+                if (bytes >= huge_page_size) {
+                    return {(bytes + huge_page_size - 1) / huge_page_size * huge_page_size, huge_page_size};
+                }
+            }
+            return {bytes, Alignment};
+        }
+};
+
+template <typename T, std::size_t Alignment = 64, memory_hint Hints = memory_hint::none>
+using aligned_vector = std::vector<T, aligned_allocator<T, Alignment, Hints>>;
+
+namespace detail {
+
+    template <typename Allocator>
+    struct allocator_alignment : std::integral_constant<std::size_t, alignof(typename Allocator::value_type)> {};
+
+    template <typename T, std::size_t Alignment, memory_hint Hints>
+    struct allocator_alignment<aligned_allocator<T, Alignment, Hints>> : std::integral_constant<std::size_t, Alignment> {};
+
+} // namespace detail
+
+} // namespace nabla
+
+#endif // NABLA_ALIGNED_ALLOCATOR_HPP
@@ -0,0 +1,301 @@
+#ifndef NABLA_ASSIGN_HPP
+#define NABLA_ASSIGN_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <sstream>
+#include <stacktrace>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include "nabla/types.hpp"
+#include "nabla/concepts.hpp"
+#include "nabla/broadcast.hpp"
+#include "nabla/expr_evaluator.hpp"
+#include "nabla/parallel.hpp"
+
+namespace nabla {
+
+namespace detail {
+
+    template <typename Dst, typename Src>
+    concept IsBulkCopyable =
+        IsPointerBacked<Dst> && IsPointerBacked<Src> &&
+        std::is_same_v<typename std::remove_cvref_t<Dst>::value_type, typename std::remove_cvref_t<Src>::value_type> &&
+        std::is_trivially_copyable_v<typename std::remove_cvref_t<Dst>::value_type>;
+
+    template <typename Dst, typename Src>
+    void assert_same_extents(const Dst& dst, const Src& src, const char* caller = "nabla::assign") {
+        static_assert(Dst::rank() == Src::rank(), "nabla: rank mismatch");
+        for (typename Dst::rank_type r = 0; r < Dst::rank(); ++r) {
+            if (static_cast<std::size_t>(dst.extent(r)) != static_cast<std::size_t>(src.extent(r))) {
+                std::stringstream ss;
+                ss << caller << " error: extents mismatch\n"
+                    << "\tdestination: " << nabla::temp::to_string(dst.extents()) << "\n"
+                    << "\tsource:      " << nabla::temp::to_string(src.extents()) << "\n"
+                    << "\n\n"
+                    << std::stacktrace::current() << std::endl;
+                throw std::invalid_argument(ss.str());
+            }
+        }
+    }
+
+    template <typename MapA, typename MapB>
+    constexpr bool same_strides(const MapA& a, const MapB& b) noexcept {
+        for (typename MapA::rank_type r = 0; r < MapA::extents_type::rank(); ++r) {
+            if (static_cast<std::size_t>(a.stride(r)) != static_cast<std::size_t>(b.stride(r))) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // Number of leading dimensions that form one contiguous run of memory,
+    // together with the length of that run. Zero dims when stride(0) != 1.
+    template <typename MapT>
+    constexpr std::pair<std::size_t, std::size_t> contiguous_prefix(const MapT& map) noexcept {
+        constexpr std::size_t rank = MapT::extents_type::rank();
+        std::size_t run = 1;
+        std::size_t dims = 0;
+        for (; dims < rank; ++dims) {
+            if (static_cast<std::size_t>(map.stride(dims)) != run) {
+                break;
+            }
+            run *= static_cast<std::size_t>(map.extents().extent(dims));
+        }
+        return {dims, run};
+    }
+
+    // Calls f(offset) with the flat offset of the first element of every
+    // contiguous run, where the first `inner_dims` dimensions form the run.
+    // The remaining dimensions are walked in left-major order.
+    template <typename MapT, typename F>
+    void for_each_run(const MapT& map, std::size_t inner_dims, F&& f) {
+        using index_type = typename MapT::index_type;
+        constexpr std::size_t rank = MapT::extents_type::rank();
+        for (std::size_t r = 0; r < rank; ++r) {
+            if (map.extents().extent(r) == 0) {
+                return;
+            }
+        }
+        std::array<index_type, rank> idx{};
+        index_type offset = 0;
+        while (true) {
+            f(offset);
+            std::size_t r = inner_dims;
+            for (; r < rank; ++r) {
+                offset += map.stride(r);
+                if (++idx[r] < map.extents().extent(r)) {
+                    break;
+                }
+                offset -= map.stride(r) * map.extents().extent(r);
+                idx[r] = 0;
+            }
+            if (r >= rank) {
+                return;
+            }
+        }
+    }
+
+    template <typename Dst, typename Src>
+    void assign_elementwise(Dst& dst, const Src& src) {
+        if constexpr (is_same_order<Dst, Src>) {
+            auto it = dst.begin();
+            auto end_it = dst.end();
+            auto other_it = src.begin();
+            for (; it != end_it; ++it, ++other_it) {
+                *it = *other_it;
+            }
+        } else {
+            // iterators of different layouts disagree on order, go by index
+            for (auto it = dst.mapping().begin(); it != dst.mapping().end(); ++it) {
+                std::apply([&](auto... idx) { dst(idx...) = src(idx...); }, it.indices());
+            }
+        }
+    }
+
+    // Copies through memmove when both sides share a layout, otherwise
+    // returns false and leaves dst untouched.
+    template <typename Dst, typename Src>
+    bool try_bulk_copy(Dst& dst, const Src& src) {
+        if constexpr (IsBulkCopyable<Dst, Src>) {
+            using value_type = typename std::remove_cvref_t<Dst>::value_type;
+            if (!same_strides(dst.mapping(), src.mapping())) {
+                return false;
+            }
+            auto* out = data_pointer(dst);
+            const auto* in = data_pointer(src);
+            if (dst.is_exhaustive()) {
+                std::memmove(out, in, static_cast<std::size_t>(dst.size()) * sizeof(value_type));
+                return true;
+            }
+            auto [inner_dims, run] = contiguous_prefix(dst.mapping());
+            if (inner_dims == 0) {
+                return false;
+            }
+            for_each_run(dst.mapping(), inner_dims, [&](auto offset) {
+                std::memmove(out + offset, in + offset, run * sizeof(value_type));
+            });
+            return true;
+        } else {
+            return false;
+        }
+    }
+
+    // Element types with a vectorized conversion kernel, such as float16 to
+    // float (see half.hpp). Specializations derive from std::true_type and
+    // provide static void convert(const From* in, To* out, std::size_t n).
+    template <typename To, typename From>
+    struct bulk_converter : std::false_type {};
+
+    template <typename Dst, typename Src>
+    concept IsBulkConvertible =
+        IsPointerBacked<Dst> && IsPointerBacked<Src> &&
+        bulk_converter<typename std::remove_cvref_t<Dst>::value_type, typename std::remove_cvref_t<Src>::value_type>::value;
+
+    // Converts through bulk_converter when both sides share a layout,
+    // otherwise returns false and leaves dst untouched.
+    template <typename Dst, typename Src>
+    bool try_bulk_convert(Dst& dst, const Src& src) {
+        if constexpr (IsBulkConvertible<Dst, Src>) {
+            using converter = bulk_converter<typename std::remove_cvref_t<Dst>::value_type, typename std::remove_cvref_t<Src>::value_type>;
+            if (!same_strides(dst.mapping(), src.mapping())) {
+                return false;
+            }
+            auto* out = data_pointer(dst);
+            const auto* in = data_pointer(src);
+            if (dst.is_exhaustive()) {
+                converter::convert(in, out, static_cast<std::size_t>(dst.size()));
+                return true;
+            }
+            auto [inner_dims, run] = contiguous_prefix(dst.mapping());
+            if (inner_dims == 0) {
+                return false;
+            }
+            for_each_run(dst.mapping(), inner_dims, [&](auto offset) {
+                converter::convert(in + offset, out + offset, run);
+            });
+            return true;
+        } else {
+            return false;
+        }
+    }
+
+    template <typename Dst, typename T>
+    void fill(Dst& dst, const T& value) {
+        if constexpr (IsPointerBacked<Dst>) {
+            using value_type = typename std::remove_cvref_t<Dst>::value_type;
+            auto* out = data_pointer(dst);
+            if (dst.is_exhaustive()) {
+                const auto size = static_cast<std::size_t>(dst.size());
+                if (use_streaming_stores<value_type>(size * sizeof(value_type), 0)) {
+                    const value_type v = value;
+                    stream_line(out, 0, static_cast<std::ptrdiff_t>(size), [v](std::ptrdiff_t) { return v; });
+                    stream_fence();
+                } else {
+                    std::fill_n(out, size, value);
+                }
+                return;
+            }
+            auto [inner_dims, run] = contiguous_prefix(dst.mapping());
+            if (inner_dims > 0) {
+                for_each_run(dst.mapping(), inner_dims, [&](auto offset) {
+                    std::fill_n(out + offset, run, value);
+                });
+                return;
+            }
+        }
+        for (auto it = dst.begin(); it != dst.end(); ++it) {
+            *it = value;
+        }
+    }
+
+    // Assigns on the calling thread, prefetching strided rows by the
+    // distance of `policy`
+    template <typename Dst, typename Src, typename Policy>
+    void assign_sequential(Dst& dst, const Src& src, const Policy& policy) {
+        using dst_type = std::remove_cvref_t<Dst>;
+#ifdef NABLA_DEBUG
+        assert_same_extents(dst, src);
+#endif
+        if constexpr (!IsTensorExpr<Src>) {
+            if (try_bulk_copy(dst, src) || try_bulk_convert(dst, src)) {
+                return;
+            }
+        }
+        if constexpr (IsEvaluable<dst_type> && dst_type::rank() > 0) {
+            evaluate(dst, src, policy);
+        } else {
+            assign_elementwise(dst, src);
+        }
+    }
+
+} // namespace detail
+
+// Assigns src to dst elementwise. Uses a bulk copy when both operands are
+// plain memory with identical strides and trivially copyable elements, or
+// a bulk conversion when their element types have one, the nested-loop
+// evaluator when the destination is plain memory, and falls back to
+// iterating both sides otherwise.
+template <typename Dst, typename Src>
+    requires (IsTensorSpan<Dst> || IsTensorArray<Dst>) && IsTensorLike<Src>
+void assign(Dst&& dst, const Src& src) {
+    detail::assign_sequential(dst, src, seq);
+}
+
+// Assigns src to dst under an execution policy. The parallel policy splits
+// the destination's elements, in its natural order, into chunks of at least
+// grain_size elements that are evaluated by the thread pool. Chunks are
+// rounded to whole rows when rows are shorter than the grain. Destinations
+// larger than policy.streaming_threshold are written with streaming stores, and
+// rows that skip cache lines prefetch policy.prefetch_distance elements ahead.
+// Copies between element types with a bulk converter, such as float to
+// float16, run its kernel over the chunks. Destinations the evaluator does
+// not write to memory (see IsEvaluable) are assigned on the calling thread.
+template <typename Policy, typename Dst, typename Src>
+    requires IsExecutionPolicy<Policy> && (IsTensorSpan<Dst> || IsTensorArray<Dst>) && IsTensorLike<Src>
+void assign(const Policy& policy, Dst&& dst, const Src& src) {
+    using dst_type = std::remove_cvref_t<Dst>;
+    if constexpr (std::is_same_v<std::remove_cvref_t<Policy>, parallel_policy> &&
+                  detail::IsEvaluable<dst_type> && dst_type::rank() > 0) {
+#ifdef NABLA_DEBUG
+        detail::assert_same_extents(dst, src);
+#endif
+        if constexpr (detail::IsBulkConvertible<dst_type, Src>) {
+            using converter = detail::bulk_converter<typename dst_type::value_type, typename Src::value_type>;
+            if (dst.is_exhaustive() && detail::same_strides(dst.mapping(), src.mapping())) {
+                auto* out = detail::data_pointer(dst);
+                const auto* in = detail::data_pointer(src);
+                parallel_for(policy, static_cast<std::size_t>(dst.size()), policy.grain_size, [&](std::size_t begin, std::size_t end) {
+                    converter::convert(in + begin, out + begin, end - begin);
+                });
+                return;
+            }
+        }
+        auto kernel = detail::lower_into(dst, src);
+        auto* out = detail::output_pointer(dst);
+        auto tiles = detail::make_tile_plan(dst, kernel);
+        detail::set_prefetch(tiles.plan, policy);
+        if (tiles.inner != 0) {
+            const std::size_t grain = (policy.grain_size + tiles.panel - 1) / tiles.panel * tiles.panel;
+            parallel_for(policy, tiles.panels * tiles.panel, grain, [&](std::size_t begin, std::size_t end) {
+                detail::evaluate_tiles(out, tiles, kernel, begin, end);
+            });
+            return;
+        }
+        const auto& plan = tiles.plan;
+        const std::size_t grain = detail::chunk_grain(plan, policy.grain_size);
+        const bool stream = detail::streams(dst, plan, policy.streaming_threshold);
+        parallel_for(policy, plan.size, grain, [&](std::size_t begin, std::size_t end) {
+            auto local_kernel = kernel;
+            detail::evaluate_plan(out, plan, local_kernel, begin, end, stream);
+        });
+    } else {
+        detail::assign_sequential(dst, src, policy);
+    }
+}
+
+} // namespace nabla
+
+#endif // NABLA_ASSIGN_HPP
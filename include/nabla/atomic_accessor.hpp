@@ -0,0 +1,112 @@
+#ifndef NABLA_ATOMIC_ACCESSOR_HPP
+#define NABLA_ATOMIC_ACCESSOR_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <type_traits>
+
+// Accessor for tensors that several threads update at once, e.g. a grid that
+// particles are deposited into. Elements are accessed through
+// std::atomic_ref, so the same memory can be viewed by a plain span before
+// and after the concurrent phase:
+//
+//     nb::TensorArray<double, nb::dims<2>> grid(nx, ny);
+//     auto shared = grid.to_span(nb::atomic_accessor<double>{});
+//     // in every thread
+//     nb::atomic_add(shared(i, j), w);
+//
+// Reads through the const accessor are relaxed atomic loads. The data must be
+// aligned to std::atomic_ref<T>::required_alignment, which exceeds alignof(T)
+// for some types such as std::complex<double>; heap allocations are.
+
+namespace nabla {
+
+template <typename T>
+class atomic_accessor;
+
+template <typename T>
+class atomic_accessor<const T> {
+    // elements are then aligned for std::atomic_ref whenever the data is
+    static_assert(sizeof(T) % std::atomic_ref<T>::required_alignment == 0,
+                  "nabla::atomic_accessor: elements cannot be aligned for std::atomic_ref");
+
+    public:
+        using element_type = const T;
+        using reference = T;
+        using data_handle_type = T*;
+        using offset_policy = atomic_accessor;
+        using read_accessor_type = atomic_accessor;
+        using write_accessor_type = atomic_accessor<T>;
+
+        constexpr atomic_accessor() noexcept = default;
+
+        template <typename OtherElementType>
+            requires std::is_convertible_v<OtherElementType(*)[], element_type(*)[]>
+        constexpr atomic_accessor(atomic_accessor<OtherElementType>) noexcept {}
+
+        reference access(data_handle_type p, std::size_t i) const noexcept {
+            return std::atomic_ref<T>(p[i]).load(std::memory_order_relaxed);
+        }
+
+        constexpr data_handle_type offset(data_handle_type p, std::size_t i) const noexcept {
+            return p + i;
+        }
+
+        write_accessor_type to_write() const noexcept {
+            return {};
+        }
+};
+
+template <typename T>
+class atomic_accessor : public atomic_accessor<const T> {
+    public:
+        using element_type = T;
+        using reference = std::atomic_ref<T>;
+        using data_handle_type = T*;
+        using offset_policy = atomic_accessor;
+        using read_accessor_type = atomic_accessor<const T>;
+        using write_accessor_type = atomic_accessor;
+
+        constexpr atomic_accessor() noexcept = default;
+
+        template <typename OtherElementType>
+            requires std::is_convertible_v<OtherElementType(*)[], element_type(*)[]>
+        constexpr atomic_accessor(atomic_accessor<OtherElementType>) noexcept {}
+
+        reference access(data_handle_type p, std::size_t i) const noexcept {
+            return reference(p[i]);
+        }
+
+        constexpr data_handle_type offset(data_handle_type p, std::size_t i) const noexcept {
+            return p + i;
+        }
+
+        write_accessor_type to_write() const noexcept {
+            return {};
+        }
+};
+
+// Adds value to the element behind ref. Arithmetic types use fetch_add,
+// others, such as std::complex, a compare-and-swap loop. Relaxed by
+// default, which is enough for sums that are read after the threads join.
+template <typename T>
+void atomic_add(std::atomic_ref<T> ref, const std::type_identity_t<T>& value, std::memory_order order = std::memory_order_relaxed) noexcept {
+    if constexpr (requires { ref.fetch_add(value, order); }) {
+        ref.fetch_add(value, order);
+    } else {
+        T expected = ref.load(std::memory_order_relaxed);
+        while (!ref.compare_exchange_weak(expected, expected + value, order, std::memory_order_relaxed)) {
+        }
+    }
+}
+
+// Plain element, for code that deposits into atomic and private tensors alike
+template <typename T>
+    requires (!std::is_const_v<T>)
+void atomic_add(T& ref, const std::type_identity_t<T>& value, std::memory_order = std::memory_order_relaxed) noexcept {
+    ref += value;
+}
+
+} // namespace nabla
+
+#endif // NABLA_ATOMIC_ACCESSOR_HPP
@@ -0,0 +1,144 @@
+#ifndef NABLA_BROADCAST_HPP
+#define NABLA_BROADCAST_HPP
+
+#include <array>
+#include <cstddef>
+#include <sstream>
+#include <stacktrace>
+#include <stdexcept>
+#include <tuple>
+#include <type_traits>
+#include "nabla/types.hpp"
+#include "nabla/concepts.hpp"
+#include "nabla/layout/left_broadcast.hpp"
+
+// NumPy-style broadcasting for operands of equal rank: a dimension of extent
+// 1 stretches to match the other operands, any other mismatch is an error.
+// Stretched dimensions get stride 0 in a LeftBroadcast view, so nothing is
+// copied. Broadcast views always iterate left-major, which also gives
+// operands of different layouts a common iteration order.
+
+namespace nabla {
+
+namespace detail {
+
+    template <typename T>
+    using broadcast_coord_t = std::array<std::size_t, std::remove_cvref_t<T>::rank()>;
+
+    // Whether every element of T is visited in the order of Layout's
+    // iterator; for an expression, whether that holds for all its leaves
+    template <typename T, typename... Layouts>
+    constexpr bool is_ordered_as() {
+        using U = std::remove_cvref_t<T>;
+        if constexpr (IsTensorExpr<U>) {
+            return []<typename... Inputs>(std::type_identity<std::tuple<Inputs...>>) {
+                return (is_ordered_as<Inputs, Layouts...>() && ...);
+            }(std::type_identity<typename U::inputs_type>{});
+        } else {
+            return (std::is_same_v<typename U::layout_type, Layouts> || ...);
+        }
+    }
+
+    template <typename T>
+    inline constexpr bool is_left_ordered = is_ordered_as<T, LeftStride, LeftBroadcast>();
+
+    template <typename T>
+    inline constexpr bool is_right_ordered = is_ordered_as<T, RightStride>();
+
+    // whether the iterators of A and B visit elements in the same order
+    template <typename A, typename B>
+    inline constexpr bool is_same_order =
+        (is_left_ordered<A> && is_left_ordered<B>) || (is_right_ordered<A> && is_right_ordered<B>);
+
+    // Inputs that have equal shapes by type alone and iterate in the same
+    // order never need broadcast views
+    template <typename... Ts>
+    inline constexpr bool is_statically_aligned =
+        sizeof...(Ts) <= 1 ||
+        ((std::is_same_v<typename std::remove_cvref_t<Ts>::extents_type,
+                         typename std::remove_cvref_t<std::tuple_element_t<0, std::tuple<Ts...>>>::extents_type> &&
+          std::remove_cvref_t<Ts>::extents_type::rank_dynamic() == 0 &&
+          is_same_order<Ts, std::tuple_element_t<0, std::tuple<Ts...>>>) && ...);
+
+    template <typename T, typename... Ts>
+    [[noreturn]] void throw_broadcast_error(std::size_t r, const T& first, const Ts&... rest) {
+        std::stringstream ss;
+        ss << "nabla::broadcast error: extents are not compatible in dimension " << r << "\n"
+            << "\toperands: " << nabla::temp::to_string(first.extents());
+        ((ss << ", " << nabla::temp::to_string(rest.extents())), ...);
+        ss << "\n\n\n"
+            << std::stacktrace::current() << std::endl;
+        throw std::invalid_argument(ss.str());
+    }
+
+    // Common extents of the operands
+    template <typename T, typename... Ts>
+    broadcast_coord_t<T> broadcast_extents(const T& first, const Ts&... rest) {
+        static_assert(((std::remove_cvref_t<Ts>::rank() == std::remove_cvref_t<T>::rank()) && ...),
+                      "nabla::broadcast: operands must have the same rank");
+        broadcast_coord_t<T> exts;
+        for (std::size_t r = 0; r < exts.size(); ++r) {
+            exts[r] = static_cast<std::size_t>(first.extent(r));
+            const bool compatible = ([&] {
+                const auto e = static_cast<std::size_t>(rest.extent(r));
+                if (e == exts[r] || e == 1) {
+                    return true;
+                }
+                if (exts[r] == 1) {
+                    exts[r] = e;
+                    return true;
+                }
+                return false;
+            }() && ...);
+            if (!compatible) {
+                throw_broadcast_error(r, first, rest...);
+            }
+        }
+        return exts;
+    }
+
+} // namespace detail
+
+// Read-only view of t stretched to extents exts. Every extent of t must
+// either equal the target extent or be 1.
+template <typename ElementType, typename Extents, typename LayoutPolicy, typename AccessorPolicy, typename IndexType>
+auto broadcast_to(const TensorSpan<ElementType, Extents, LayoutPolicy, AccessorPolicy>& t,
+                  const std::array<IndexType, Extents::rank()>& exts) {
+    using span_type = TensorSpan<ElementType, Extents, LayoutPolicy, AccessorPolicy>;
+    using index_type = typename span_type::index_type;
+    using view_extents = dextents<index_type, Extents::rank()>;
+    using view_accessor = typename AccessorPolicy::read_accessor_type;
+    using view_type = TensorSpan<std::add_const_t<ElementType>, view_extents, LeftBroadcast, view_accessor>;
+    using view_mapping = typename view_type::mapping_type;
+
+    typename view_mapping::coord_type view_exts;
+    typename view_mapping::coord_type strides;
+    for (std::size_t r = 0; r < Extents::rank(); ++r) {
+        view_exts[r] = static_cast<index_type>(exts[r]);
+        if (static_cast<std::size_t>(t.extent(r)) == static_cast<std::size_t>(exts[r])) {
+            strides[r] = t.stride(r);
+        } else if (t.extent(r) == 1) {
+            strides[r] = 0;
+        } else {
+            std::stringstream ss;
+            ss << "nabla::broadcast_to error: extents[" << r << "] = " << t.extent(r)
+                << " cannot be broadcast to " << exts[r] << "\n"
+                << "\textents: " << nabla::temp::to_string(t.extents()) << "\n"
+                << "\ttarget:  " << nabla::temp::to_string(view_exts) << "\n"
+                << "\n\n"
+                << std::stacktrace::current() << std::endl;
+            throw std::invalid_argument(ss.str());
+        }
+    }
+    return view_type(t.data_handle(), view_mapping(view_exts, strides), t.accessor());
+}
+
+template <typename ElementType, typename Extents, typename LayoutPolicy, typename Container, typename IndexType>
+auto broadcast_to(const TensorArray<ElementType, Extents, LayoutPolicy, Container>& t,
+                  const std::array<IndexType, Extents::rank()>& exts) {
+    return broadcast_to(t.to_span(), exts);
+}
+
+} // namespace nabla
+
+#endif // NABLA_BROADCAST_HPP
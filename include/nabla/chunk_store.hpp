@@ -0,0 +1,531 @@
+#ifndef NABLA_CHUNK_STORE_HPP
+#define NABLA_CHUNK_STORE_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <stacktrace>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "nabla/types.hpp"
+#include "nabla/concepts.hpp"
+#include "nabla/codec.hpp"
+#include "nabla/default_init_allocator.hpp"
+#include "nabla/dtype.hpp"
+#include "nabla/io.hpp"
+#include "nabla/parallel.hpp"
+#include "nabla/tensor_array.hpp"
+
+// Directory store of a tensor split into fixed N-d chunks, each compressed
+// on its own, for archives that are read back a region at a time, e.g.
+//
+//     nb::ChunkStore<double, nb::dims<3>> store("run.nbz", nb::dims<3>(512, 512, 4096), {64, 64, 64});
+//     store.write(nb::par, u, {0, 0, t0});
+//     auto slab = store.read(nb::par, nb::full_extent, 100, nb::strided_slice{0, 4096, 8});
+//
+// The directory holds a text metadata file and one file per chunk named by
+// its grid coordinates, "i.j.k". Chunks are stored in full, edge chunks
+// padded, and packed left-major; a chunk without a file holds value_type{}.
+// Reads and writes touch only the chunks overlapping the region, which are
+// (de)compressed and copied in parallel under nb::par. Regions that cover
+// part of a chunk are merged into its previous contents on write.
+
+namespace nabla {
+
+namespace detail {
+
+    inline constexpr const char* chunk_store_metadata = ".nabla_store";
+    inline constexpr std::uint32_t chunk_store_version = 1;
+
+    [[noreturn]] inline void throw_store_error(const std::filesystem::path& path, const std::string& what) {
+        std::stringstream ss;
+        ss << "nabla::ChunkStore error: " << path << ": " << what
+            << "\n\n"
+            << std::stacktrace::current() << std::endl;
+        throw std::invalid_argument(ss.str());
+    }
+
+    // A region of a store: count[r] indices begin[r] + step[r]*m along each
+    // dimension r, which is dropped from the result when dropped[r]
+    template <std::size_t Rank>
+    struct store_region {
+        std::array<std::size_t, Rank> begin{};
+        std::array<std::size_t, Rank> count{};
+        std::array<std::size_t, Rank> step{};
+        std::array<bool, Rank> dropped{};
+    };
+
+    template <typename S>
+    inline constexpr bool is_pair_slice = false;
+
+    template <typename B, typename E>
+    inline constexpr bool is_pair_slice<std::pair<B, E>> = true;
+
+    template <typename B, typename E>
+    inline constexpr bool is_pair_slice<std::tuple<B, E>> = true;
+
+    template <typename S>
+    inline constexpr bool is_strided_slice = false;
+
+    template <typename O, typename E, typename St>
+    inline constexpr bool is_strided_slice<strided_slice<O, E, St>> = true;
+
+    // Slice specifiers accepted by ChunkStore::read, as for subspan
+    template <typename S>
+    concept IsStoreSlice = std::is_integral_v<S> || std::is_same_v<S, mdspan_ns::full_extent_t> ||
+                           is_pair_slice<S> || is_strided_slice<S>;
+
+    template <typename S>
+    inline constexpr bool keeps_dimension = !std::is_integral_v<S>;
+
+    template <std::size_t Rank, typename S>
+    void set_slice(store_region<Rank>& region, std::size_t r, std::size_t extent, const S& s) {
+        region.step[r] = 1;
+        if constexpr (std::is_integral_v<S>) {
+            region.begin[r] = static_cast<std::size_t>(s);
+            region.count[r] = 1;
+            region.dropped[r] = true;
+        } else if constexpr (std::is_same_v<S, mdspan_ns::full_extent_t>) {
+            region.count[r] = extent;
+        } else if constexpr (is_pair_slice<S>) {
+            region.begin[r] = static_cast<std::size_t>(std::get<0>(s));
+            region.count[r] = static_cast<std::size_t>(std::get<1>(s)) - region.begin[r];
+        } else {
+            const auto len = static_cast<std::size_t>(s.extent);
+            region.begin[r] = static_cast<std::size_t>(s.offset);
+            region.step[r] = std::max<std::size_t>(static_cast<std::size_t>(s.stride), 1);
+            region.count[r] = len == 0 ? 0 : 1 + (len - 1) / region.step[r];
+        }
+    }
+
+} // namespace detail
+
+template <typename ElementType, typename Extents>
+class ChunkStore {
+    static_assert(std::is_trivially_copyable_v<ElementType> && !std::is_const_v<ElementType>,
+                  "nabla::ChunkStore: elements must be trivially copyable");
+    static_assert(Extents::rank() > 0, "nabla::ChunkStore: rank must be positive");
+
+    public:
+        using element_type = ElementType;
+        using value_type = ElementType;
+        using extents_type = Extents;
+        using index_type = typename Extents::index_type;
+        using size_type = typename Extents::size_type;
+        using rank_type = typename Extents::rank_type;
+        using coord_type = std::array<index_type, Extents::rank()>;
+
+        static constexpr rank_type rank() noexcept { return Extents::rank(); }
+
+    private:
+        std::filesystem::path _path;
+        extents_type _extents;
+        coord_type _chunk_shape;
+        chunk_codec _codec = chunk_codec::shuffle_lz;
+
+    //
+    // Constructors
+    //
+    public:
+        // Creates an empty store at `path`, replacing a store already there
+        ChunkStore(const std::filesystem::path& path, const extents_type& exts, const coord_type& chunk_shape,
+                   chunk_codec codec = chunk_codec::shuffle_lz)
+            : _path(path), _extents(exts), _chunk_shape(chunk_shape), _codec(codec) {
+                for (rank_type r = 0; r < rank(); ++r) {
+                    if (_chunk_shape[r] <= 0) {
+                        detail::throw_store_error(_path, "chunk shape must be positive");
+                    }
+                }
+                if (std::filesystem::exists(_path)) {
+                    if (!std::filesystem::exists(_path / detail::chunk_store_metadata) && !std::filesystem::is_empty(_path)) {
+                        detail::throw_store_error(_path, "exists and is not a chunk store");
+                    }
+                    std::filesystem::remove_all(_path);
+                }
+                std::filesystem::create_directories(_path);
+                _write_metadata();
+            }
+
+        // Opens the store at `path`
+        explicit ChunkStore(const std::filesystem::path& path)
+            : _path(path) {
+                _extents = _read_metadata();
+            }
+
+    //
+    // Observers
+    //
+    public:
+        const std::filesystem::path& path() const noexcept { return _path; }
+        constexpr const extents_type& extents() const noexcept { return _extents; }
+        constexpr index_type extent(rank_type r) const noexcept { return _extents.extent(r); }
+        constexpr const coord_type& chunk_shape() const noexcept { return _chunk_shape; }
+        constexpr chunk_codec codec() const noexcept { return _codec; }
+
+        // number of chunks along dimension r
+        constexpr std::size_t grid_extent(rank_type r) const noexcept {
+            return (static_cast<std::size_t>(extent(r)) + _chunk_shape[r] - 1) / _chunk_shape[r];
+        }
+
+    //
+    // Writing
+    //
+    public:
+        // Writes src to the region of the store at `origin` with src's extents
+        template <typename Policy, typename Src>
+            requires IsExecutionPolicy<Policy> && (IsTensorSpan<Src> || IsTensorArray<Src>) && (std::remove_cvref_t<Src>::rank() == Extents::rank())
+        void write(const Policy& policy, const Src& src, const coord_type& origin = {}) {
+            auto s = detail::as_span(src);
+            detail::store_region<rank()> region;
+            for (rank_type r = 0; r < rank(); ++r) {
+                region.begin[r] = static_cast<std::size_t>(origin[r]);
+                region.count[r] = static_cast<std::size_t>(s.extent(r));
+                region.step[r] = 1;
+            }
+            _check_region(region);
+            _for_each_chunk(policy, region, [&](const auto& chunk, const auto& lo, const auto& hi) {
+                std::unique_ptr<value_type[]> data(new value_type[_chunk_size()]);
+                if (_covers(region, chunk, lo, hi)) {
+                    // edge chunks reach past the extents, their padding is
+                    // stored as zeros so that chunk files are deterministic
+                    std::fill_n(data.get(), _chunk_size(), value_type{});
+                } else {
+                    _load_chunk(chunk, data.get());
+                }
+                _copy(region, chunk, lo, hi, [&](std::size_t chunk_offset, std::size_t m_offset) {
+                    data[chunk_offset] = s.accessor().access(s.data_handle(), m_offset);
+                }, s);
+                _store_chunk(chunk, data.get());
+            });
+        }
+
+        template <typename Src>
+            requires (IsTensorSpan<Src> || IsTensorArray<Src>) && (std::remove_cvref_t<Src>::rank() == Extents::rank())
+        void write(const Src& src, const coord_type& origin = {}) {
+            write(seq, src, origin);
+        }
+
+    //
+    // Reading
+    //
+    public:
+        // Reads the region of the store at `origin` with dst's extents into dst
+        template <typename Policy, typename Dst>
+            requires IsExecutionPolicy<Policy> && (IsTensorSpan<Dst> || IsTensorArray<Dst>) && (std::remove_cvref_t<Dst>::rank() == Extents::rank())
+        void read(const Policy& policy, Dst&& dst, const coord_type& origin = {}) const {
+            auto d = detail::as_span(dst);
+            detail::store_region<rank()> region;
+            for (rank_type r = 0; r < rank(); ++r) {
+                region.begin[r] = static_cast<std::size_t>(origin[r]);
+                region.count[r] = static_cast<std::size_t>(d.extent(r));
+                region.step[r] = 1;
+            }
+            _read_region(policy, region, d);
+        }
+
+        template <typename Dst>
+            requires (IsTensorSpan<Dst> || IsTensorArray<Dst>) && (std::remove_cvref_t<Dst>::rank() == Extents::rank())
+        void read(Dst&& dst, const coord_type& origin = {}) const {
+            read(seq, std::forward<Dst>(dst), origin);
+        }
+
+        // Reads the region selected by subspan-style slices, one per
+        // dimension, into a new TensorArray. Integral slices drop their
+        // dimension.
+        template <typename Policy, typename... Slices>
+            requires IsExecutionPolicy<Policy> && (sizeof...(Slices) == Extents::rank()) && (detail::IsStoreSlice<Slices> && ...)
+        auto read(const Policy& policy, Slices... slices) const {
+            constexpr std::size_t sub_rank = (std::size_t(detail::keeps_dimension<Slices>) + ... + 0);
+            using array_type = TensorArray<value_type, dextents<index_type, sub_rank>>;
+            detail::store_region<rank()> region;
+            [&]<std::size_t... R>(std::index_sequence<R...>) {
+                (detail::set_slice(region, R, static_cast<std::size_t>(extent(R)), slices), ...);
+            }(std::make_index_sequence<sizeof...(Slices)>{});
+            std::array<index_type, sub_rank> exts{};
+            for (rank_type q = 0, k = 0; q < rank(); ++q) {
+                if (!region.dropped[q]) {
+                    exts[k++] = static_cast<index_type>(region.count[q]);
+                }
+            }
+            const typename array_type::extents_type e(exts);
+            array_type a(e);
+            _read_region(policy, region, a.to_span());
+            return a;
+        }
+
+        template <typename... Slices>
+            requires (sizeof...(Slices) == Extents::rank()) && (detail::IsStoreSlice<Slices> && ...)
+        auto read(Slices... slices) const {
+            return read(seq, slices...);
+        }
+
+    private:
+        std::size_t _chunk_size() const noexcept {
+            std::size_t n = 1;
+            for (rank_type r = 0; r < rank(); ++r) {
+                n *= static_cast<std::size_t>(_chunk_shape[r]);
+            }
+            return n;
+        }
+
+        std::filesystem::path _chunk_path(const std::array<std::size_t, Extents::rank()>& chunk) const {
+            std::string name;
+            for (rank_type r = 0; r < rank(); ++r) {
+                name += (r == 0 ? "" : ".") + std::to_string(chunk[r]);
+            }
+            return _path / name;
+        }
+
+        void _check_region(const detail::store_region<Extents::rank()>& region) const {
+            for (rank_type r = 0; r < rank(); ++r) {
+                if (region.count[r] != 0 &&
+                    region.begin[r] + region.step[r] * (region.count[r] - 1) >= static_cast<std::size_t>(extent(r))) {
+                    std::stringstream ss;
+                    ss << "region along dimension " << r << " ends past the extent " << extent(r);
+                    detail::throw_store_error(_path, ss.str());
+                }
+            }
+        }
+
+        // Calls f(chunk, lo, hi) for every chunk that holds elements of the
+        // region, where [lo[r], hi[r]) are the region indices m in the chunk
+        template <typename Policy, typename F>
+        void _for_each_chunk(const Policy& policy, const detail::store_region<Extents::rank()>& region, F&& f) const {
+            using coord = std::array<std::size_t, Extents::rank()>;
+            coord first{};
+            coord num{};
+            std::size_t total = 1;
+            for (rank_type r = 0; r < rank(); ++r) {
+                if (region.count[r] == 0) {
+                    return;
+                }
+                const std::size_t c = static_cast<std::size_t>(_chunk_shape[r]);
+                first[r] = region.begin[r] / c;
+                num[r] = (region.begin[r] + region.step[r] * (region.count[r] - 1)) / c - first[r] + 1;
+                total *= num[r];
+            }
+            detail::for_each_chunk(policy, total, [&](std::size_t linear) {
+                coord chunk;
+                coord lo;
+                coord hi;
+                for (rank_type r = 0; r < rank(); ++r) {
+                    chunk[r] = first[r] + linear % num[r];
+                    linear /= num[r];
+                    const std::size_t c = static_cast<std::size_t>(_chunk_shape[r]);
+                    const std::size_t start = chunk[r] * c;
+                    const std::size_t b = region.begin[r];
+                    const std::size_t s = region.step[r];
+                    lo[r] = start <= b ? 0 : (start - b + s - 1) / s;
+                    hi[r] = std::min(region.count[r], (start + c - b + s - 1) / s);
+                    if (lo[r] >= hi[r]) {
+                        return; // strides that step over the chunk
+                    }
+                }
+                f(chunk, lo, hi);
+            });
+        }
+
+        // whether the region indices [lo, hi) cover every element of the chunk
+        bool _covers(const detail::store_region<Extents::rank()>& region, const std::array<std::size_t, Extents::rank()>& chunk,
+                     const std::array<std::size_t, Extents::rank()>& lo, const std::array<std::size_t, Extents::rank()>& hi) const {
+            for (rank_type r = 0; r < rank(); ++r) {
+                const std::size_t c = static_cast<std::size_t>(_chunk_shape[r]);
+                const std::size_t start = chunk[r] * c;
+                const std::size_t end = std::min(start + c, static_cast<std::size_t>(extent(r)));
+                if (region.step[r] != 1 || region.begin[r] + lo[r] != start || region.begin[r] + hi[r] != end) {
+                    return false;
+                }
+            }
+            return true;
+        }
+
+        // Calls f(chunk_offset, tensor_offset) for the region elements m in
+        // [lo, hi) of the chunk, where tensor_offset is the offset of m in t,
+        // whose dimensions are the region's kept dimensions
+        template <typename F, typename SpanT>
+        void _copy(const detail::store_region<Extents::rank()>& region, const std::array<std::size_t, Extents::rank()>& chunk,
+                   const std::array<std::size_t, Extents::rank()>& lo, const std::array<std::size_t, Extents::rank()>& hi,
+                   F&& f, const SpanT& t) const {
+            std::array<std::size_t, Extents::rank()> chunk_strides;
+            std::array<std::size_t, Extents::rank()> t_strides{};
+            std::size_t stride = 1;
+            for (rank_type r = 0, k = 0; r < rank(); ++r) {
+                chunk_strides[r] = stride;
+                stride *= static_cast<std::size_t>(_chunk_shape[r]);
+                if (!region.dropped[r]) {
+                    t_strides[r] = static_cast<std::size_t>(t.stride(k++));
+                }
+            }
+            // offsets of the element m = lo in the chunk and in t
+            std::size_t chunk_base = 0;
+            std::size_t t_base = 0;
+            for (rank_type r = 0; r < rank(); ++r) {
+                chunk_base += (region.begin[r] + region.step[r] * lo[r] - chunk[r] * static_cast<std::size_t>(_chunk_shape[r])) * chunk_strides[r];
+                t_base += lo[r] * t_strides[r];
+            }
+            const std::size_t n0 = hi[0] - lo[0];
+            const std::size_t chunk_step0 = region.step[0] * chunk_strides[0];
+            std::array<std::size_t, Extents::rank()> m = lo;
+            while (true) {
+                std::size_t chunk_offset = chunk_base;
+                std::size_t t_offset = t_base;
+                for (rank_type r = 1; r < rank(); ++r) {
+                    chunk_offset += region.step[r] * (m[r] - lo[r]) * chunk_strides[r];
+                    t_offset += (m[r] - lo[r]) * t_strides[r];
+                }
+                for (std::size_t i = 0; i < n0; ++i) {
+                    f(chunk_offset + i * chunk_step0, t_offset + i * t_strides[0]);
+                }
+                rank_type r = 1;
+                for (; r < rank() && ++m[r] == hi[r]; ++r) {
+                    m[r] = lo[r];
+                }
+                if (r == rank()) {
+                    return;
+                }
+            }
+        }
+
+        template <typename Policy, typename SpanT>
+        void _read_region(const Policy& policy, const detail::store_region<Extents::rank()>& region, const SpanT& t) const {
+            _check_region(region);
+            _for_each_chunk(policy, region, [&](const auto& chunk, const auto& lo, const auto& hi) {
+                std::unique_ptr<value_type[]> data(new value_type[_chunk_size()]);
+                _load_chunk(chunk, data.get());
+                _copy(region, chunk, lo, hi, [&](std::size_t chunk_offset, std::size_t t_offset) {
+                    t.accessor().access(t.data_handle(), t_offset) = data[chunk_offset];
+                }, t);
+            });
+        }
+
+        //
+        // Chunk files: codec (1 byte), padding (7 bytes), checksum of the
+        // decoded bytes (8 bytes), encoded bytes
+        //
+
+        static constexpr std::size_t _chunk_header_size = 16;
+
+        void _load_chunk(const std::array<std::size_t, Extents::rank()>& chunk, value_type* data) const {
+            const std::filesystem::path path = _chunk_path(chunk);
+            std::error_code ec;
+            const std::size_t size = static_cast<std::size_t>(std::filesystem::file_size(path, ec));
+            if (ec) {
+                std::fill_n(data, _chunk_size(), value_type{});
+                return;
+            }
+            if (size < _chunk_header_size) {
+                detail::throw_store_error(path, "truncated chunk");
+            }
+            default_init_vector<std::uint8_t> bytes(size);
+            detail::binary_file(path, detail::file_mode::read).read_at(bytes.data(), size, 0);
+            std::uint64_t checksum;
+            std::memcpy(&checksum, bytes.data() + 8, sizeof(checksum));
+            detail::decode_chunk(bytes.data() + _chunk_header_size, size - _chunk_header_size,
+                                 static_cast<chunk_codec>(bytes[0]), data, _chunk_size(), sizeof(value_type));
+            if (detail::checksum64(reinterpret_cast<const std::byte*>(data), _chunk_size() * sizeof(value_type)) != checksum) {
+                detail::throw_store_error(path, "checksum mismatch");
+            }
+        }
+
+        // written to a temporary file renamed over the chunk, so that readers
+        // never see a partial chunk
+        void _store_chunk(const std::array<std::size_t, Extents::rank()>& chunk, const value_type* data) const {
+            std::vector<std::uint8_t> encoded;
+            const chunk_codec used = detail::encode_chunk(data, _chunk_size(), sizeof(value_type), _codec, encoded);
+            std::uint8_t header[_chunk_header_size] = {};
+            header[0] = static_cast<std::uint8_t>(used);
+            const std::uint64_t checksum = detail::checksum64(reinterpret_cast<const std::byte*>(data), _chunk_size() * sizeof(value_type));
+            std::memcpy(header + 8, &checksum, sizeof(checksum));
+            const std::filesystem::path path = _chunk_path(chunk);
+            std::filesystem::path tmp = path;
+            tmp += ".tmp";
+            {
+                detail::binary_file file(tmp, detail::file_mode::write);
+                file.write_at(header, sizeof(header), 0);
+                file.write_at(encoded.data(), encoded.size(), sizeof(header));
+            }
+            std::filesystem::rename(tmp, path);
+        }
+
+        //
+        // Metadata: a text file of "key values..." lines
+        //
+
+        void _write_metadata() const {
+            std::ofstream out(_path / detail::chunk_store_metadata);
+            out << "nabla_chunk_store " << detail::chunk_store_version << "\n";
+            out << "dtype " << detail::npy_descr<value_type>() << "\n";
+            out << "shape";
+            for (rank_type r = 0; r < rank(); ++r) {
+                out << " " << extent(r);
+            }
+            out << "\nchunks";
+            for (rank_type r = 0; r < rank(); ++r) {
+                out << " " << _chunk_shape[r];
+            }
+            out << "\ncodec " << static_cast<unsigned>(_codec) << "\n";
+            if (!out) {
+                detail::throw_store_error(_path, "cannot write metadata");
+            }
+        }
+
+        extents_type _read_metadata() {
+            std::ifstream in(_path / detail::chunk_store_metadata);
+            if (!in) {
+                detail::throw_store_error(_path, "not a chunk store");
+            }
+            std::string key;
+            std::uint32_t version = 0;
+            std::string dtype;
+            coord_type shape{};
+            unsigned codec = 0;
+            in >> key >> version;
+            if (key != "nabla_chunk_store" || version != detail::chunk_store_version) {
+                detail::throw_store_error(_path, "unsupported store version");
+            }
+            in >> key >> dtype;
+            if (key != "dtype" || !detail::npy_descr_matches<value_type>(dtype)) {
+                detail::throw_store_error(_path, "dtype '" + dtype + "' does not match the element type");
+            }
+            in >> key;
+            for (rank_type r = 0; r < rank(); ++r) {
+                in >> shape[r];
+            }
+            if (key != "shape" || !in) {
+                detail::throw_store_error(_path, "shape does not match the rank");
+            }
+            in >> key;
+            for (rank_type r = 0; r < rank(); ++r) {
+                in >> _chunk_shape[r];
+            }
+            if (key != "chunks" || !in) {
+                detail::throw_store_error(_path, "chunk shape does not match the rank");
+            }
+            in >> key >> codec;
+            if (key != "codec" || !in) {
+                detail::throw_store_error(_path, "malformed codec");
+            }
+            _codec = static_cast<chunk_codec>(codec);
+            for (rank_type r = 0; r < rank(); ++r) {
+                if (_chunk_shape[r] <= 0 ||
+                    (Extents::static_extent(r) != std::dynamic_extent && Extents::static_extent(r) != static_cast<std::size_t>(shape[r]))) {
+                    detail::throw_store_error(_path, "shape or chunk shape does not match the store type");
+                }
+            }
+            return extents_type(shape);
+        }
+};
+
+} // namespace nabla
+
+#endif // NABLA_CHUNK_STORE_HPP
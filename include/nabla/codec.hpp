@@ -0,0 +1,288 @@
+#ifndef NABLA_CODEC_HPP
+#define NABLA_CODEC_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <sstream>
+#include <stacktrace>
+#include <stdexcept>
+#include <string>
+#include <vector>
+#include "nabla/default_init_allocator.hpp"
+
+// Lightweight lossless codec for tensor chunks, with no external libraries.
+// A byte shuffle first groups byte k of every element together, so that the
+// slowly varying sign, exponent and high mantissa bytes of floating point
+// data form long runs. An optional delta filter then turns smooth planes
+// into runs of small differences. Last, an LZ77 block compressor in the
+// LZ4 sequence format removes the repetition: a token holding the literal
+// and match lengths, the literals, and a 16-bit backward match offset.
+
+namespace nabla {
+
+enum class chunk_codec : std::uint8_t {
+    none = 0,
+    shuffle_lz = 1,       // byte shuffle, LZ
+    shuffle_delta_lz = 2, // byte shuffle, bytewise delta, LZ; for smooth data
+};
+
+namespace detail {
+
+    [[noreturn]] inline void throw_codec_error(const std::string& what) {
+        std::stringstream ss;
+        ss << "nabla codec error: " << what
+            << "\n\n"
+            << std::stacktrace::current() << std::endl;
+        throw std::invalid_argument(ss.str());
+    }
+
+    //
+    // Filters
+    //
+
+    // elements per block of the shuffles, whose bytes stay in L1 while each
+    // of their planes is visited
+    inline constexpr std::size_t shuffle_block = 1024;
+
+    // out[b*n + i] = in[i*width + b] for n elements of `width` bytes
+    inline void byte_shuffle(const std::uint8_t* in, std::uint8_t* out, std::size_t n, std::size_t width) noexcept {
+        for (std::size_t i0 = 0; i0 < n; i0 += shuffle_block) {
+            const std::size_t i1 = std::min(i0 + shuffle_block, n);
+            for (std::size_t b = 0; b < width; ++b) {
+                std::uint8_t* plane = out + b * n;
+                for (std::size_t i = i0; i < i1; ++i) {
+                    plane[i] = in[i * width + b];
+                }
+            }
+        }
+    }
+
+    inline void byte_unshuffle(const std::uint8_t* in, std::uint8_t* out, std::size_t n, std::size_t width) noexcept {
+        for (std::size_t i0 = 0; i0 < n; i0 += shuffle_block) {
+            const std::size_t i1 = std::min(i0 + shuffle_block, n);
+            for (std::size_t b = 0; b < width; ++b) {
+                const std::uint8_t* plane = in + b * n;
+                for (std::size_t i = i0; i < i1; ++i) {
+                    out[i * width + b] = plane[i];
+                }
+            }
+        }
+    }
+
+    // differences of consecutive bytes within each plane of n bytes
+    inline void delta_encode(std::uint8_t* data, std::size_t n, std::size_t planes) noexcept {
+        for (std::size_t b = 0; b < planes; ++b) {
+            std::uint8_t* plane = data + b * n;
+            for (std::size_t i = n; i-- > 1;) {
+                plane[i] = static_cast<std::uint8_t>(plane[i] - plane[i - 1]);
+            }
+        }
+    }
+
+    inline void delta_decode(std::uint8_t* data, std::size_t n, std::size_t planes) noexcept {
+        for (std::size_t b = 0; b < planes; ++b) {
+            std::uint8_t* plane = data + b * n;
+            for (std::size_t i = 1; i < n; ++i) {
+                plane[i] = static_cast<std::uint8_t>(plane[i] + plane[i - 1]);
+            }
+        }
+    }
+
+    //
+    // LZ block
+    //
+
+    inline constexpr std::size_t lz_min_match = 4;
+    inline constexpr std::size_t lz_max_offset = 65535;
+    inline constexpr unsigned lz_hash_bits = 14;
+
+    inline std::uint32_t lz_load32(const std::uint8_t* p) noexcept {
+        std::uint32_t v;
+        std::memcpy(&v, p, sizeof(v));
+        return v;
+    }
+
+    inline void lz_put_length(std::vector<std::uint8_t>& out, std::size_t n) {
+        for (; n >= 255; n -= 255) {
+            out.push_back(255);
+        }
+        out.push_back(static_cast<std::uint8_t>(n));
+    }
+
+    inline void lz_put_sequence(std::vector<std::uint8_t>& out, const std::uint8_t* literals, std::size_t num_literals,
+                                std::size_t offset, std::size_t match) {
+        const std::size_t lit_code = num_literals < 15 ? num_literals : 15;
+        const std::size_t match_code = match == 0 ? 0 : (match - lz_min_match < 15 ? match - lz_min_match : 15);
+        out.push_back(static_cast<std::uint8_t>(lit_code << 4 | match_code));
+        if (lit_code == 15) {
+            lz_put_length(out, num_literals - 15);
+        }
+        out.insert(out.end(), literals, literals + num_literals);
+        if (match != 0) {
+            out.push_back(static_cast<std::uint8_t>(offset & 0xff));
+            out.push_back(static_cast<std::uint8_t>(offset >> 8));
+            if (match_code == 15) {
+                lz_put_length(out, match - lz_min_match - 15);
+            }
+        }
+    }
+
+    // Appends the compressed form of in[0, n) to out. Greedy matching against
+    // the last position of each hashed 4-byte sequence; the search skips
+    // ahead faster the longer it goes without a match, so incompressible
+    // data passes through quickly.
+    inline void lz_compress(const std::uint8_t* in, std::size_t n, std::vector<std::uint8_t>& out) {
+        std::vector<std::uint32_t> table(std::size_t(1) << lz_hash_bits, 0); // positions + 1, 0 for none
+        std::size_t anchor = 0;
+        std::size_t i = 0;
+        std::size_t misses = 0;
+        // the last bytes are always literals
+        const std::size_t match_limit = n > 8 ? n - 8 : 0;
+        while (i < match_limit) {
+            const std::uint32_t seq = lz_load32(in + i);
+            const std::uint32_t h = (seq * 2654435761u) >> (32 - lz_hash_bits);
+            const std::size_t candidate = table[h];
+            table[h] = static_cast<std::uint32_t>(i + 1);
+            if (candidate == 0 || i + 1 - candidate > lz_max_offset || lz_load32(in + candidate - 1) != seq) {
+                i += 1 + (misses++ >> 6);
+                continue;
+            }
+            misses = 0;
+            const std::size_t ref = candidate - 1;
+            std::size_t match = lz_min_match;
+            while (i + match < n && in[ref + match] == in[i + match]) {
+                ++match;
+            }
+            lz_put_sequence(out, in + anchor, i - anchor, i - ref, match);
+            i += match;
+            anchor = i;
+        }
+        lz_put_sequence(out, in + anchor, n - anchor, 0, 0);
+    }
+
+    inline std::size_t lz_get_length(const std::uint8_t*& ip, const std::uint8_t* end) {
+        std::size_t n = 0;
+        std::uint8_t b;
+        do {
+            if (ip == end) {
+                throw_codec_error("truncated length");
+            }
+            b = *ip++;
+            n += b;
+        } while (b == 255);
+        return n;
+    }
+
+    // Decompresses in[0, n) into exactly out_size bytes at out
+    inline void lz_decompress(const std::uint8_t* in, std::size_t n, std::uint8_t* out, std::size_t out_size) {
+        const std::uint8_t* ip = in;
+        const std::uint8_t* const end = in + n;
+        std::size_t op = 0;
+        while (ip < end) {
+            const std::uint8_t token = *ip++;
+            std::size_t num_literals = token >> 4;
+            if (num_literals == 15) {
+                num_literals += lz_get_length(ip, end);
+            }
+            if (num_literals > static_cast<std::size_t>(end - ip) || num_literals > out_size - op) {
+                throw_codec_error("literals overrun");
+            }
+            std::memcpy(out + op, ip, num_literals);
+            ip += num_literals;
+            op += num_literals;
+            if (ip == end) {
+                break;
+            }
+            if (end - ip < 2) {
+                throw_codec_error("truncated match offset");
+            }
+            const std::size_t offset = ip[0] | std::size_t(ip[1]) << 8;
+            ip += 2;
+            std::size_t match = (token & 15) + lz_min_match;
+            if ((token & 15) == 15) {
+                match += lz_get_length(ip, end);
+            }
+            if (offset == 0 || offset > op || match > out_size - op) {
+                throw_codec_error("match out of range");
+            }
+            const std::uint8_t* src = out + op - offset;
+            if (offset >= match) {
+                std::memcpy(out + op, src, match);
+            } else {
+                // byte by byte, as the match repeats its own output
+                for (std::size_t k = 0; k < match; ++k) {
+                    out[op + k] = src[k];
+                }
+            }
+            op += match;
+        }
+        if (op != out_size) {
+            throw_codec_error("decompressed size mismatch");
+        }
+    }
+
+    //
+    // Chunk encoding
+    //
+
+    // Encodes n elements of `width` bytes with `codec`. Returns the codec
+    // actually used, none when compression does not pay off.
+    inline chunk_codec encode_chunk(const void* data, std::size_t n, std::size_t width, chunk_codec codec,
+                                    std::vector<std::uint8_t>& out) {
+        const auto* bytes = static_cast<const std::uint8_t*>(data);
+        const std::size_t size = n * width;
+        out.clear();
+        if (codec != chunk_codec::none) {
+            default_init_vector<std::uint8_t> shuffled(size);
+            byte_shuffle(bytes, shuffled.data(), n, width);
+            if (codec == chunk_codec::shuffle_delta_lz) {
+                delta_encode(shuffled.data(), n, width);
+            }
+            lz_compress(shuffled.data(), size, out);
+            if (out.size() < size) {
+                return codec;
+            }
+            out.clear();
+        }
+        out.assign(bytes, bytes + size);
+        return chunk_codec::none;
+    }
+
+    inline void decode_chunk(const std::uint8_t* in, std::size_t in_size, chunk_codec codec,
+                             void* data, std::size_t n, std::size_t width) {
+        auto* bytes = static_cast<std::uint8_t*>(data);
+        const std::size_t size = n * width;
+        if (size == 0) {
+            // empty chunks are always stored raw, and their pointers may be null
+            if (codec != chunk_codec::none || in_size != 0) {
+                throw_codec_error("empty chunk with encoded bytes");
+            }
+            return;
+        }
+        switch (codec) {
+            case chunk_codec::none:
+                if (in_size != size) {
+                    throw_codec_error("raw chunk size mismatch");
+                }
+                std::memcpy(bytes, in, size);
+                return;
+            case chunk_codec::shuffle_lz:
+            case chunk_codec::shuffle_delta_lz: {
+                default_init_vector<std::uint8_t> shuffled(size);
+                lz_decompress(in, in_size, shuffled.data(), size);
+                if (codec == chunk_codec::shuffle_delta_lz) {
+                    delta_decode(shuffled.data(), n, width);
+                }
+                byte_unshuffle(shuffled.data(), bytes, n, width);
+                return;
+            }
+        }
+        throw_codec_error("unknown codec " + std::to_string(static_cast<unsigned>(codec)));
+    }
+
+} // namespace detail
+} // namespace nabla
+
+#endif // NABLA_CODEC_HPP
@@ -0,0 +1,67 @@
+#ifndef NABLA_CONJ_ACCESSOR_HPP
+#define NABLA_CONJ_ACCESSOR_HPP
+
+#include <cstddef>
+#include <type_traits>
+#include "nabla/utility/complex.hpp"
+
+namespace nabla {
+
+// Read-only accessor that yields the complex conjugate of the elements read
+// through BaseAccessor. Elements are conjugated on access, by value, so a
+// conjugated view never copies its data.
+template <typename BaseAccessor>
+class conj_accessor {
+    public:
+        using base_accessor_type = BaseAccessor;
+        using element_type = std::remove_const_t<typename base_accessor_type::element_type>;
+        using reference = element_type;
+        using data_handle_type = typename base_accessor_type::data_handle_type;
+        using offset_policy = conj_accessor<typename base_accessor_type::offset_policy>;
+        using read_accessor_type = conj_accessor;
+        using write_accessor_type = conj_accessor;
+
+    private:
+        base_accessor_type _base;
+
+    public:
+        constexpr conj_accessor() noexcept = default;
+
+        constexpr explicit conj_accessor(const base_accessor_type& base) noexcept
+            : _base(base) {}
+
+        template <typename OtherAccessor>
+            requires std::is_constructible_v<base_accessor_type, const OtherAccessor&>
+        constexpr conj_accessor(const conj_accessor<OtherAccessor>& other) noexcept
+            : _base(other.base()) {}
+
+        constexpr reference access(data_handle_type p, std::size_t i) const {
+            return utility::conj(static_cast<element_type>(_base.access(p, i)));
+        }
+
+        constexpr data_handle_type offset(data_handle_type p, std::size_t i) const {
+            return _base.offset(p, i);
+        }
+
+        constexpr const base_accessor_type& base() const noexcept {
+            return _base;
+        }
+
+        write_accessor_type to_write() const noexcept {
+            return *this;
+        }
+};
+
+namespace detail {
+
+    template <typename T>
+    inline constexpr bool is_conj_accessor = false;
+
+    template <typename BaseAccessor>
+    inline constexpr bool is_conj_accessor<conj_accessor<BaseAccessor>> = true;
+
+} // namespace detail
+
+} // namespace nabla
+
+#endif // NABLA_CONJ_ACCESSOR_HPP
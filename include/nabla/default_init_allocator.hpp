@@ -0,0 +1,84 @@
+#ifndef NABLA_DEFAULT_INIT_ALLOCATOR_HPP
+#define NABLA_DEFAULT_INIT_ALLOCATOR_HPP
+
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <utility>
+#include "nabla/types.hpp"
+#include "nabla/aligned_allocator.hpp"
+
+// Allocator adaptor whose value construction is default-initialization, so
+// that std::vector<T, default_init_allocator<T>>(n) leaves trivial elements
+// unwritten. It is the opt-in for TensorArrays that are written once: over
+// default_init_vector<T>, an array made from extents or a mapping, or
+// materialized from an expression, span or array, is not zeroed before the
+// assignment fills it. The default std::vector<T> container zeroes it.
+// Other allocators keep their behaviour and compose with it, e.g.
+//
+//     std::vector<float, nb::default_init_allocator<float, nb::aligned_allocator<float>>>
+//
+// Construction with arguments is forwarded to the adapted allocator.
+
+namespace nabla {
+
+template <typename T, typename Allocator>
+class default_init_allocator : public Allocator {
+    using traits = std::allocator_traits<Allocator>;
+
+    public:
+        using allocator_type = Allocator;
+
+        template <typename U>
+        struct rebind {
+            using other = default_init_allocator<U, typename traits::template rebind_alloc<U>>;
+        };
+
+        using Allocator::Allocator;
+
+        constexpr default_init_allocator() noexcept(std::is_nothrow_default_constructible_v<Allocator>) = default;
+
+        template <typename U, typename OtherAllocator>
+        constexpr default_init_allocator(const default_init_allocator<U, OtherAllocator>& other) noexcept
+            : Allocator(static_cast<const OtherAllocator&>(other)) {}
+
+        template <typename U>
+        void construct(U* p) noexcept(std::is_nothrow_default_constructible_v<U>) {
+            ::new (static_cast<void*>(p)) U;
+        }
+
+        template <typename U, typename... Args>
+        void construct(U* p, Args&&... args) {
+            traits::construct(static_cast<Allocator&>(*this), p, std::forward<Args>(args)...);
+        }
+
+        default_init_allocator select_on_container_copy_construction() const {
+            return default_init_allocator(traits::select_on_container_copy_construction(static_cast<const Allocator&>(*this)));
+        }
+
+        template <typename U, typename OtherAllocator>
+        friend constexpr bool operator==(const default_init_allocator& a, const default_init_allocator<U, OtherAllocator>& b) noexcept {
+            return static_cast<const Allocator&>(a) == static_cast<const OtherAllocator&>(b);
+        }
+
+    private:
+        constexpr explicit default_init_allocator(const Allocator& allocator) noexcept
+            : Allocator(allocator) {}
+
+        template <typename, typename>
+        friend class default_init_allocator;
+};
+
+template <typename T, typename Allocator = std::allocator<T>>
+using default_init_vector = std::vector<T, default_init_allocator<T, Allocator>>;
+
+namespace detail {
+
+    template <typename T, typename Allocator>
+    struct allocator_alignment<default_init_allocator<T, Allocator>> : allocator_alignment<Allocator> {};
+
+} // namespace detail
+
+} // namespace nabla
+
+#endif // NABLA_DEFAULT_INIT_ALLOCATOR_HPP
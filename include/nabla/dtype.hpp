@@ -0,0 +1,55 @@
+#ifndef NABLA_DTYPE_HPP
+#define NABLA_DTYPE_HPP
+
+#include <bit>
+#include <cstddef>
+#include <string>
+#include <type_traits>
+#include "nabla/utility/complex.hpp"
+
+// Element type descriptors in numpy's notation: byte order, kind and size,
+// e.g. '<f8' for a little-endian double. Shared by the .npy and native
+// tensor file formats.
+
+namespace nabla {
+namespace detail {
+
+    // numpy's kind character for T
+    template <typename T>
+    constexpr char npy_kind() noexcept {
+        if constexpr (std::is_same_v<T, bool>) {
+            return 'b';
+        } else if constexpr (utility::IsComplexFP<T>) {
+            return 'c';
+        } else if constexpr (std::is_floating_point_v<T>) {
+            return 'f';
+        } else if constexpr (std::is_signed_v<T>) {
+            return 'i';
+        } else {
+            return 'u';
+        }
+    }
+
+    // the native descr of T
+    template <typename T>
+    std::string npy_descr() {
+        const char order = sizeof(T) == 1 ? '|' : std::endian::native == std::endian::little ? '<' : '>';
+        return std::string{order, npy_kind<T>()} + std::to_string(sizeof(T));
+    }
+
+    // whether the npy descr, e.g. '<f8', is the native representation of T
+    template <typename T>
+    bool npy_descr_matches(const std::string& descr) {
+        if (descr.size() < 3) {
+            return false;
+        }
+        const char order = descr[0];
+        const char native = std::endian::native == std::endian::little ? '<' : '>';
+        const bool order_ok = order == '=' || order == native || (order == '|' && sizeof(T) == 1);
+        return order_ok && descr[1] == npy_kind<T>() && descr.substr(2) == std::to_string(sizeof(T));
+    }
+
+} // namespace detail
+} // namespace nabla
+
+#endif // NABLA_DTYPE_HPP
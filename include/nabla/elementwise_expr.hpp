@@ -5,40 +5,76 @@
 #include <utility> // for std::index_sequence
 #include <tuple>
 #include "nabla/concepts.hpp"
+#include "nabla/expr_node.hpp"
+#include "nabla/expr_ops.hpp"
 #include "nabla/elementwise_expr_iterator.hpp"
+#include "nabla/broadcast.hpp"
 
 // TODO: enforce invariants e.g. rank, dimensions, fp type
 
-// optimization to consider: dimensions are a runtime invariant and duplicated
-// unnecessarily in each node. we can drop them from the nodes and only
-// propagate one through the expression dag.
-
 namespace nabla {
 
 template <typename Op, typename... Inputs>
     requires (IsSpanOrExpr<Inputs> && ...)
 class ExprOp;
 
-// base case: collect_leaf_ptrs for a leaf nodes
-template <typename T>
-    requires IsTensorSpan<T>
-auto collect_leaf_ptrs(T& leaf) {
-    return std::tuple<T*>{&leaf};
-}
+namespace detail {
 
-template <typename Op, typename... Inputs>
-auto collect_leaf_ptrs(ExprOp<Op, Inputs...>& expr) {
-    return [&]<std::size_t... Is>(std::index_sequence<Is...>) {
-        return std::tuple_cat(collect_leaf_ptrs(std::get<Is>(expr._inputs))...);
-    }(std::index_sequence_for<Inputs...>{});
-}
+    // node type storing an input of an expression, see expr_node.hpp
+    template <typename T>
+    struct expr_node {
+        using type = ExprLeaf<T>;
+    };
+
+    template <typename Op, typename... Inputs>
+    struct expr_node<ExprOp<Op, Inputs...>> {
+        using type = ExprNode<Op, typename expr_node<Inputs>::type...>;
+    };
+
+    template <typename T>
+    using expr_node_t = typename expr_node<std::remove_cvref_t<T>>::type;
+
+    template <typename T>
+    expr_node_t<T> to_node(T&& input) {
+        if constexpr (IsTensorExpr<T>) {
+            return std::forward<T>(input).node();
+        } else {
+            return expr_node_t<T>(input);
+        }
+    }
+
+    // the input of type T stored as `node`, rebuilt with the extents of the
+    // expression
+    template <typename T, typename Node, typename Extents>
+    T from_node(const Node& node, const Extents& exts) {
+        if constexpr (IsTensorExpr<T>) {
+            return T(node, typename T::extents_type(exts));
+        } else {
+            return node.span(exts);
+        }
+    }
+
+    template <typename T>
+    auto collect_leaves(const T& input) {
+        if constexpr (IsTensorExpr<T>) {
+            return input.inputs();
+        } else {
+            return std::tuple<T>{input};
+        }
+    }
+
+    template <typename First, typename... Rest>
+    constexpr const First& first_of(const First& first, const Rest&...) noexcept {
+        return first;
+    }
 
-// N-ary expression template
+} // namespace detail
+
+// N-ary expression template. The tree is stored compactly (see
+// expr_node.hpp) with the extents held once, here at the root.
 template <typename Op, typename... Inputs>
     requires (IsSpanOrExpr<Inputs> && ...)
 class ExprOp : public ExprTag {
-    Op _op;
-    std::tuple<Inputs...> _inputs;
     using input1_t = std::tuple_element_t<0, std::tuple<Inputs...>>;
 
     public:
@@ -48,12 +84,19 @@ class ExprOp : public ExprTag {
         //
         using operation_type = Op;
         using inputs_type = std::tuple<Inputs...>;
+        using node_type = detail::ExprNode<Op, detail::expr_node_t<Inputs>...>;
         using extents_type = typename input1_t::extents_type;
         using index_type = typename input1_t::index_type;
         using coord_type = typename input1_t::coord_type;
         using rank_type = typename input1_t::rank_type;
         using value_type = typename input1_t::value_type;
 
+    private:
+        [[no_unique_address]] extents_type _extents;
+        node_type _node;
+
+    public:
+
         //
         // Member functions
         //
@@ -63,60 +106,58 @@ class ExprOp : public ExprTag {
         //
         static constexpr input1_t::rank_type rank() noexcept { return input1_t::rank(); }
 
-        constexpr index_type extent(rank_type r) const noexcept { return std::get<0>(_inputs).extent(r); }
-        constexpr extents_type extents() const noexcept { return std::get<0>(_inputs).extents(); }
-        constexpr index_type size() const noexcept { return std::get<0>(_inputs).size(); }
+        constexpr index_type extent(rank_type r) const noexcept { return _extents.extent(r); }
+        constexpr const extents_type& extents() const noexcept { return _extents; }
+        constexpr index_type size() const noexcept {
+            index_type n = 1;
+            for (rank_type r = 0; r < rank(); ++r) {
+                n *= _extents.extent(r);
+            }
+            return n;
+        }
 
         //
         // Constructors
         //
 
          ExprOp(const Op& op, const Inputs&... inputs)
-            : _op(op), _inputs(inputs...) {}
+            : _extents(detail::first_of(inputs...).extents()), _node(op, detail::to_node(inputs)...) {}
 
          ExprOp(Op&& op, Inputs&&... inputs)
-            : _op(std::move(op)), _inputs(std::move(inputs)...) {}
+            : _extents(detail::first_of(inputs...).extents()), _node(std::move(op), detail::to_node(std::move(inputs))...) {}
+
+         // a subtree given the extents of the expression
+         ExprOp(const node_type& node, const extents_type& exts)
+            : _extents(exts), _node(node) {}
 
         template <typename... Args> requires (sizeof...(Args) == rank()) &&
             (std::conjunction_v<std::is_convertible<Args, index_type>...>)
         auto operator()(Args... args) const {
-            return std::apply(
-                [&](auto const&... ins) {
-                    return _op(ins(args...)...);
-                }, _inputs);
+            return _node.at(coord_type{static_cast<index_type>(args)...});
         }
 
-        template <typename Op_, typename... Inputs_>
-        friend auto collect_leaf_ptrs(ExprOp<Op_, Inputs_...>& expr);
+        const operation_type& operation() const noexcept { return _node.operation(); }
+        const node_type& node() const& noexcept { return _node; }
+        node_type&& node() && noexcept { return std::move(_node); }
 
-        auto inputs() {
-            return collect_leaf_ptrs(*this);
+        // the inputs, rebuilt from the stored nodes
+        inputs_type operands() const {
+            return [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+                return inputs_type(detail::from_node<Inputs>(std::get<Is>(_node.inputs()), _extents)...);
+            }(std::index_sequence_for<Inputs...>{});
+        }
+
+        // the leaf spans of the expression, left to right
+        auto inputs() const {
+            return std::apply([](const auto&... ins) { return std::tuple_cat(detail::collect_leaves(ins)...); }, operands());
         }
 
         auto begin() const {
-            return std::apply(
-                [&](const auto&... inputs) {
-                    return ExprIterator<operation_type, decltype(inputs.begin())...>{
-                        _op, inputs.begin()...
-                    };
-                },
-                _inputs
-            );
+            return ExprIterator<ExprOp, detail::is_right_ordered<ExprOp>>(this);
         }
 
         auto end() const {
-            // only first iterator is instantiated to end(), the rest are default-constructed
-            // operator== and operator!= only compare the first iterator
-            return std::apply(
-                [&](const auto& first_input, const auto&... rest_inputs) {
-                    return ExprIterator<operation_type, decltype(first_input.end()), decltype(rest_inputs.begin())...>{
-                        _op,
-                            first_input.end(),
-                            decltype(rest_inputs.begin()){}... // default-constructed
-                    };
-                },
-                _inputs
-            );
+            return ExprIterator<ExprOp, detail::is_right_ordered<ExprOp>>(this, static_cast<std::ptrdiff_t>(size()));
         }
 };
 
@@ -131,49 +172,181 @@ decltype(auto) span_or_forward(T&& input) {
     }
 }
 
-//helper to decay input types (e.g. const T& -> T)
+// broadcasts an expression by broadcasting its leaves
+template <typename T, typename IndexType>
+    requires IsTensorExpr<T>
+auto broadcast_to(const T& expr, const std::array<IndexType, std::remove_cvref_t<T>::rank()>& exts) {
+    return std::apply(
+        [&](const auto&... inputs) {
+            return ExprOp<typename T::operation_type, decltype(broadcast_to(inputs, exts))...>{
+                expr.operation(), broadcast_to(inputs, exts)...
+            };
+        },
+        expr.operands());
+}
+
+//helper to decay input types (e.g. const T& -> T). Inputs of different
+//shapes are broadcast to their common extents, see broadcast.hpp. Unless
+//the shapes are equal by type and the inputs iterate in the same order,
+//every input becomes a broadcast view so that the expression's type does not
+//depend on runtime extents.
 template <typename Op, typename... Inputs>
 auto make_expr_op(Op&& op, Inputs&&... inputs) {
-    return ExprOp<std::decay_t<Op>, std::decay_t<decltype(span_or_forward(std::forward<Inputs>(inputs)))>...>{
-        std::forward<Op>(op), span_or_forward(std::forward<Inputs>(inputs))...
-    };
+    if constexpr (detail::is_statically_aligned<Inputs...>) {
+        return ExprOp<std::decay_t<Op>, std::decay_t<decltype(span_or_forward(std::forward<Inputs>(inputs)))>...>{
+            std::forward<Op>(op), span_or_forward(std::forward<Inputs>(inputs))...
+        };
+    } else {
+        const auto exts = detail::broadcast_extents(inputs...);
+        return ExprOp<std::decay_t<Op>, decltype(broadcast_to(span_or_forward(std::forward<Inputs>(inputs)), exts))...>{
+            std::forward<Op>(op), broadcast_to(span_or_forward(std::forward<Inputs>(inputs)), exts)...
+        };
+    }
 }
 
-// Operator overloads: Arithmetic operations (+ - * / % -)
+namespace detail {
+
+    template <typename T, template <typename> typename Tmpl>
+    inline constexpr bool is_instance_of = false;
+
+    template <typename U, template <typename> typename Tmpl>
+    inline constexpr bool is_instance_of<Tmpl<U>, Tmpl> = true;
+
+    template <typename T>
+    struct expr_operation {
+        using type = void;
+    };
+
+    template <typename T>
+        requires IsTensorExpr<T>
+    struct expr_operation<T> {
+        using type = typename T::operation_type;
+    };
+
+    // operation at the root of T, void for a span or an array
+    template <typename T>
+    using expr_operation_t = typename expr_operation<std::remove_cvref_t<T>>::type;
+
+    template <typename T, typename Op>
+    inline constexpr bool is_expr_of = std::is_same_v<expr_operation_t<T>, Op>;
+
+    template <typename T, template <typename> typename ScalarOp>
+    inline constexpr bool is_scalar_expr_of = is_instance_of<expr_operation_t<T>, ScalarOp>;
+
+    template <std::size_t I, typename T>
+    auto operand(const T& expr) {
+        return std::get<I>(expr.operands());
+    }
+
+    template <typename T>
+    using value_t = typename std::remove_cvref_t<T>::value_type;
+
+} // namespace detail
+
+// Operator overloads: Arithmetic operations (+ - * / % -). Before a node is
+// built its operands are matched against a few rewrites: a product feeding
+// a sum or difference becomes a fused multiply-add, a scalar operation on a
+// scalar operation becomes one, and negations cancel or are absorbed. See
+// expr_ops.hpp for when each applies.
 template <typename In1, typename In2>
     requires (IsTensorLike<In1> && IsTensorLike<In2>)
 auto operator+(In1&& input1, In2&& input2) {
-    return make_expr_op( std::plus<>(), std::forward<In1>(input1), std::forward<In2>(input2));
+    using T = detail::value_t<In1>;
+    if constexpr (detail::contracts_fma<T> && detail::is_expr_of<In1, std::multiplies<>>) {
+        return make_expr_op(detail::fused_multiply_add(), detail::operand<0>(input1), detail::operand<1>(input1), std::forward<In2>(input2));
+    } else if constexpr (detail::contracts_fma<T> && detail::is_expr_of<In2, std::multiplies<>>) {
+        return make_expr_op(detail::fused_multiply_add(), detail::operand<0>(input2), detail::operand<1>(input2), std::forward<In1>(input1));
+    } else if constexpr (detail::contracts_fma<T> && detail::is_scalar_expr_of<In1, detail::scalar_multiplies>) {
+        return make_expr_op(detail::scalar_fused_multiply_add<T>{input1.operation().value}, detail::operand<0>(input1), std::forward<In2>(input2));
+    } else if constexpr (detail::contracts_fma<T> && detail::is_scalar_expr_of<In2, detail::scalar_multiplies>) {
+        return make_expr_op(detail::scalar_fused_multiply_add<T>{input2.operation().value}, detail::operand<0>(input2), std::forward<In1>(input1));
+    } else if constexpr (detail::is_expr_of<In2, std::negate<>>) {
+        return make_expr_op(std::minus<>(), std::forward<In1>(input1), detail::operand<0>(input2));
+    } else if constexpr (detail::commutes<T> && detail::is_expr_of<In1, std::negate<>>) {
+        return make_expr_op(std::minus<>(), std::forward<In2>(input2), detail::operand<0>(input1));
+    } else {
+        return make_expr_op(std::plus<>(), std::forward<In1>(input1), std::forward<In2>(input2));
+    }
 }
 
 template <typename In>
     requires IsTensorLike<In>
 auto operator+(In&& input, typename std::remove_cvref_t<In>::value_type scalar) {
-    return make_expr_op( [scalar](auto x) { return x + scalar; }, std::forward<In>(input));
+    using T = detail::value_t<In>;
+    if constexpr (detail::folds_sums<T> && detail::is_scalar_expr_of<In, detail::scalar_plus>) {
+        return make_expr_op(detail::scalar_plus<T>{input.operation().value + scalar}, detail::operand<0>(input));
+    } else if constexpr (detail::folds_sums<T> && detail::is_scalar_expr_of<In, detail::scalar_minus>) {
+        return make_expr_op(detail::scalar_plus<T>{scalar - input.operation().value}, detail::operand<0>(input));
+    } else if constexpr (detail::contracts_fma<T> && detail::is_expr_of<In, std::multiplies<>>) {
+        return make_expr_op(detail::fused_multiply_add_scalar<T>{scalar}, detail::operand<0>(input), detail::operand<1>(input));
+    } else if constexpr (detail::contracts_fma<T> && detail::is_scalar_expr_of<In, detail::scalar_multiplies>) {
+        return make_expr_op(detail::scalar_multiply_add<T>{input.operation().value, scalar}, detail::operand<0>(input));
+    } else {
+        return make_expr_op(detail::scalar_plus<T>{scalar}, std::forward<In>(input));
+    }
 }
 
 template <typename In>
     requires IsTensorLike<In>
 auto operator+(typename std::remove_cvref_t<In>::value_type scalar, In&& input) {
-    return make_expr_op( [scalar](auto x) { return scalar + x; }, std::forward<In>(input));
+    if constexpr (detail::commutes<detail::value_t<In>>) {
+        return std::forward<In>(input) + scalar;
+    } else {
+        return make_expr_op(detail::scalar_plus_left<detail::value_t<In>>{scalar}, std::forward<In>(input));
+    }
 }
 
 template <typename In1, typename In2>
     requires (IsTensorLike<In1> && IsTensorLike<In2>)
 auto operator-(In1&& input1, In2&& input2) {
-    return make_expr_op( std::minus<>(), std::forward<In1>(input1), std::forward<In2>(input2));
+    using T = detail::value_t<In1>;
+    if constexpr (detail::contracts_fma<T> && detail::is_expr_of<In1, std::multiplies<>>) {
+        return make_expr_op(detail::fused_multiply_subtract(), detail::operand<0>(input1), detail::operand<1>(input1), std::forward<In2>(input2));
+    } else if constexpr (detail::contracts_fma<T> && detail::is_expr_of<In2, std::multiplies<>>) {
+        return make_expr_op(detail::fused_negate_multiply_add(), detail::operand<0>(input2), detail::operand<1>(input2), std::forward<In1>(input1));
+    } else if constexpr (detail::contracts_fma<T> && detail::is_scalar_expr_of<In1, detail::scalar_multiplies>) {
+        return make_expr_op(detail::scalar_fused_multiply_subtract<T>{input1.operation().value}, detail::operand<0>(input1), std::forward<In2>(input2));
+    } else if constexpr (detail::contracts_fma<T> && detail::is_scalar_expr_of<In2, detail::scalar_multiplies>) {
+        return make_expr_op(detail::scalar_fused_multiply_add<T>{-input2.operation().value}, detail::operand<0>(input2), std::forward<In1>(input1));
+    } else if constexpr (detail::is_expr_of<In2, std::negate<>>) {
+        return make_expr_op(std::plus<>(), std::forward<In1>(input1), detail::operand<0>(input2));
+    } else {
+        return make_expr_op(std::minus<>(), std::forward<In1>(input1), std::forward<In2>(input2));
+    }
 }
 
 template <typename In>
     requires IsTensorLike<In>
 auto operator-(In&& input, typename std::remove_cvref_t<In>::value_type scalar) {
-    return make_expr_op( [scalar](auto x) { return x - scalar; }, std::forward<In>(input));
+    using T = detail::value_t<In>;
+    if constexpr (detail::folds_sums<T> && detail::is_scalar_expr_of<In, detail::scalar_plus>) {
+        return make_expr_op(detail::scalar_plus<T>{input.operation().value - scalar}, detail::operand<0>(input));
+    } else if constexpr (detail::folds_sums<T> && detail::is_scalar_expr_of<In, detail::scalar_minus>) {
+        return make_expr_op(detail::scalar_minus<T>{input.operation().value + scalar}, detail::operand<0>(input));
+    } else if constexpr (detail::contracts_fma<T> && detail::is_expr_of<In, std::multiplies<>>) {
+        return make_expr_op(detail::fused_multiply_add_scalar<T>{-scalar}, detail::operand<0>(input), detail::operand<1>(input));
+    } else if constexpr (detail::contracts_fma<T> && detail::is_scalar_expr_of<In, detail::scalar_multiplies>) {
+        return make_expr_op(detail::scalar_multiply_add<T>{input.operation().value, -scalar}, detail::operand<0>(input));
+    } else {
+        return make_expr_op(detail::scalar_minus<T>{scalar}, std::forward<In>(input));
+    }
 }
 
 template <typename In>
     requires IsTensorLike<In>
 auto operator-(typename std::remove_cvref_t<In>::value_type scalar, In&& input) {
-    return make_expr_op( [scalar](auto x) { return scalar - x; }, std::forward<In>(input));
+    using T = detail::value_t<In>;
+    if constexpr (detail::commutes<T> && detail::is_expr_of<In, std::negate<>>) {
+        return make_expr_op(detail::scalar_plus<T>{scalar}, detail::operand<0>(input));
+    } else if constexpr (detail::folds_sums<T> && detail::is_scalar_expr_of<In, detail::scalar_plus>) {
+        return make_expr_op(detail::scalar_subtract_from<T>{scalar - input.operation().value}, detail::operand<0>(input));
+    } else if constexpr (detail::folds_sums<T> && detail::is_scalar_expr_of<In, detail::scalar_subtract_from>) {
+        return make_expr_op(detail::scalar_plus<T>{scalar - input.operation().value}, detail::operand<0>(input));
+    } else if constexpr (detail::contracts_fma<T> && detail::is_scalar_expr_of<In, detail::scalar_multiplies>) {
+        return make_expr_op(detail::scalar_multiply_add<T>{-input.operation().value, scalar}, detail::operand<0>(input));
+    } else {
+        return make_expr_op(detail::scalar_subtract_from<T>{scalar}, std::forward<In>(input));
+    }
 }
 
 template <typename In1, typename In2>
@@ -185,13 +358,24 @@ auto operator*(In1&& input1, In2&& input2) {
 template <typename In>
     requires IsTensorLike<In>
 auto operator*(In&& input, typename std::remove_cvref_t<In>::value_type scalar) {
-    return make_expr_op( [scalar](auto x) { return x * scalar; }, std::forward<In>(input));
+    using T = detail::value_t<In>;
+    if constexpr (detail::folds_products<T> && detail::is_scalar_expr_of<In, detail::scalar_multiplies>) {
+        return make_expr_op(detail::scalar_multiplies<T>{detail::fold_multiplies(input.operation().value, scalar)}, detail::operand<0>(input));
+    } else if constexpr (detail::is_expr_of<In, std::negate<>>) {
+        return make_expr_op(detail::scalar_multiplies<T>{-scalar}, detail::operand<0>(input));
+    } else {
+        return make_expr_op(detail::scalar_multiplies<T>{scalar}, std::forward<In>(input));
+    }
 }
 
 template <typename In>
     requires IsTensorLike<In>
 auto operator*(typename std::remove_cvref_t<In>::value_type scalar, In&& input) {
-    return make_expr_op( [scalar](auto x) { return scalar * x; }, std::forward<In>(input));
+    if constexpr (detail::commutes<detail::value_t<In>>) {
+        return std::forward<In>(input) * scalar;
+    } else {
+        return make_expr_op(detail::scalar_multiplies_left<detail::value_t<In>>{scalar}, std::forward<In>(input));
+    }
 }
 
 template <typename In1, typename In2>
@@ -203,7 +387,12 @@ auto operator/(In1&& input1, In2&& input2) {
 template <typename In>
     requires IsTensorLike<In>
 auto operator/(In&& input, typename std::remove_cvref_t<In>::value_type scalar) {
-    return make_expr_op( [scalar](auto x) { return x / scalar; }, std::forward<In>(input));
+    using T = detail::value_t<In>;
+    if constexpr (detail::folds_products<T> && std::is_floating_point_v<T> && detail::is_scalar_expr_of<In, detail::scalar_divides>) {
+        return make_expr_op(detail::scalar_divides<T>{detail::fold_multiplies(input.operation().value, scalar)}, detail::operand<0>(input));
+    } else {
+        return make_expr_op(detail::scalar_divides<T>{scalar}, std::forward<In>(input));
+    }
 }
 
 template <typename In1, typename In2>
@@ -215,13 +404,25 @@ auto operator%(In1&& input1, In2&& input2) {
 template <typename In>
     requires IsTensorLike<In>
 auto operator%(In&& input, typename std::remove_cvref_t<In>::value_type scalar) {
-    return make_expr_op( [scalar](auto x) { return x % scalar; }, std::forward<In>(input));
+    return make_expr_op(detail::scalar_modulus<detail::value_t<In>>{scalar}, std::forward<In>(input));
 }
 
 template <typename In>
     requires IsTensorLike<In>
 auto operator-(In&& input) {
-    return make_expr_op( std::negate<>(), std::forward<In>(input));
+    using T = detail::value_t<In>;
+    if constexpr (detail::is_expr_of<In, std::negate<>>) {
+        // an operand that is a span stays behind a read-only node
+        if constexpr (IsTensorExpr<decltype(detail::operand<0>(input))>) {
+            return detail::operand<0>(input);
+        } else {
+            return make_expr_op(detail::identity_op(), detail::operand<0>(input));
+        }
+    } else if constexpr (detail::is_scalar_expr_of<In, detail::scalar_multiplies>) {
+        return make_expr_op(detail::scalar_multiplies<T>{-input.operation().value}, detail::operand<0>(input));
+    } else {
+        return make_expr_op( std::negate<>(), std::forward<In>(input));
+    }
 }
 
 } // namespace nabla
@@ -1,32 +1,37 @@
 #ifndef NABLA_ELEMENTWISE_EXPR_ITERATOR_HPP
 #define NABLA_ELEMENTWISE_EXPR_ITERATOR_HPP
 
-#include <functional>
-#include <utility>
-#include <tuple>
+#include <array>
+#include <cstddef>
 #include "nabla/concepts.hpp"
 #include "nabla/types.hpp"
 
 namespace nabla {
 
-template <typename Op, typename... Inputs>
-    requires (IsExprIteratorCompatible<Inputs> && ...)
+// Iterator over the elements of an expression, left-major or, when every
+// leaf is RightStride, right-major. One coordinate serves the whole tree,
+// which is evaluated there on dereference.
+template <typename ExprT, bool RightMajor = false>
 class ExprIterator : public ExprIteratorTag {
-    Op _op;
-    std::tuple<Inputs...> _inputs;
-    using input1_t = std::tuple_element_t<0, std::tuple<Inputs...>>;
-
     public:
 
         //
         // Member types
         //
-        using op_type = Op;
-        using inputs_type = std::tuple<Inputs...>;
-        using element_type = typename input1_t::element_type;
-        using value_type = typename input1_t::value_type;
-        using difference_type = typename input1_t::difference_type;
-        using pointer = typename input1_t::pointer;
+        using expr_type = ExprT;
+        using element_type = typename ExprT::value_type;
+        using value_type = typename ExprT::value_type;
+        using difference_type = std::ptrdiff_t;
+        using pointer = void;
+        using index_type = typename ExprT::index_type;
+        using coord_type = std::array<index_type, ExprT::rank()>;
+
+    private:
+        const ExprT* _expr = nullptr;
+        coord_type _indices{};
+        difference_type _position = 0;
+
+    public:
 
         //
         // Constructors
@@ -34,22 +39,37 @@ class ExprIterator : public ExprIteratorTag {
         ExprIterator() = default;
         ExprIterator(const ExprIterator&) = default;
         ExprIterator(ExprIterator&&) = default;
+        ExprIterator& operator=(const ExprIterator&) = default;
+        ExprIterator& operator=(ExprIterator&&) = default;
 
-        ExprIterator(const Op& op, const Inputs&... inputs)
-            : _op(op), _inputs(inputs...) {}
-
-        ExprIterator(Op&& op, Inputs&&... inputs)
-            : _op(std::move(op)), _inputs(std::move(inputs)...) {}
+        // iterator at linear position `position` in [0, size]
+        explicit ExprIterator(const ExprT* expr, difference_type position = 0)
+            : _expr(expr), _position(position) {
+                if (position < static_cast<difference_type>(expr->size())) {
+                    for (std::size_t k = 0; k < _indices.size(); ++k) {
+                        const std::size_t r = RightMajor ? _indices.size() - 1 - k : k;
+                        const auto n = static_cast<difference_type>(expr->extent(r));
+                        _indices[r] = static_cast<index_type>(position % n);
+                        position /= n;
+                    }
+                }
+            }
 
         element_type operator*() const {
-            return std::apply(
-                [&](auto const&... ins) {
-                    return _op(*ins...);
-                }, _inputs);
+            return _expr->node().at(_indices);
         }
 
+        const coord_type& indices() const noexcept { return _indices; }
+
         ExprIterator& operator++() {
-            std::apply([](auto&... ins) { ((++ins), ...); }, _inputs);
+            ++_position;
+            for (std::size_t k = 0; k < _indices.size(); ++k) {
+                const std::size_t r = RightMajor ? _indices.size() - 1 - k : k;
+                if (++_indices[r] < _expr->extent(r)) {
+                    break;
+                }
+                _indices[r] = 0;
+            }
             return *this;
         }
 
@@ -60,7 +80,7 @@ class ExprIterator : public ExprIteratorTag {
         }
 
         bool operator==(const ExprIterator& other) const {
-            return std::get<0>(_inputs) == std::get<0>(other._inputs);
+            return _position == other._position;
         }
 
         bool operator!=(const ExprIterator& other) const {
@@ -0,0 +1,778 @@
+#ifndef NABLA_EXPR_EVALUATOR_HPP
+#define NABLA_EXPR_EVALUATOR_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <tuple>
+#include <type_traits>
+#include "nabla/types.hpp"
+#include "nabla/concepts.hpp"
+#include "nabla/expr_node.hpp"
+#include "nabla/utility/helpers.hpp"
+#include "nabla/aligned_accessor.hpp"
+#include "nabla/aligned_allocator.hpp"
+#include "nabla/streaming.hpp"
+#include "nabla/parallel.hpp"
+
+// Evaluation engine for elementwise assignment. An expression tree is
+// lowered to a tree of kernels whose leaves hold a raw pointer and strides.
+// Dimension 0 is evaluated by a tight inner loop and dimensions 1..N-1 by an
+// outer loop nest that repositions every leaf once per row. When all leaves
+// and the destination share strides a single offset is computed for the
+// whole tree, and unit-stride rows get a loop the compiler can vectorize.
+// Leaves broadcast along dimension 0 (stride 0) are loaded once per row.
+// Work is addressed by element ranges so it can be split across threads.
+// Plain copies between operands that are fastest along different
+// dimensions, such as transposes, are evaluated in cache-sized tiles.
+// Destinations larger than the last level cache are written with streaming
+// stores (see streaming.hpp).
+
+namespace nabla {
+namespace detail {
+
+    // Tensors whose elements are read directly from a pointer
+    template <typename T>
+    concept IsPointerBacked =
+        (IsTensorArray<T> && std::is_pointer_v<typename std::remove_cvref_t<T>::pointer>) ||
+        (IsTensorSpan<T> && IsPlainMemoryAccessor<typename std::remove_cvref_t<T>::accessor_type>);
+
+    // Alignment in bytes of the data pointer of a pointer-backed tensor
+    template <typename T>
+    constexpr std::size_t data_alignment() noexcept {
+        using U = std::remove_cvref_t<T>;
+        if constexpr (IsTensorArray<U>) {
+            if constexpr (requires { typename U::container_type::allocator_type; }) {
+                return allocator_alignment<typename U::container_type::allocator_type>::value;
+            } else {
+                return alignof(typename U::value_type);
+            }
+        } else {
+            constexpr std::size_t alignment = pointer_alignment<typename U::accessor_type>;
+            return alignment != 0 ? alignment : alignof(typename U::value_type);
+        }
+    }
+
+    // Accessors that decode elements stored in plain memory of another type,
+    // such as quantized integers, opt in to a leaf that reads that memory
+    // directly with members storage_pointer(p), the memory of the element at
+    // p, and row_decoder(p, offset, stride), a callable d such that
+    // access(p, offset + i * stride) is d(storage_pointer(p)[offset + i * stride], i).
+    // The decoder is made once per row, so that its parameters are hoisted.
+    template <typename Accessor>
+    concept HasRowDecoder = requires(const Accessor& a, const typename Accessor::data_handle_type& p) {
+        requires std::is_pointer_v<decltype(a.storage_pointer(p))>;
+        a.row_decoder(p, std::size_t{}, std::ptrdiff_t{});
+    };
+
+    // Writable accessors that store elements in plain memory of another type
+    // with an encoding that does not depend on the position, such as
+    // float16, opt in as destinations of the evaluator with members
+    // storage_pointer(p) and encoder(), a callable e such that writing x
+    // through access(p, i) stores e(x) to storage_pointer(p)[i].
+    template <typename Accessor>
+    concept HasEncoder = requires(const Accessor& a, const typename Accessor::data_handle_type& p) {
+        requires std::is_pointer_v<decltype(a.storage_pointer(p))>;
+        a.encoder();
+    };
+
+    template <typename T>
+    concept IsEncodedDestination =
+        IsTensorSpan<T> && !std::is_const_v<typename std::remove_cvref_t<T>::element_type> &&
+        HasEncoder<typename std::remove_cvref_t<T>::accessor_type>;
+
+    // Destinations the evaluator writes to memory
+    template <typename T>
+    concept IsEvaluable = IsPointerBacked<T> || IsEncodedDestination<T>;
+
+    // The data pointer, marked with std::assume_aligned for the kernels
+    template <typename T>
+        requires IsPointerBacked<T>
+    constexpr auto data_pointer(T& t) noexcept {
+        if constexpr (IsTensorArray<T>) {
+            return std::assume_aligned<data_alignment<T>()>(t.data());
+        } else {
+            return std::assume_aligned<data_alignment<T>()>(raw_pointer(t.accessor(), t.data_handle()));
+        }
+    }
+
+    // The memory the evaluator writes a destination's elements to
+    template <typename T>
+        requires IsEvaluable<T>
+    constexpr auto output_pointer(T& t) noexcept {
+        if constexpr (IsPointerBacked<T>) {
+            return data_pointer(t);
+        } else {
+            return t.accessor().storage_pointer(t.data_handle());
+        }
+    }
+
+    // kernels use signed offsets regardless of the tensors' index types
+    using offset_type = std::ptrdiff_t;
+
+    template <std::size_t Rank>
+    using offset_coord = std::array<offset_type, Rank>;
+
+    //
+    // Software prefetch
+    //
+    // Rows that step over whole cache lines, such as a row of a left-major
+    // matrix, defeat the hardware prefetcher, which follows runs of nearby
+    // lines, so every load waits on memory. Strided rows instead prefetch
+    // the element a fixed number of iterations ahead of the one they load.
+    //
+
+    // whether a stride of `stride` elements of T skips whole cache lines
+    template <typename T>
+    constexpr bool skips_lines(offset_type stride) noexcept {
+        return static_cast<std::size_t>(stride < 0 ? -stride : stride) * sizeof(T) >= cache_line_size;
+    }
+
+    // Hints the load (Write false) or store of p[i]. The address is computed
+    // as an integer, p + i may be past the end of the data.
+    template <bool Write = false, typename T>
+    inline void prefetch(const T* p, offset_type i) noexcept {
+#if defined(__GNUC__)
+        const std::uintptr_t address = reinterpret_cast<std::uintptr_t>(p) + static_cast<std::uintptr_t>(i * static_cast<offset_type>(sizeof(T)));
+        __builtin_prefetch(reinterpret_cast<const void*>(address), Write ? 1 : 0, 3);
+#endif
+    }
+
+    template <typename IndexType, std::size_t Rank>
+    constexpr offset_coord<Rank> to_offsets(const std::array<IndexType, Rank>& c) noexcept {
+        offset_coord<Rank> offsets{};
+        for (std::size_t r = 0; r < Rank; ++r) {
+            offsets[r] = static_cast<offset_type>(c[r]);
+        }
+        return offsets;
+    }
+
+    template <typename MapT>
+    constexpr offset_coord<MapT::extents_type::rank()> strides_of(const MapT& map) noexcept {
+        offset_coord<MapT::extents_type::rank()> strides{};
+        for (std::size_t r = 0; r < strides.size(); ++r) {
+            strides[r] = static_cast<offset_type>(map.stride(r));
+        }
+        return strides;
+    }
+
+    template <std::size_t Rank>
+    using dim_order = std::array<std::size_t, Rank>;
+
+    // c reordered so that element d is c[order[d]]
+    template <typename T, std::size_t Rank>
+    constexpr std::array<T, Rank> permuted(const std::array<T, Rank>& c, const dim_order<Rank>& order) noexcept {
+        std::array<T, Rank> p{};
+        for (std::size_t d = 0; d < Rank; ++d) {
+            p[d] = c[order[d]];
+        }
+        return p;
+    }
+
+    // Dimensions by increasing stride, the natural traversal order of a
+    // layout: identity for LeftStride, reversed for RightStride. Stable, so
+    // ties keep left-major order.
+    template <std::size_t Rank>
+    dim_order<Rank> stride_order(const offset_coord<Rank>& strides) {
+        dim_order<Rank> order;
+        for (std::size_t d = 0; d < Rank; ++d) {
+            order[d] = d;
+        }
+        utility::insertion_sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) { return strides[a] < strides[b]; });
+        return order;
+    }
+
+    template <std::size_t Rank>
+    constexpr offset_type row_offset(const offset_coord<Rank>& strides, const offset_coord<Rank>& idx) noexcept {
+        offset_type offset = 0;
+        for (std::size_t r = 1; r < Rank; ++r) {
+            offset += strides[r] * idx[r];
+        }
+        return offset;
+    }
+
+    // How the leaves read the elements of a row: all adjacent, adjacent or
+    // broadcast along the row, or strided. Rows without broadcasts get a
+    // kernel of plain loads.
+    enum class row_kind { contiguous, broadcast, strided };
+
+    // Leaf backed by plain memory
+    template <typename T, std::size_t Rank>
+    class PointerLeaf {
+        public:
+            using value_type = std::remove_cv_t<T>;
+            using coord_type = offset_coord<Rank>;
+
+        private:
+            const value_type* _data;
+            coord_type _strides;
+            const value_type* _row;
+            value_type _invariant{};
+
+        public:
+            PointerLeaf(const value_type* data, const coord_type& strides)
+                : _data(data), _strides(strides), _row(data) {}
+
+            // unit stride, or broadcast along the row
+            bool is_unit() const noexcept { return _strides[0] <= 1; }
+            bool is_contiguous() const noexcept { return _strides[0] == 1; }
+            bool has_strides(const coord_type& strides) const noexcept { return _strides == strides; }
+            const coord_type& reference_strides() const noexcept { return _strides; }
+            void permute(const dim_order<std::tuple_size_v<coord_type>>& order) noexcept { _strides = permuted(_strides, order); }
+
+            void set_row(const coord_type& idx) noexcept {
+                _row = _data + row_offset(_strides, idx);
+                if (_strides[0] == 0) {
+                    _invariant = *_row;
+                }
+            }
+
+            template <row_kind Kind>
+            value_type eval(offset_type i) const noexcept {
+                if constexpr (Kind == row_kind::contiguous) {
+                    return _row[i];
+                } else if constexpr (Kind == row_kind::broadcast) {
+                    return _strides[0] == 0 ? _invariant : _row[i];
+                } else {
+                    return _row[i * _strides[0]];
+                }
+            }
+
+            value_type at(offset_type offset) const noexcept {
+                return _data[offset];
+            }
+
+            // prefetches element i of a strided row
+            void prefetch(offset_type i) const noexcept {
+                if (skips_lines<value_type>(_strides[0])) {
+                    detail::prefetch(_row, i * _strides[0]);
+                }
+            }
+    };
+
+    // Leaf read through its accessor, for data handles that are not pointers.
+    // Source is a tensor or an ExprLeaf, anything with access(offset).
+    template <typename Source>
+    class AccessorLeaf {
+        public:
+            using value_type = typename Source::value_type;
+            using coord_type = offset_coord<Source::rank()>;
+
+        private:
+            Source _tensor;
+            coord_type _strides;
+            offset_type _row = 0;
+            value_type _invariant{};
+
+        public:
+            AccessorLeaf(const Source& tensor, const coord_type& strides)
+                : _tensor(tensor), _strides(strides) {}
+
+            // unit stride, or broadcast along the row
+            bool is_unit() const noexcept { return _strides[0] <= 1; }
+            bool is_contiguous() const noexcept { return _strides[0] == 1; }
+            bool has_strides(const coord_type& strides) const noexcept { return _strides == strides; }
+            const coord_type& reference_strides() const noexcept { return _strides; }
+            void permute(const dim_order<std::tuple_size_v<coord_type>>& order) noexcept { _strides = permuted(_strides, order); }
+
+            void set_row(const coord_type& idx) {
+                _row = row_offset(_strides, idx);
+                if (_strides[0] == 0) {
+                    _invariant = _tensor.access(_row);
+                }
+            }
+
+            template <row_kind Kind>
+            value_type eval(offset_type i) const {
+                if constexpr (Kind == row_kind::contiguous) {
+                    return _tensor.access(_row + i);
+                } else if constexpr (Kind == row_kind::broadcast) {
+                    return _strides[0] == 0 ? _invariant : _tensor.access(_row + i);
+                } else {
+                    return _tensor.access(_row + i * _strides[0]);
+                }
+            }
+
+            value_type at(offset_type offset) const {
+                return _tensor.access(offset);
+            }
+
+            // the accessor hides the address
+            void prefetch(offset_type) const noexcept {}
+    };
+
+    // Leaf decoded from plain memory by its accessor, see HasRowDecoder
+    template <typename SpanT>
+    class DecodedLeaf {
+        public:
+            using value_type = typename SpanT::value_type;
+            using coord_type = offset_coord<SpanT::rank()>;
+
+        private:
+            using accessor_type = typename SpanT::accessor_type;
+            using handle_type = typename SpanT::data_handle_type;
+            using storage_type = std::remove_cv_t<std::remove_pointer_t<decltype(std::declval<const accessor_type&>().storage_pointer(std::declval<const handle_type&>()))>>;
+            using decoder_type = decltype(std::declval<const accessor_type&>().row_decoder(std::declval<const handle_type&>(), std::size_t{}, offset_type{}));
+
+            accessor_type _accessor;
+            handle_type _handle;
+            const storage_type* _data;
+            coord_type _strides;
+            const storage_type* _row;
+            decoder_type _decode;
+            value_type _invariant{};
+
+        public:
+            DecodedLeaf(const ExprLeaf<SpanT>& leaf, const coord_type& strides)
+                : _accessor(leaf.accessor()), _handle(leaf.data_handle()), _data(_accessor.storage_pointer(_handle)),
+                  _strides(strides), _row(_data), _decode(_accessor.row_decoder(_handle, 0, strides[0])) {}
+
+            // unit stride, or broadcast along the row
+            bool is_unit() const noexcept { return _strides[0] <= 1; }
+            bool is_contiguous() const noexcept { return _strides[0] == 1; }
+            bool has_strides(const coord_type& strides) const noexcept { return _strides == strides; }
+            const coord_type& reference_strides() const noexcept { return _strides; }
+            void permute(const dim_order<std::tuple_size_v<coord_type>>& order) noexcept { _strides = permuted(_strides, order); }
+
+            void set_row(const coord_type& idx) {
+                const offset_type offset = row_offset(_strides, idx);
+                _row = _data + offset;
+                _decode = _accessor.row_decoder(_handle, static_cast<std::size_t>(offset), _strides[0]);
+                if (_strides[0] == 0) {
+                    _invariant = _decode(*_row, 0);
+                }
+            }
+
+            template <row_kind Kind>
+            value_type eval(offset_type i) const noexcept {
+                if constexpr (Kind == row_kind::contiguous) {
+                    return _decode(_row[i], i);
+                } else if constexpr (Kind == row_kind::broadcast) {
+                    return _strides[0] == 0 ? _invariant : _decode(_row[i], i);
+                } else {
+                    return _decode(_row[i * _strides[0]], i);
+                }
+            }
+
+            value_type at(offset_type offset) const {
+                return _accessor.access(_handle, static_cast<std::size_t>(offset));
+            }
+
+            void prefetch(offset_type i) const noexcept {
+                if (skips_lines<storage_type>(_strides[0])) {
+                    detail::prefetch(_row, i * _strides[0]);
+                }
+            }
+    };
+
+    template <typename Op, typename... Kernels>
+    class KernelNode {
+        Op _op;
+        std::tuple<Kernels...> _inputs;
+
+        public:
+            using coord_type = typename std::tuple_element_t<0, std::tuple<Kernels...>>::coord_type;
+
+            KernelNode(const Op& op, const Kernels&... inputs)
+                : _op(op), _inputs(inputs...) {}
+
+            bool is_unit() const noexcept {
+                return std::apply([](const auto&... ins) { return (ins.is_unit() && ...); }, _inputs);
+            }
+
+            bool is_contiguous() const noexcept {
+                return std::apply([](const auto&... ins) { return (ins.is_contiguous() && ...); }, _inputs);
+            }
+
+            bool has_strides(const coord_type& strides) const noexcept {
+                return std::apply([&](const auto&... ins) { return (ins.has_strides(strides) && ...); }, _inputs);
+            }
+
+            // strides of the first leaf, used to order traversals that have
+            // no destination
+            const coord_type& reference_strides() const noexcept {
+                return std::get<0>(_inputs).reference_strides();
+            }
+
+            void permute(const dim_order<std::tuple_size_v<coord_type>>& order) noexcept {
+                std::apply([&](auto&... ins) { (ins.permute(order), ...); }, _inputs);
+            }
+
+            void set_row(const coord_type& idx) {
+                std::apply([&](auto&... ins) { (ins.set_row(idx), ...); }, _inputs);
+            }
+
+            template <row_kind Kind>
+            auto eval(offset_type i) const {
+                return std::apply([&](const auto&... ins) { return _op(ins.template eval<Kind>(i)...); }, _inputs);
+            }
+
+            void prefetch(offset_type i) const noexcept {
+                std::apply([&](const auto&... ins) { (ins.prefetch(i), ...); }, _inputs);
+            }
+
+            auto at(offset_type offset) const {
+                return std::apply([&](const auto&... ins) { return _op(ins.at(offset)...); }, _inputs);
+            }
+    };
+
+    template <typename T>
+    inline constexpr bool is_kernel_node = false;
+
+    template <typename Op, typename... Kernels>
+    inline constexpr bool is_kernel_node<KernelNode<Op, Kernels...>> = true;
+
+    template <typename SpanT>
+    auto lower(const ExprLeaf<SpanT>& leaf) {
+        if constexpr (IsPointerBacked<const SpanT>) {
+            return PointerLeaf<typename SpanT::value_type, SpanT::rank()>(
+                std::assume_aligned<data_alignment<SpanT>()>(raw_pointer(leaf.accessor(), leaf.data_handle())),
+                to_offsets(leaf.strides()));
+        } else if constexpr (HasRowDecoder<typename SpanT::accessor_type>) {
+            return DecodedLeaf<SpanT>(leaf, to_offsets(leaf.strides()));
+        } else {
+            return AccessorLeaf<ExprLeaf<SpanT>>(leaf, to_offsets(leaf.strides()));
+        }
+    }
+
+    template <typename Op, typename... Nodes>
+    auto lower(const ExprNode<Op, Nodes...>& node) {
+        return std::apply(
+            [&](const auto&... inputs) {
+                return KernelNode<Op, decltype(lower(inputs))...>(node.operation(), lower(inputs)...);
+            },
+            node.inputs());
+    }
+
+    template <typename T>
+        requires IsTensorSpan<T> || IsTensorArray<T>
+    auto lower(const T& tensor) {
+        if constexpr (IsTensorSpan<T>) {
+            return lower(ExprLeaf<T>(tensor));
+        } else if constexpr (IsPointerBacked<const T>) {
+            return PointerLeaf<typename T::value_type, T::rank()>(data_pointer(tensor), strides_of(tensor.mapping()));
+        } else {
+            return AccessorLeaf<T>(tensor, strides_of(tensor.mapping()));
+        }
+    }
+
+    template <typename T>
+        requires IsTensorExpr<T>
+    auto lower(const T& expr) {
+        return lower(expr.node());
+    }
+
+    // Lowers src for evaluation into dst, encoding its values for
+    // destinations that store another type
+    template <typename Dst, typename Src>
+    auto lower_into(const Dst& dst, const Src& src) {
+        if constexpr (IsEncodedDestination<Dst>) {
+            using encoder_type = decltype(dst.accessor().encoder());
+            return KernelNode<encoder_type, decltype(lower(src))>(dst.accessor().encoder(), lower(src));
+        } else {
+            return lower(src);
+        }
+    }
+
+    // Work decomposition of an evaluation. The dimensions are first put in
+    // the destination's natural order (see stride_order), then the
+    // destination is split into lines of `line` elements numbered in
+    // left-major order of the reordered dimensions. When every leaf
+    // shares the destination's strides, the contiguous leading dimensions are
+    // merged into one line and a single offset serves the destination and
+    // all leaves. Otherwise a line is one row along dimension 0 and each leaf
+    // is repositioned per row. Rows that are not unit-stride prefetch
+    // `prefetch` elements ahead, see set_prefetch.
+    template <std::size_t Rank>
+    struct EvalPlan {
+        offset_coord<Rank> exts{};
+        offset_coord<Rank> strides{};
+        dim_order<Rank> order{};
+        bool shared_offsets = false;
+        std::size_t inner_dims = 1;
+        offset_type line = 0;
+        std::size_t size = 0;
+        offset_type prefetch = 0;
+    };
+
+    // Plans the traversal of extents `exts`, with lines laid out by `strides`.
+    // The kernel's dimensions are reordered to match the plan.
+    template <std::size_t Rank, typename KernelT>
+    EvalPlan<Rank> make_plan(const offset_coord<Rank>& exts, const offset_coord<Rank>& strides, KernelT& kernel) {
+        EvalPlan<Rank> plan;
+        plan.order = stride_order(strides);
+        plan.exts = permuted(exts, plan.order);
+        plan.strides = permuted(strides, plan.order);
+        if (plan.order != stride_order(offset_coord<Rank>{})) {
+            kernel.permute(plan.order);
+        }
+        plan.size = 1;
+        for (std::size_t r = 0; r < Rank; ++r) {
+            plan.size *= static_cast<std::size_t>(plan.exts[r]);
+        }
+        if (plan.size == 0) {
+            return plan;
+        }
+        plan.line = plan.exts[0];
+        if (kernel.has_strides(plan.strides) && plan.strides[0] == 1) {
+            plan.shared_offsets = true;
+            while (plan.inner_dims < Rank && plan.strides[plan.inner_dims] == plan.line) {
+                plan.line *= plan.exts[plan.inner_dims];
+                ++plan.inner_dims;
+            }
+        }
+        return plan;
+    }
+
+    template <typename T>
+    offset_coord<std::remove_cvref_t<T>::rank()> extents_of(const T& t) {
+        offset_coord<std::remove_cvref_t<T>::rank()> exts{};
+        for (std::size_t r = 0; r < exts.size(); ++r) {
+            exts[r] = static_cast<offset_type>(t.extent(r));
+        }
+        return exts;
+    }
+
+    // Plans the evaluation of a kernel into a destination of the same extents
+    template <typename Dst, typename KernelT>
+    auto make_plan(const Dst& dst, KernelT& kernel) {
+        return make_plan(extents_of(dst), strides_of(dst.mapping()), kernel);
+    }
+
+    // Sets the prefetch distance of a plan from the policy's, for rows long
+    // enough to run ahead in
+    template <std::size_t Rank, typename Policy>
+    void set_prefetch(EvalPlan<Rank>& plan, const Policy& policy) noexcept {
+        const auto distance = static_cast<offset_type>(policy.prefetch_distance);
+        plan.prefetch = plan.shared_offsets || plan.line <= distance ? 0 : distance;
+    }
+
+    // Chunk size for splitting a plan across threads: at least `grain`
+    // elements, rounded up to whole lines when lines are shorter than that
+    template <std::size_t Rank>
+    std::size_t chunk_grain(const EvalPlan<Rank>& plan, std::size_t grain) noexcept {
+        const auto line = static_cast<std::size_t>(plan.line);
+        if (line > 0 && line <= grain) {
+            grain = (grain + line - 1) / line * line;
+        }
+        return grain;
+    }
+
+    // Visits elements [begin, end) of the plan, counted in the plan's order,
+    // one line at a time. Calls f(offset, pos, i0, i1, load, unit) where
+    // `offset` is the line's offset under plan.strides, `pos` the linear
+    // position of element 0 of the line, `load(i)` the kernel's value at
+    // element i of the line for i in [i0, i1), and `unit` a std::bool_constant
+    // telling whether elements of the line are adjacent under plan.strides.
+    // Any range may be handed to any worker with its own kernel copy.
+    template <typename KernelT, std::size_t Rank, typename F>
+    void visit_lines(const EvalPlan<Rank>& plan, KernelT& kernel, std::size_t begin, std::size_t end, F&& f) {
+        if (begin >= end) {
+            return;
+        }
+        const auto line = static_cast<std::size_t>(plan.line);
+        offset_coord<Rank> idx{};
+        std::size_t rem = begin / line;
+        offset_type offset = 0;
+        for (std::size_t r = plan.inner_dims; r < Rank; ++r) {
+            idx[r] = static_cast<offset_type>(rem % static_cast<std::size_t>(plan.exts[r]));
+            rem /= static_cast<std::size_t>(plan.exts[r]);
+            offset += idx[r] * plan.strides[r];
+        }
+        const bool unit = plan.strides[0] == 1 && kernel.is_unit();
+        const bool contiguous = unit && kernel.is_contiguous();
+        auto i0 = static_cast<offset_type>(begin % line);
+        std::size_t pos = begin - static_cast<std::size_t>(i0);
+        while (pos < end) {
+            const auto i1 = static_cast<offset_type>(std::min(line, end - pos));
+            if (plan.shared_offsets) {
+                const KernelT& k = kernel;
+                f(offset, pos, i0, i1, [&k, offset](offset_type i) { return k.at(offset + i); }, std::true_type{});
+            } else {
+                kernel.set_row(idx);
+                const KernelT& k = kernel;
+                if (contiguous) {
+                    f(offset, pos, i0, i1, [&k](offset_type i) { return k.template eval<row_kind::contiguous>(i); }, std::true_type{});
+                } else if (unit) {
+                    f(offset, pos, i0, i1, [&k](offset_type i) { return k.template eval<row_kind::broadcast>(i); }, std::true_type{});
+                } else if (plan.prefetch > 0) {
+                    f(offset, pos, i0, i1, [&k, ahead = plan.prefetch](offset_type i) {
+                        k.prefetch(i + ahead);
+                        return k.template eval<row_kind::strided>(i);
+                    }, std::false_type{});
+                } else {
+                    f(offset, pos, i0, i1, [&k](offset_type i) { return k.template eval<row_kind::strided>(i); }, std::false_type{});
+                }
+            }
+            pos += line;
+            i0 = 0;
+            for (std::size_t r = plan.inner_dims; r < Rank; ++r) {
+                offset += plan.strides[r];
+                if (++idx[r] < plan.exts[r]) {
+                    break;
+                }
+                offset -= plan.strides[r] * plan.exts[r];
+                idx[r] = 0;
+            }
+        }
+    }
+
+    // Evaluates elements [begin, end) of the plan into out. With `stream`,
+    // unit-stride lines are written with streaming stores, fenced at the end.
+    template <typename OutT, typename KernelT, std::size_t Rank>
+    void evaluate_plan(OutT* out, const EvalPlan<Rank>& plan, KernelT& kernel,
+                       std::size_t begin, std::size_t end, bool stream = false) {
+        const offset_type step = plan.strides[0];
+        visit_lines(plan, kernel, begin, end, [&](offset_type offset, std::size_t, offset_type i0, offset_type i1, auto load, auto unit) {
+            OutT* line_out = out + offset;
+            if constexpr (decltype(unit)::value) {
+                if (stream) {
+                    stream_line(line_out, i0, i1, load);
+                } else {
+                    for (offset_type i = i0; i < i1; ++i) {
+                        line_out[i] = load(i);
+                    }
+                }
+            } else if (plan.prefetch > 0 && skips_lines<OutT>(step)) {
+                for (offset_type i = i0; i < i1; ++i) {
+                    prefetch<true>(line_out, (i + plan.prefetch) * step);
+                    line_out[i * step] = load(i);
+                }
+            } else {
+                for (offset_type i = i0; i < i1; ++i) {
+                    line_out[i * step] = load(i);
+                }
+            }
+        });
+        if (stream) {
+            stream_fence();
+        }
+    }
+
+    // Edge of a square tile of the blocked copy: a tile of each operand
+    // fits in L1 together
+    template <typename T>
+    inline constexpr offset_type tile_edge = std::clamp<offset_type>(256 / sizeof(T), 8, 64);
+
+    // Blocked traversal for a copy whose source is fastest along a different
+    // dimension than the destination, as when a transposed view is assigned.
+    // Row by row the source would be read across a whole matrix of cache
+    // lines and pages; instead dimension 0 of the plan (the destination's
+    // fastest) and dimension `inner` (the source's fastest) are cut into
+    // square tiles, so each tile is read and written while its lines are in
+    // cache. Work is split into panels, each the row of tiles along dimension
+    // 0 for one band of `edge` indices of `inner` at one index of the other
+    // dimensions; ranges are counted as `panel` elements per panel. inner is
+    // 0 when tiling does not apply and plan is evaluated as usual.
+    template <std::size_t Rank>
+    struct TilePlan {
+        EvalPlan<Rank> plan;
+        offset_coord<Rank> src_strides{};
+        std::size_t inner = 0;
+        offset_type edge = 0;
+        std::size_t bands = 0;
+        std::size_t panels = 0;
+        std::size_t panel = 0;
+    };
+
+    // Plans the evaluation of a kernel into a destination of the same
+    // extents, tiled when the kernel is a single leaf that qualifies
+    template <typename Dst, typename KernelT>
+    auto make_tile_plan(const Dst& dst, KernelT& kernel) {
+        constexpr std::size_t rank = std::remove_cvref_t<Dst>::rank();
+        TilePlan<rank> tiles;
+        tiles.plan = make_plan(dst, kernel);
+        if constexpr (rank >= 2 && !is_kernel_node<KernelT>) {
+            const auto& plan = tiles.plan;
+            const auto& src_strides = kernel.reference_strides();
+            if (plan.size == 0 || plan.shared_offsets || plan.exts[0] <= 1 || src_strides[0] == 0) {
+                return tiles;
+            }
+            std::size_t inner = 0;
+            for (std::size_t d = 1; d < rank; ++d) {
+                if (plan.exts[d] > 1 && src_strides[d] > 0 && src_strides[d] < src_strides[inner]) {
+                    inner = d;
+                }
+            }
+            if (inner == 0) {
+                return tiles;
+            }
+            tiles.src_strides = src_strides;
+            tiles.inner = inner;
+            tiles.edge = tile_edge<typename KernelT::value_type>;
+            tiles.bands = static_cast<std::size_t>((plan.exts[inner] + tiles.edge - 1) / tiles.edge);
+            tiles.panels = plan.size / static_cast<std::size_t>(plan.exts[0] * plan.exts[inner]) * tiles.bands;
+            tiles.panel = static_cast<std::size_t>(plan.exts[0] * tiles.edge);
+        }
+        return tiles;
+    }
+
+    // Evaluates the panels overlapping elements [begin, end) of a tiled
+    // plan, where ranges are expected in whole panels
+    template <typename OutT, typename LeafT, std::size_t Rank>
+    void evaluate_tiles(OutT* out, const TilePlan<Rank>& tiles, const LeafT& leaf,
+                        std::size_t begin, std::size_t end) {
+        const auto& plan = tiles.plan;
+        const std::size_t k = tiles.inner;
+        const offset_type dst0 = plan.strides[0];
+        const offset_type dstk = plan.strides[k];
+        const offset_type src0 = tiles.src_strides[0];
+        const offset_type srck = tiles.src_strides[k];
+        const std::size_t last = std::min(tiles.panels, (end + tiles.panel - 1) / tiles.panel);
+        for (std::size_t p = begin / tiles.panel; p < last; ++p) {
+            std::size_t rem = p / tiles.bands;
+            offset_type dst_offset = 0;
+            offset_type src_offset = 0;
+            for (std::size_t r = 1; r < Rank; ++r) {
+                if (r == k) {
+                    continue;
+                }
+                const auto i = static_cast<offset_type>(rem % static_cast<std::size_t>(plan.exts[r]));
+                rem /= static_cast<std::size_t>(plan.exts[r]);
+                dst_offset += i * plan.strides[r];
+                src_offset += i * tiles.src_strides[r];
+            }
+            const offset_type j0 = static_cast<offset_type>(p % tiles.bands) * tiles.edge;
+            const offset_type j1 = std::min(j0 + tiles.edge, plan.exts[k]);
+            for (offset_type i0 = 0; i0 < plan.exts[0]; i0 += tiles.edge) {
+                const offset_type i1 = std::min(i0 + tiles.edge, plan.exts[0]);
+                for (offset_type j = j0; j < j1; ++j) {
+                    OutT* line_out = out + dst_offset + j * dstk;
+                    const offset_type line_in = src_offset + j * srck;
+                    for (offset_type i = i0; i < i1; ++i) {
+                        line_out[i * dst0] = leaf.at(line_in + i * src0);
+                    }
+                }
+            }
+        }
+    }
+
+    // Whether the evaluation of a plan into dst uses streaming stores, given
+    // the threshold in bytes of parallel_policy::streaming_threshold
+    template <typename Dst, std::size_t Rank>
+    bool streams(Dst& dst, const EvalPlan<Rank>& plan, std::size_t threshold) noexcept {
+        using value_type = std::remove_pointer_t<decltype(output_pointer(dst))>;
+        return plan.strides[0] == 1 && use_streaming_stores<value_type>(plan.size * sizeof(value_type), threshold);
+    }
+
+    // Evaluates src into a destination of the same extents, prefetching
+    // strided rows by the distance of `policy`
+    template <typename Dst, typename Src, typename Policy = sequenced_policy>
+        requires IsEvaluable<Dst>
+    void evaluate(Dst& dst, const Src& src, const Policy& policy = {}) {
+        auto kernel = lower_into(dst, src);
+        auto tiles = make_tile_plan(dst, kernel);
+        set_prefetch(tiles.plan, policy);
+        if (tiles.inner != 0) {
+            evaluate_tiles(output_pointer(dst), tiles, kernel, 0, tiles.panels * tiles.panel);
+        } else {
+            evaluate_plan(output_pointer(dst), tiles.plan, kernel, 0, tiles.plan.size, streams(dst, tiles.plan, 0));
+        }
+    }
+
+} // namespace detail
+} // namespace nabla
+
+#endif // NABLA_EXPR_EVALUATOR_HPP
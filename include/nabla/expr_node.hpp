@@ -0,0 +1,99 @@
+#ifndef NABLA_EXPR_NODE_HPP
+#define NABLA_EXPR_NODE_HPP
+
+#include <array>
+#include <cstddef>
+#include <tuple>
+#include <utility>
+#include "nabla/concepts.hpp"
+
+// Storage of an expression tree. Extents are a runtime invariant of the whole
+// expression, so the nodes do not hold them: a leaf keeps only the data
+// handle, strides and accessor of its span, an inner node its operation and
+// inputs. ExprOp, the root, holds the extents once for the tree.
+
+namespace nabla {
+namespace detail {
+
+    // An operand span without its extents
+    template <typename SpanT>
+    class ExprLeaf {
+        public:
+            using span_type = SpanT;
+            using value_type = typename SpanT::value_type;
+            using index_type = typename SpanT::index_type;
+            using data_handle_type = typename SpanT::data_handle_type;
+            using accessor_type = typename SpanT::accessor_type;
+            using coord_type = std::array<index_type, SpanT::rank()>;
+
+        private:
+            data_handle_type _data;
+            coord_type _strides;
+            [[no_unique_address]] accessor_type _accessor;
+
+        public:
+            explicit ExprLeaf(const SpanT& span)
+                : _data(span.data_handle()), _accessor(span.accessor()) {
+                    for (std::size_t r = 0; r < _strides.size(); ++r) {
+                        _strides[r] = span.stride(r);
+                    }
+                }
+
+            static constexpr std::size_t rank() noexcept { return SpanT::rank(); }
+
+            const data_handle_type& data_handle() const noexcept { return _data; }
+            const coord_type& strides() const noexcept { return _strides; }
+            const accessor_type& accessor() const noexcept { return _accessor; }
+
+            decltype(auto) access(std::size_t offset) const {
+                return _accessor.access(_data, offset);
+            }
+
+            template <typename IndexType>
+            value_type at(const std::array<IndexType, SpanT::rank()>& idx) const {
+                std::size_t offset = 0;
+                for (std::size_t r = 0; r < idx.size(); ++r) {
+                    offset += static_cast<std::size_t>(_strides[r]) * static_cast<std::size_t>(idx[r]);
+                }
+                return _accessor.access(_data, offset);
+            }
+
+            // the span this leaf was made from, given the expression's extents
+            template <typename Extents>
+            SpanT span(const Extents& exts) const {
+                using mapping_type = typename SpanT::mapping_type;
+                return SpanT(_data, mapping_type(typename SpanT::extents_type(exts), _strides), _accessor);
+            }
+    };
+
+    // An operation applied to its input nodes
+    template <typename Op, typename... Nodes>
+    class ExprNode {
+        public:
+            using operation_type = Op;
+            using inputs_type = std::tuple<Nodes...>;
+
+        private:
+            [[no_unique_address]] Op _op;
+            inputs_type _inputs;
+
+        public:
+            ExprNode(const Op& op, const Nodes&... inputs)
+                : _op(op), _inputs(inputs...) {}
+
+            ExprNode(Op&& op, Nodes&&... inputs)
+                : _op(std::move(op)), _inputs(std::move(inputs)...) {}
+
+            const operation_type& operation() const noexcept { return _op; }
+            const inputs_type& inputs() const noexcept { return _inputs; }
+
+            template <typename IndexType, std::size_t Rank>
+            auto at(const std::array<IndexType, Rank>& idx) const {
+                return std::apply([&](const auto&... ins) { return _op(ins.at(idx)...); }, _inputs);
+            }
+    };
+
+} // namespace detail
+} // namespace nabla
+
+#endif // NABLA_EXPR_NODE_HPP
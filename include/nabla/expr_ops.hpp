@@ -0,0 +1,201 @@
+#ifndef NABLA_EXPR_OPS_HPP
+#define NABLA_EXPR_OPS_HPP
+
+#include <cmath>
+#include <type_traits>
+
+// Operations of expression nodes. Scalar operands are held by named
+// functors, not lambdas, so that the rewrites of elementwise_expr.hpp can
+// read them back, and fused multiply-adds get operations of their own.
+//
+// Contraction into std::fma only happens where the target has a fast fma
+// (FP_FAST_FMAF, FP_FAST_FMA, FP_FAST_FMAL), e.g. with -mfma, as the library
+// call is slow otherwise; defining NABLA_STRICT_FP turns it off. Scalar
+// constants of integer expressions are folded where that is exact, see
+// folds_sums and folds_products. Floating point constants are only folded
+// when NABLA_FAST_FP is defined, as the folded constant rounds and
+// overflows differently from the literal evaluation, e.g.
+// (a*1e300)*1e-300. Exact rewrites such as -(-a) -> a are always applied,
+// and operands are only swapped for arithmetic types.
+
+namespace nabla {
+namespace detail {
+
+#ifdef NABLA_STRICT_FP
+    inline constexpr bool strict_fp = true;
+#else
+    inline constexpr bool strict_fp = false;
+#endif
+
+#ifdef NABLA_FAST_FP
+    inline constexpr bool fast_fp = !strict_fp;
+#else
+    inline constexpr bool fast_fp = false;
+#endif
+
+    template <typename T>
+    inline constexpr bool has_fast_fma =
+#ifdef FP_FAST_FMAF
+        std::is_same_v<T, float> ||
+#endif
+#ifdef FP_FAST_FMA
+        std::is_same_v<T, double> ||
+#endif
+#ifdef FP_FAST_FMAL
+        std::is_same_v<T, long double> ||
+#endif
+        false;
+
+    // whether products and sums over T may be contracted into std::fma
+    template <typename T>
+    inline constexpr bool contracts_fma = !strict_fp && has_fast_fma<T>;
+
+    // whether the scalar constants of sums and differences over T may be
+    // folded. Signed integers are left alone, as x + (v + s) can overflow
+    // where (x + v) + s does not, and narrower integers are promoted by the
+    // operations.
+    template <typename T>
+    inline constexpr bool folds_sums =
+        (std::is_unsigned_v<T> && !std::is_same_v<T, bool> && sizeof(T) >= sizeof(int)) ||
+        (fast_fp && std::is_floating_point_v<T>);
+
+    // whether the scalar factors of products over T may be folded, and the
+    // divisors of quotients for floating point. x*(v*s) only overflows where
+    // (x*v)*s does.
+    template <typename T>
+    inline constexpr bool folds_products =
+        (std::is_integral_v<T> && !std::is_same_v<T, bool> && sizeof(T) >= sizeof(int)) ||
+        (fast_fp && std::is_floating_point_v<T>);
+
+    // whether x op s may be evaluated as s op x
+    template <typename T>
+    inline constexpr bool commutes = std::is_arithmetic_v<T>;
+
+    // Folded factor, wrapping for signed integers: a product by a factor
+    // that overflows is itself out of range unless x is 0
+    template <typename T>
+    constexpr T fold_multiplies(T a, T b) noexcept {
+        if constexpr (std::is_integral_v<T>) {
+            using U = std::make_unsigned_t<T>;
+            return static_cast<T>(static_cast<U>(a) * static_cast<U>(b));
+        } else {
+            return a * b;
+        }
+    }
+
+    //
+    // Operations with a scalar operand
+    //
+
+    // x + value
+    template <typename T>
+    struct scalar_plus {
+        T value;
+        constexpr auto operator()(auto x) const { return x + value; }
+    };
+
+    // x - value
+    template <typename T>
+    struct scalar_minus {
+        T value;
+        constexpr auto operator()(auto x) const { return x - value; }
+    };
+
+    // value + x
+    template <typename T>
+    struct scalar_plus_left {
+        T value;
+        constexpr auto operator()(auto x) const { return value + x; }
+    };
+
+    // value - x
+    template <typename T>
+    struct scalar_subtract_from {
+        T value;
+        constexpr auto operator()(auto x) const { return value - x; }
+    };
+
+    // x * value
+    template <typename T>
+    struct scalar_multiplies {
+        T value;
+        constexpr auto operator()(auto x) const { return x * value; }
+    };
+
+    // value * x
+    template <typename T>
+    struct scalar_multiplies_left {
+        T value;
+        constexpr auto operator()(auto x) const { return value * x; }
+    };
+
+    // x / value
+    template <typename T>
+    struct scalar_divides {
+        T value;
+        constexpr auto operator()(auto x) const { return x / value; }
+    };
+
+    // x % value
+    template <typename T>
+    struct scalar_modulus {
+        T value;
+        constexpr auto operator()(auto x) const { return x % value; }
+    };
+
+    struct identity_op {
+        constexpr auto operator()(auto x) const { return x; }
+    };
+
+    //
+    // Fused multiply-adds
+    //
+
+    // x*y + z
+    struct fused_multiply_add {
+        auto operator()(auto x, auto y, auto z) const { return std::fma(x, y, z); }
+    };
+
+    // x*y - z
+    struct fused_multiply_subtract {
+        auto operator()(auto x, auto y, auto z) const { return std::fma(x, y, -z); }
+    };
+
+    // z - x*y
+    struct fused_negate_multiply_add {
+        auto operator()(auto x, auto y, auto z) const { return std::fma(-x, y, z); }
+    };
+
+    // x*y + value
+    template <typename T>
+    struct fused_multiply_add_scalar {
+        T value;
+        auto operator()(auto x, auto y) const { return std::fma(x, y, value); }
+    };
+
+    // x*value + z
+    template <typename T>
+    struct scalar_fused_multiply_add {
+        T value;
+        auto operator()(auto x, auto z) const { return std::fma(x, value, z); }
+    };
+
+    // x*value - z
+    template <typename T>
+    struct scalar_fused_multiply_subtract {
+        T value;
+        auto operator()(auto x, auto z) const { return std::fma(x, value, -z); }
+    };
+
+    // x*factor + addend
+    template <typename T>
+    struct scalar_multiply_add {
+        T factor;
+        T addend;
+        auto operator()(auto x) const { return std::fma(x, factor, addend); }
+    };
+
+} // namespace detail
+} // namespace nabla
+
+#endif // NABLA_EXPR_OPS_HPP
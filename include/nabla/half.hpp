@@ -0,0 +1,371 @@
+#ifndef NABLA_HALF_HPP
+#define NABLA_HALF_HPP
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include "nabla/types.hpp"
+#include "nabla/concepts.hpp"
+#include "nabla/assign.hpp"
+#include "nabla/expr_evaluator.hpp"
+#include "nabla/tensor_span.hpp"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <immintrin.h>
+#define NABLA_HAS_F16C_DISPATCH 1
+#else
+#define NABLA_HAS_F16C_DISPATCH 0
+#endif
+
+// 16-bit floating point storage, for large fields that are stored at half
+// the size and computed on in float. float16 is IEEE binary16 (5 exponent,
+// 10 mantissa bits), bfloat16 keeps the 8 exponent bits of float and 7 of
+// its mantissa bits. Both widen to float exactly and are rounded to nearest
+// even from float, saturating to infinity.
+//
+// Tensors of either type are ordinary TensorArrays and TensorSpans.
+// Assignments between them and float tensors of the same layout run
+// vectorized bulk conversions, with F16C when the processor has it, checked
+// at run time, and a portable bit manipulation otherwise. as_float() views
+// the storage as float through converting_accessor, so that expressions
+// read and write 16-bit memory while computing in float:
+//
+//     nb::TensorArray<nb::float16, nb::dims<2>> h(nx, ny);
+//     h = field;                                      // bulk float -> float16
+//     auto x = nb::as_float(h);
+//     x = x * 0.5f + 1.0f;                            // float math, 16-bit traffic
+//
+// Expressions over the 16-bit arrays themselves also compute in float, but
+// their scalar operands are rounded to the storage type.
+
+namespace nabla {
+
+namespace detail {
+
+    // Exact widening of binary16 bits, branches that compile to selects
+    constexpr float half_to_float(std::uint16_t h) noexcept {
+        constexpr std::uint32_t shifted_exp = 0x7c00u << 13;
+        std::uint32_t o = (static_cast<std::uint32_t>(h) & 0x7fffu) << 13;
+        const std::uint32_t exp = shifted_exp & o;
+        o += (127u - 15u) << 23;
+        if (exp == shifted_exp) {
+            // infinity or NaN
+            o += (128u - 16u) << 23;
+        } else if (exp == 0) {
+            // zero or subnormal, renormalized by a float subtraction
+            o += 1u << 23;
+            o = std::bit_cast<std::uint32_t>(std::bit_cast<float>(o) - std::bit_cast<float>(113u << 23));
+        }
+        return std::bit_cast<float>(o | (static_cast<std::uint32_t>(h) & 0x8000u) << 16);
+    }
+
+    // Rounds to the nearest binary16, ties to even. NaNs become the quiet
+    // NaN 0x7e00 of the same sign.
+    constexpr std::uint16_t float_to_half(float x) noexcept {
+        constexpr std::uint32_t f32_infinity = 255u << 23;
+        constexpr std::uint32_t f16_overflow = (127u + 16u) << 23;
+        constexpr std::uint32_t denorm_magic = ((127u - 15u) + (23u - 10u) + 1u) << 23;
+        std::uint32_t f = std::bit_cast<std::uint32_t>(x);
+        const std::uint32_t sign = f & 0x80000000u;
+        f ^= sign;
+        std::uint32_t o;
+        if (f >= f16_overflow) {
+            o = f > f32_infinity ? 0x7e00u : 0x7c00u;
+        } else if (f < (113u << 23)) {
+            // subnormal results, rounded by the addition
+            o = std::bit_cast<std::uint32_t>(std::bit_cast<float>(f) + std::bit_cast<float>(denorm_magic)) - denorm_magic;
+        } else {
+            const std::uint32_t mantissa_odd = (f >> 13) & 1u;
+            f += ((15u - 127u) << 23) + 0xfffu;
+            f += mantissa_odd;
+            o = f >> 13;
+        }
+        return static_cast<std::uint16_t>(o | (sign >> 16));
+    }
+
+    constexpr float bfloat16_to_float(std::uint16_t b) noexcept {
+        return std::bit_cast<float>(static_cast<std::uint32_t>(b) << 16);
+    }
+
+    // Rounds to the nearest bfloat16, ties to even. NaNs stay NaN.
+    constexpr std::uint16_t float_to_bfloat16(float x) noexcept {
+        const std::uint32_t f = std::bit_cast<std::uint32_t>(x);
+        if ((f & 0x7fffffffu) > 0x7f800000u) {
+            return static_cast<std::uint16_t>((f >> 16) | 0x40u);
+        }
+        return static_cast<std::uint16_t>((f + 0x7fffu + ((f >> 16) & 1u)) >> 16);
+    }
+
+} // namespace detail
+
+struct float16 {
+    std::uint16_t bits = 0;
+
+    constexpr float16() noexcept = default;
+
+    constexpr float16(float x) noexcept
+        : bits(detail::float_to_half(x)) {}
+
+    constexpr operator float() const noexcept {
+        return detail::half_to_float(bits);
+    }
+
+    static constexpr float16 from_bits(std::uint16_t b) noexcept {
+        float16 h;
+        h.bits = b;
+        return h;
+    }
+};
+
+struct bfloat16 {
+    std::uint16_t bits = 0;
+
+    constexpr bfloat16() noexcept = default;
+
+    constexpr bfloat16(float x) noexcept
+        : bits(detail::float_to_bfloat16(x)) {}
+
+    constexpr operator float() const noexcept {
+        return detail::bfloat16_to_float(bits);
+    }
+
+    static constexpr bfloat16 from_bits(std::uint16_t b) noexcept {
+        bfloat16 h;
+        h.bits = b;
+        return h;
+    }
+};
+
+static_assert(sizeof(float16) == 2 && sizeof(bfloat16) == 2);
+
+namespace detail {
+
+    //
+    // Bulk conversions
+    //
+
+#if NABLA_HAS_F16C_DISPATCH
+    inline bool has_f16c() noexcept {
+        static const bool supported = __builtin_cpu_supports("avx") && __builtin_cpu_supports("f16c");
+        return supported;
+    }
+
+    __attribute__((target("avx,f16c")))
+    inline void f16c_widen(const float16* in, float* out, std::size_t n) noexcept {
+        std::size_t i = 0;
+        for (; i + 8 <= n; i += 8) {
+            _mm256_storeu_ps(out + i, _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i))));
+        }
+        for (; i < n; ++i) {
+            out[i] = half_to_float(in[i].bits);
+        }
+    }
+
+    __attribute__((target("avx,f16c")))
+    inline void f16c_narrow(const float* in, float16* out, std::size_t n) noexcept {
+        std::size_t i = 0;
+        for (; i + 8 <= n; i += 8) {
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm256_cvtps_ph(_mm256_loadu_ps(in + i), _MM_FROUND_TO_NEAREST_INT));
+        }
+        for (; i < n; ++i) {
+            out[i].bits = float_to_half(in[i]);
+        }
+    }
+#endif
+
+    template <>
+    struct bulk_converter<float, float16> : std::true_type {
+        static void convert(const float16* in, float* out, std::size_t n) noexcept {
+#if NABLA_HAS_F16C_DISPATCH
+            if (has_f16c()) {
+                f16c_widen(in, out, n);
+                return;
+            }
+#endif
+            for (std::size_t i = 0; i < n; ++i) {
+                out[i] = half_to_float(in[i].bits);
+            }
+        }
+    };
+
+    template <>
+    struct bulk_converter<float16, float> : std::true_type {
+        static void convert(const float* in, float16* out, std::size_t n) noexcept {
+#if NABLA_HAS_F16C_DISPATCH
+            if (has_f16c()) {
+                f16c_narrow(in, out, n);
+                return;
+            }
+#endif
+            for (std::size_t i = 0; i < n; ++i) {
+                out[i].bits = float_to_half(in[i]);
+            }
+        }
+    };
+
+    // bfloat16 needs no hardware support, its conversions vectorize as
+    // integer shifts and adds
+    template <>
+    struct bulk_converter<float, bfloat16> : std::true_type {
+        static void convert(const bfloat16* in, float* out, std::size_t n) noexcept {
+            for (std::size_t i = 0; i < n; ++i) {
+                out[i] = bfloat16_to_float(in[i].bits);
+            }
+        }
+    };
+
+    template <>
+    struct bulk_converter<bfloat16, float> : std::true_type {
+        static void convert(const float* in, bfloat16* out, std::size_t n) noexcept {
+            for (std::size_t i = 0; i < n; ++i) {
+                out[i].bits = float_to_bfloat16(in[i]);
+            }
+        }
+    };
+
+    // Conversions of converting_accessor for the evaluator, see
+    // HasRowDecoder and HasEncoder
+    template <typename T, typename S>
+    struct storage_decoder {
+        T operator()(S s, std::ptrdiff_t) const noexcept { return static_cast<T>(s); }
+    };
+
+    template <typename T, typename S>
+    struct storage_encoder {
+        S operator()(T x) const noexcept { return S(x); }
+    };
+
+} // namespace detail
+
+template <typename T, typename S>
+class converting_accessor;
+
+// Proxy reference to an element of a writable converting tensor
+template <typename T, typename S>
+class converting_reference {
+    S* _s;
+
+    public:
+        constexpr explicit converting_reference(S* s) noexcept
+            : _s(s) {}
+
+        constexpr converting_reference(const converting_reference&) = default;
+
+        constexpr operator T() const noexcept { return static_cast<T>(*_s); }
+
+        constexpr const converting_reference& operator=(const T& value) const noexcept {
+            *_s = S(value);
+            return *this;
+        }
+
+        constexpr const converting_reference& operator=(const converting_reference& other) const noexcept {
+            return *this = static_cast<T>(other);
+        }
+
+        constexpr const converting_reference& operator+=(const T& value) const noexcept { return *this = static_cast<T>(*this) + value; }
+        constexpr const converting_reference& operator-=(const T& value) const noexcept { return *this = static_cast<T>(*this) - value; }
+        constexpr const converting_reference& operator*=(const T& value) const noexcept { return *this = static_cast<T>(*this) * value; }
+        constexpr const converting_reference& operator/=(const T& value) const noexcept { return *this = static_cast<T>(*this) / value; }
+};
+
+// Accessor that reads elements of type T from storage of type S, converting
+// on access, and writes them back converted to S. The data handle is a
+// plain pointer to the storage.
+template <typename T, typename S>
+class converting_accessor<const T, S> {
+    public:
+        using element_type = const T;
+        using reference = T;
+        using data_handle_type = S*;
+        using offset_policy = converting_accessor;
+        using read_accessor_type = converting_accessor;
+        using write_accessor_type = converting_accessor<T, S>;
+        using storage_type = S;
+
+        constexpr converting_accessor() noexcept = default;
+
+        constexpr reference access(data_handle_type p, std::size_t i) const noexcept {
+            return static_cast<T>(p[i]);
+        }
+
+        constexpr data_handle_type offset(data_handle_type p, std::size_t i) const noexcept {
+            return p + i;
+        }
+
+        constexpr write_accessor_type to_write() const noexcept;
+
+        // Decoding in the evaluator, see detail::HasRowDecoder
+        constexpr S* storage_pointer(data_handle_type p) const noexcept {
+            return p;
+        }
+
+        constexpr detail::storage_decoder<T, S> row_decoder(data_handle_type, std::size_t, std::ptrdiff_t) const noexcept {
+            return {};
+        }
+};
+
+template <typename T, typename S>
+class converting_accessor : public converting_accessor<const T, S> {
+    public:
+        using element_type = T;
+        using reference = converting_reference<T, S>;
+        using data_handle_type = S*;
+        using offset_policy = converting_accessor;
+        using read_accessor_type = converting_accessor<const T, S>;
+        using write_accessor_type = converting_accessor;
+
+        constexpr converting_accessor() noexcept = default;
+
+        constexpr reference access(data_handle_type p, std::size_t i) const noexcept {
+            return reference(p + i);
+        }
+
+        constexpr data_handle_type offset(data_handle_type p, std::size_t i) const noexcept {
+            return p + i;
+        }
+
+        constexpr write_accessor_type to_write() const noexcept {
+            return {};
+        }
+
+        // Encoding in the evaluator, see detail::HasEncoder
+        constexpr detail::storage_encoder<T, S> encoder() const noexcept {
+            return {};
+        }
+};
+
+template <typename T, typename S>
+constexpr converting_accessor<T, S> converting_accessor<const T, S>::to_write() const noexcept {
+    return {};
+}
+
+namespace detail {
+
+    template <typename T>
+    inline constexpr bool is_half_type = std::is_same_v<T, float16> || std::is_same_v<T, bfloat16>;
+
+} // namespace detail
+
+// View of a float16 or bfloat16 tensor as float, writable when x is
+template <typename X>
+    requires (IsTensorArray<X> || IsTensorSpan<X>) && detail::IsPointerBacked<X> &&
+             detail::is_half_type<typename std::remove_cvref_t<X>::value_type>
+auto as_float(X&& x) {
+    using tensor_type = std::remove_cvref_t<X>;
+    using S = typename tensor_type::value_type;
+    using extents_type = typename tensor_type::extents_type;
+    using layout_type = typename tensor_type::layout_type;
+    auto* p = detail::data_pointer(x);
+    if constexpr (std::is_const_v<std::remove_pointer_t<decltype(p)>>) {
+        using span_type = TensorSpan<const float, extents_type, layout_type, converting_accessor<const float, S>>;
+        return span_type(const_cast<S*>(p), x.mapping());
+    } else {
+        using span_type = TensorSpan<float, extents_type, layout_type, converting_accessor<float, S>>;
+        return span_type(p, x.mapping());
+    }
+}
+
+} // namespace nabla
+
+#endif // NABLA_HALF_HPP
@@ -0,0 +1,626 @@
+#ifndef NABLA_IO_HPP
+#define NABLA_IO_HPP
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <sstream>
+#include <stacktrace>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <vector>
+#include "nabla/types.hpp"
+#include "nabla/concepts.hpp"
+#include "nabla/dtype.hpp"
+#include "nabla/expr_evaluator.hpp"
+#include "nabla/parallel.hpp"
+
+#if __has_include(<fcntl.h>) && __has_include(<unistd.h>)
+#include <fcntl.h>
+#include <unistd.h>
+#define NABLA_HAS_PIO 1
+#else
+#include <fstream>
+#define NABLA_HAS_PIO 0
+#endif
+
+// Native binary tensor files, for checkpoints of large tensors, e.g.
+//
+//     nb::write_tensor(nb::par, "u.nbt", u);
+//     nb::read_tensor(nb::par, "u.nbt", u);
+//     auto v = nb::read_tensor<nb::TensorArray<double, nb::dims<3>>>(nb::par, "u.nbt");
+//
+// A file is a 64 byte header (magic, version, byte order, dtype, rank, chunk
+// size, data offset, checksum), the extents and strides, and the elements
+// packed in the order of the written tensor's strides from a page-aligned
+// offset. The data is split into chunks that are read and written with
+// pread/pwrite, in parallel under nb::par, each checksummed on its own so
+// the checksum is computed alongside the I/O. Tensors are gathered from and
+// scattered to memory by contiguous runs, a bulk copy each when the tensor is
+// pointer-backed, and packed tensors in the file's order skip the staging
+// buffer entirely. The header is written last, so an interrupted write
+// leaves a file that fails to open.
+
+namespace nabla {
+namespace detail {
+
+    [[noreturn]] inline void throw_io_error(int error, const std::filesystem::path& path, const char* what) {
+        std::stringstream ss;
+        ss << "nabla tensor file error: " << what << " of " << path << " failed"
+            << "\n\n"
+            << std::stacktrace::current() << std::endl;
+        throw std::system_error(error, std::generic_category(), ss.str());
+    }
+
+    [[noreturn]] inline void throw_tensor_file_error(const std::filesystem::path& path, const std::string& what) {
+        std::stringstream ss;
+        ss << "nabla tensor file error: " << path << ": " << what
+            << "\n\n"
+            << std::stacktrace::current() << std::endl;
+        throw std::invalid_argument(ss.str());
+    }
+
+    //
+    // File access by offset
+    //
+
+    enum class file_mode {
+        read,   // existing file, read only
+        write,  // created or truncated, write only
+        update, // existing file, read and write
+    };
+
+#if NABLA_HAS_PIO
+    // A file read and written at explicit offsets, safe to share between threads
+    class binary_file {
+        int _fd = -1;
+        std::filesystem::path _path;
+
+        public:
+            binary_file(const std::filesystem::path& path, file_mode mode) : _path(path) {
+                switch (mode) {
+                    case file_mode::read: _fd = ::open(path.c_str(), O_RDONLY); break;
+                    case file_mode::write: _fd = ::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0666); break;
+                    case file_mode::update: _fd = ::open(path.c_str(), O_RDWR); break;
+                }
+                if (_fd < 0) {
+                    throw_io_error(errno, path, "open");
+                }
+            }
+
+            binary_file(const binary_file&) = delete;
+            binary_file& operator=(const binary_file&) = delete;
+
+            ~binary_file() { ::close(_fd); }
+
+            void write_at(const void* data, std::size_t n, std::uint64_t offset) const {
+                const auto* p = static_cast<const char*>(data);
+                while (n > 0) {
+                    const ::ssize_t k = ::pwrite(_fd, p, n, static_cast<::off_t>(offset));
+                    if (k < 0) {
+                        if (errno == EINTR) {
+                            continue;
+                        }
+                        throw_io_error(errno, _path, "pwrite");
+                    }
+                    p += k;
+                    n -= static_cast<std::size_t>(k);
+                    offset += static_cast<std::uint64_t>(k);
+                }
+            }
+
+            void read_at(void* data, std::size_t n, std::uint64_t offset) const {
+                auto* p = static_cast<char*>(data);
+                while (n > 0) {
+                    const ::ssize_t k = ::pread(_fd, p, n, static_cast<::off_t>(offset));
+                    if (k < 0) {
+                        if (errno == EINTR) {
+                            continue;
+                        }
+                        throw_io_error(errno, _path, "pread");
+                    }
+                    if (k == 0) {
+                        throw_tensor_file_error(_path, "file is truncated");
+                    }
+                    p += k;
+                    n -= static_cast<std::size_t>(k);
+                    offset += static_cast<std::uint64_t>(k);
+                }
+            }
+    };
+#else
+    // Without pread/pwrite, accesses to the stream are serialized
+    class binary_file {
+        mutable std::fstream _stream;
+        mutable std::mutex _mutex;
+        std::filesystem::path _path;
+
+        public:
+            binary_file(const std::filesystem::path& path, file_mode mode)
+                : _stream(path, std::ios::binary | (mode == file_mode::read ? std::ios::in :
+                                                    mode == file_mode::write ? std::ios::out | std::ios::trunc :
+                                                    std::ios::in | std::ios::out)),
+                  _path(path) {
+                    if (!_stream) {
+                        throw_io_error(ENOENT, path, "open");
+                    }
+                }
+
+            void write_at(const void* data, std::size_t n, std::uint64_t offset) const {
+                std::lock_guard lock(_mutex);
+                _stream.seekp(static_cast<std::streamoff>(offset));
+                if (!_stream.write(static_cast<const char*>(data), static_cast<std::streamsize>(n))) {
+                    throw_io_error(EIO, _path, "write");
+                }
+            }
+
+            void read_at(void* data, std::size_t n, std::uint64_t offset) const {
+                std::lock_guard lock(_mutex);
+                _stream.seekg(static_cast<std::streamoff>(offset));
+                if (!_stream.read(static_cast<char*>(data), static_cast<std::streamsize>(n))) {
+                    throw_tensor_file_error(_path, "file is truncated");
+                }
+            }
+    };
+#endif
+
+    //
+    // Checksum
+    //
+
+    // 64-bit hash of a byte range over four independent lanes, so that it
+    // keeps up with memory bandwidth
+    inline std::uint64_t checksum64(const std::byte* data, std::size_t n, std::uint64_t seed = 0) noexcept {
+        constexpr std::uint64_t k1 = 0x9e3779b185ebca87ull;
+        constexpr std::uint64_t k2 = 0xc2b2ae3d27d4eb4full;
+        auto round = [](std::uint64_t h, std::uint64_t w) {
+            return std::rotl(h + w * k2, 31) * k1;
+        };
+        auto load = [](const std::byte* p) {
+            std::uint64_t w;
+            std::memcpy(&w, p, sizeof(w));
+            return w;
+        };
+        std::uint64_t h[4] = {seed + k1 + k2, seed + k2, seed, seed - k1};
+        std::size_t i = 0;
+        for (; i + 32 <= n; i += 32) {
+            for (int l = 0; l < 4; ++l) {
+                h[l] = round(h[l], load(data + i + 8*l));
+            }
+        }
+        std::uint64_t r = std::rotl(h[0], 1) + std::rotl(h[1], 7) + std::rotl(h[2], 12) + std::rotl(h[3], 18);
+        for (; i + 8 <= n; i += 8) {
+            r = round(r, load(data + i));
+        }
+        for (; i < n; ++i) {
+            r = round(r, static_cast<std::uint64_t>(data[i]));
+        }
+        r ^= n;
+        r ^= r >> 33;
+        r *= k2;
+        r ^= r >> 29;
+        return r;
+    }
+
+    //
+    // File layout
+    //
+
+    struct tensor_file_header {
+        char magic[8];              // "\x93NABLA\r\n"
+        std::uint32_t version;
+        std::uint32_t byte_order;   // tensor_file_byte_order as written
+        char dtype[8];              // npy descr of the elements, e.g. "<f8"
+        std::uint64_t element_size;
+        std::uint64_t rank;
+        std::uint64_t chunk_size;   // bytes of data per checksummed chunk
+        std::uint64_t data_offset;
+        std::uint64_t checksum;     // of the chunk checksums in order
+    };
+    static_assert(sizeof(tensor_file_header) == 64 && std::is_trivially_copyable_v<tensor_file_header>);
+
+    inline constexpr char tensor_file_magic[8] = {'\x93', 'N', 'A', 'B', 'L', 'A', '\r', '\n'};
+    inline constexpr std::uint32_t tensor_file_version = 1;
+    inline constexpr std::uint32_t tensor_file_byte_order = 0x01020304;
+    inline constexpr std::uint64_t tensor_file_alignment = 4096;
+    // large enough to stream at disk bandwidth, small enough to spread
+    // checkpoints of a few hundred megabytes over every thread
+    inline constexpr std::size_t tensor_file_chunk_size = std::size_t(1) << 22;
+
+    // Dimensions by increasing stride, the order in which a tensor's elements
+    // are packed into the file
+    template <typename SpanT>
+    std::array<std::size_t, SpanT::rank()> storage_order(const SpanT& t) {
+        std::array<std::size_t, SpanT::rank()> order;
+        std::iota(order.begin(), order.end(), std::size_t(0));
+        std::stable_sort(order.begin(), order.end(), [&](std::size_t a, std::size_t b) { return t.stride(a) < t.stride(b); });
+        return order;
+    }
+
+    // Strides of the elements of `exts` packed in `order`
+    template <typename Extents>
+    std::array<std::uint64_t, Extents::rank()> packed_strides(const Extents& exts, const std::array<std::size_t, Extents::rank()>& order) {
+        std::array<std::uint64_t, Extents::rank()> strides;
+        std::uint64_t stride = 1;
+        for (std::size_t k = 0; k < order.size(); ++k) {
+            strides[order[k]] = stride;
+            stride *= std::max<std::uint64_t>(exts.extent(order[k]), 1);
+        }
+        return strides;
+    }
+
+    // whether element i of the file is element i of t's memory
+    template <typename SpanT>
+    bool has_file_strides(const SpanT& t, const std::array<std::uint64_t, SpanT::rank()>& strides) {
+        if constexpr (!IsPointerBacked<SpanT>) {
+            return false;
+        } else {
+            for (std::size_t r = 0; r < SpanT::rank(); ++r) {
+                if (t.extent(r) > 1 && static_cast<std::uint64_t>(t.stride(r)) != strides[r]) {
+                    return false;
+                }
+            }
+            return true;
+        }
+    }
+
+    // Calls f(position, offset, length, stride) for the runs of file elements
+    // [begin, end) of t packed in `order`, a run being consecutive elements
+    // along the dimension order[0]. Position counts elements in the file,
+    // offset and stride are in elements of t's mapping.
+    template <typename SpanT, typename F>
+    void for_each_run(const SpanT& t, const std::array<std::size_t, SpanT::rank()>& order,
+                      std::size_t begin, std::size_t end, F&& f) {
+        constexpr std::size_t rank = SpanT::rank();
+        if constexpr (rank == 0) {
+            if (begin < end) {
+                f(begin, std::size_t(0), std::size_t(1), std::size_t(0));
+            }
+        } else {
+            std::array<std::size_t, rank> idx;
+            std::size_t rest = begin;
+            for (std::size_t k = 0; k < rank; ++k) {
+                const std::size_t n = static_cast<std::size_t>(t.extent(order[k]));
+                idx[order[k]] = rest % n;
+                rest /= n;
+            }
+            const std::size_t r0 = order[0];
+            const std::size_t n0 = static_cast<std::size_t>(t.extent(r0));
+            const std::size_t stride0 = static_cast<std::size_t>(t.stride(r0));
+            for (std::size_t pos = begin; pos < end;) {
+                const std::size_t len = std::min(n0 - idx[r0], end - pos);
+                std::size_t offset = 0;
+                for (std::size_t r = 0; r < rank; ++r) {
+                    offset += idx[r] * static_cast<std::size_t>(t.stride(r));
+                }
+                f(pos, offset, len, stride0);
+                pos += len;
+                idx[r0] += len;
+                for (std::size_t k = 0; k < rank && idx[order[k]] == static_cast<std::size_t>(t.extent(order[k])); ++k) {
+                    idx[order[k]] = 0;
+                    if (k + 1 < rank) {
+                        ++idx[order[k + 1]];
+                    }
+                }
+            }
+        }
+    }
+
+    // Copies file elements [begin, end) of t into `out`
+    template <typename SpanT>
+    void gather(const SpanT& t, const std::array<std::size_t, SpanT::rank()>& order,
+                std::size_t begin, std::size_t end, std::remove_const_t<typename SpanT::element_type>* out) {
+        for_each_run(t, order, begin, end, [&](std::size_t pos, std::size_t offset, std::size_t len, std::size_t stride) {
+            auto* dst = out + (pos - begin);
+            if constexpr (IsPointerBacked<SpanT>) {
+                const auto* src = data_pointer(t) + offset;
+                if (stride == 1) {
+                    std::memcpy(dst, src, len * sizeof(*dst));
+                } else {
+                    for (std::size_t j = 0; j < len; ++j) {
+                        dst[j] = src[j * stride];
+                    }
+                }
+            } else {
+                for (std::size_t j = 0; j < len; ++j) {
+                    dst[j] = t.accessor().access(t.data_handle(), offset + j * stride);
+                }
+            }
+        });
+    }
+
+    // Copies `in` into file elements [begin, end) of t
+    template <typename SpanT>
+    void scatter(const SpanT& t, const std::array<std::size_t, SpanT::rank()>& order,
+                 std::size_t begin, std::size_t end, const typename SpanT::value_type* in) {
+        for_each_run(t, order, begin, end, [&](std::size_t pos, std::size_t offset, std::size_t len, std::size_t stride) {
+            const auto* src = in + (pos - begin);
+            if constexpr (IsPointerBacked<SpanT>) {
+                auto* dst = data_pointer(t) + offset;
+                if (stride == 1) {
+                    std::memcpy(dst, src, len * sizeof(*src));
+                } else {
+                    for (std::size_t j = 0; j < len; ++j) {
+                        dst[j * stride] = src[j];
+                    }
+                }
+            } else {
+                for (std::size_t j = 0; j < len; ++j) {
+                    t.accessor().access(t.data_handle(), offset + j * stride) = src[j];
+                }
+            }
+        });
+    }
+
+    // Runs f(chunk) over [0, num_chunks), each chunk on one thread
+    template <typename Policy, typename F>
+    void for_each_chunk(const Policy& policy, std::size_t num_chunks, F&& f) {
+        if constexpr (std::is_same_v<Policy, parallel_policy>) {
+            parallel_for(policy.with_serial_cutoff(0), num_chunks, 1, [&](std::size_t begin, std::size_t end) {
+                for (std::size_t c = begin; c < end; ++c) {
+                    f(c);
+                }
+            });
+        } else {
+            for (std::size_t c = 0; c < num_chunks; ++c) {
+                f(c);
+            }
+        }
+    }
+
+    inline std::uint64_t combine_checksums(const std::vector<std::uint64_t>& checksums) noexcept {
+        return checksum64(reinterpret_cast<const std::byte*>(checksums.data()), checksums.size() * sizeof(std::uint64_t));
+    }
+
+    template <typename T>
+    auto as_span(T& t) {
+        if constexpr (IsTensorArray<T>) {
+            return t.to_span();
+        } else {
+            return t;
+        }
+    }
+
+    template <typename Policy, typename SpanT>
+    void write_tensor_file(const Policy& policy, const std::filesystem::path& path, const SpanT& t) {
+        using T = std::remove_const_t<typename SpanT::element_type>;
+        constexpr std::size_t rank = SpanT::rank();
+
+        const auto order = storage_order(t);
+        const auto strides = packed_strides(t.extents(), order);
+        std::size_t size = 1;
+        for (std::size_t r = 0; r < rank; ++r) {
+            size *= static_cast<std::size_t>(t.extent(r));
+        }
+
+        tensor_file_header header{};
+        std::memcpy(header.magic, tensor_file_magic, sizeof(header.magic));
+        header.version = tensor_file_version;
+        header.byte_order = tensor_file_byte_order;
+        const std::string descr = npy_descr<T>();
+        std::memcpy(header.dtype, descr.data(), std::min(descr.size(), sizeof(header.dtype)));
+        header.element_size = sizeof(T);
+        header.rank = rank;
+        header.chunk_size = tensor_file_chunk_size / sizeof(T) * sizeof(T);
+        const std::uint64_t meta_size = sizeof(header) + 2 * rank * sizeof(std::uint64_t);
+        header.data_offset = (meta_size + tensor_file_alignment - 1) / tensor_file_alignment * tensor_file_alignment;
+
+        binary_file file(path, file_mode::write);
+        const std::size_t chunk_elements = header.chunk_size / sizeof(T);
+        const std::size_t num_chunks = (size + chunk_elements - 1) / chunk_elements;
+        std::vector<std::uint64_t> checksums(num_chunks);
+        const bool direct = has_file_strides(t, strides);
+        for_each_chunk(policy, num_chunks, [&](std::size_t c) {
+            const std::size_t begin = c * chunk_elements;
+            const std::size_t end = std::min(begin + chunk_elements, size);
+            const std::byte* bytes = nullptr;
+            std::unique_ptr<T[]> buffer;
+            if constexpr (IsPointerBacked<SpanT>) {
+                if (direct) {
+                    bytes = reinterpret_cast<const std::byte*>(data_pointer(t) + begin);
+                }
+            }
+            if (bytes == nullptr) {
+                buffer.reset(new T[end - begin]);
+                gather(t, order, begin, end, buffer.get());
+                bytes = reinterpret_cast<const std::byte*>(buffer.get());
+            }
+            const std::size_t n = (end - begin) * sizeof(T);
+            checksums[c] = checksum64(bytes, n);
+            file.write_at(bytes, n, header.data_offset + begin * sizeof(T));
+        });
+        header.checksum = combine_checksums(checksums);
+
+        // the header, extents and strides, built in a buffer of fixed size
+        constexpr std::size_t words = rank * sizeof(std::uint64_t);
+        std::array<std::byte, sizeof(header) + 2 * words> record;
+        std::memcpy(record.data(), &header, sizeof(header));
+        if constexpr (rank > 0) {
+            std::array<std::uint64_t, rank> extents;
+            for (std::size_t r = 0; r < rank; ++r) {
+                extents[r] = static_cast<std::uint64_t>(t.extent(r));
+            }
+            std::memcpy(record.data() + sizeof(header), extents.data(), words);
+            std::memcpy(record.data() + sizeof(header) + words, strides.data(), words);
+        }
+        std::vector<std::byte> meta(header.data_offset);
+        std::copy(record.begin(), record.end(), meta.begin());
+        file.write_at(meta.data(), meta.size(), 0);
+    }
+
+    // The header, extents and strides of a tensor file holding T of rank Rank
+    template <typename T, std::size_t Rank>
+    struct tensor_file_info {
+        tensor_file_header header;
+        std::array<std::uint64_t, Rank> extents;
+        std::array<std::uint64_t, Rank> strides;
+        std::array<std::size_t, Rank> order;
+    };
+
+    template <typename T, std::size_t Rank>
+    tensor_file_info<T, Rank> read_tensor_file_info(const binary_file& file, const std::filesystem::path& path) {
+        tensor_file_info<T, Rank> info;
+        tensor_file_header& header = info.header;
+        file.read_at(&header, sizeof(header), 0);
+        if (std::memcmp(header.magic, tensor_file_magic, sizeof(header.magic)) != 0) {
+            throw_tensor_file_error(path, "not a tensor file");
+        }
+        if (header.version != tensor_file_version) {
+            throw_tensor_file_error(path, "unsupported version " + std::to_string(header.version));
+        }
+        if (header.byte_order != tensor_file_byte_order) {
+            throw_tensor_file_error(path, "file was written with a different byte order");
+        }
+        const std::string descr(header.dtype, std::find(header.dtype, header.dtype + sizeof(header.dtype), '\0'));
+        if (!npy_descr_matches<T>(descr) || header.element_size != sizeof(T)) {
+            throw_tensor_file_error(path, "dtype '" + descr + "' does not match the element type");
+        }
+        if (header.rank != Rank) {
+            throw_tensor_file_error(path, "rank " + std::to_string(header.rank) + " does not match " + std::to_string(Rank));
+        }
+        if (header.chunk_size == 0 || header.chunk_size % sizeof(T) != 0 || header.data_offset < sizeof(header) + 2 * Rank * sizeof(std::uint64_t)) {
+            throw_tensor_file_error(path, "corrupt header");
+        }
+        std::array<std::uint64_t, 2 * Rank> meta{};
+        if constexpr (Rank > 0) {
+            file.read_at(meta.data(), sizeof(meta), sizeof(header));
+        }
+        std::copy_n(meta.begin(), Rank, info.extents.begin());
+        std::copy_n(meta.begin() + Rank, Rank, info.strides.begin());
+
+        // the strides must pack the extents in some order
+        std::iota(info.order.begin(), info.order.end(), std::size_t(0));
+        std::stable_sort(info.order.begin(), info.order.end(), [&](std::size_t a, std::size_t b) { return info.strides[a] < info.strides[b]; });
+        std::uint64_t stride = 1;
+        for (std::size_t k = 0; k < Rank; ++k) {
+            const std::size_t r = info.order[k];
+            if (info.extents[r] > 1 && info.strides[r] != stride) {
+                throw_tensor_file_error(path, "strides do not describe packed data");
+            }
+            stride *= std::max<std::uint64_t>(info.extents[r], 1);
+        }
+        return info;
+    }
+
+    template <typename Policy, typename SpanT, typename Info>
+    void read_tensor_data(const Policy& policy, const binary_file& file, const std::filesystem::path& path, const Info& info, const SpanT& t) {
+        using T = typename SpanT::value_type;
+        constexpr std::size_t rank = SpanT::rank();
+
+        std::size_t size = 1;
+        for (std::size_t r = 0; r < rank; ++r) {
+            if (static_cast<std::uint64_t>(t.extent(r)) != info.extents[r]) {
+                std::stringstream ss;
+                ss << "extent " << r << " is " << info.extents[r] << ", the tensor's is " << t.extent(r);
+                throw_tensor_file_error(path, ss.str());
+            }
+            size *= static_cast<std::size_t>(t.extent(r));
+        }
+
+        const std::size_t chunk_elements = info.header.chunk_size / sizeof(T);
+        const std::size_t num_chunks = (size + chunk_elements - 1) / chunk_elements;
+        std::vector<std::uint64_t> checksums(num_chunks);
+        const bool direct = has_file_strides(t, info.strides);
+        for_each_chunk(policy, num_chunks, [&](std::size_t c) {
+            const std::size_t begin = c * chunk_elements;
+            const std::size_t end = std::min(begin + chunk_elements, size);
+            const std::size_t n = (end - begin) * sizeof(T);
+            if constexpr (IsPointerBacked<SpanT>) {
+                if (direct) {
+                    T* p = data_pointer(t) + begin;
+                    file.read_at(p, n, info.header.data_offset + begin * sizeof(T));
+                    checksums[c] = checksum64(reinterpret_cast<const std::byte*>(p), n);
+                    return;
+                }
+            }
+            std::unique_ptr<T[]> buffer(new T[end - begin]);
+            file.read_at(buffer.get(), n, info.header.data_offset + begin * sizeof(T));
+            checksums[c] = checksum64(reinterpret_cast<const std::byte*>(buffer.get()), n);
+            scatter(t, info.order, begin, end, buffer.get());
+        });
+        if (combine_checksums(checksums) != info.header.checksum) {
+            throw_tensor_file_error(path, "checksum mismatch");
+        }
+    }
+
+} // namespace detail
+
+// Writes t to a tensor file at `path`, replacing it. Under nb::par the
+// chunks of the file are gathered, checksummed and written by the pool.
+template <typename Policy, typename T>
+    requires IsExecutionPolicy<Policy> && (IsTensorSpan<T> || IsTensorArray<T>) &&
+             std::is_trivially_copyable_v<typename std::remove_cvref_t<T>::value_type>
+void write_tensor(const Policy& policy, const std::filesystem::path& path, const T& t) {
+    detail::write_tensor_file(policy, path, detail::as_span(t));
+}
+
+template <typename T>
+    requires (IsTensorSpan<T> || IsTensorArray<T>) && std::is_trivially_copyable_v<typename std::remove_cvref_t<T>::value_type>
+void write_tensor(const std::filesystem::path& path, const T& t) {
+    write_tensor(seq, path, t);
+}
+
+// Reads the tensor file at `path` into dst, whose extents must be those of
+// the file. Throws std::invalid_argument for a file of another type or
+// shape, and for a checksum mismatch, in which case dst holds the file's
+// possibly corrupt data.
+template <typename Policy, typename Dst>
+    requires IsExecutionPolicy<Policy> && (IsTensorSpan<Dst> || IsTensorArray<Dst>) &&
+             std::is_trivially_copyable_v<typename std::remove_cvref_t<Dst>::value_type>
+void read_tensor(const Policy& policy, const std::filesystem::path& path, Dst&& dst) {
+    using dst_type = std::remove_cvref_t<Dst>;
+    using T = typename dst_type::value_type;
+    detail::binary_file file(path, detail::file_mode::read);
+    const auto info = detail::read_tensor_file_info<T, dst_type::rank()>(file, path);
+    detail::read_tensor_data(policy, file, path, info, detail::as_span(dst));
+}
+
+template <typename Dst>
+    requires (IsTensorSpan<Dst> || IsTensorArray<Dst>) && std::is_trivially_copyable_v<typename std::remove_cvref_t<Dst>::value_type>
+void read_tensor(const std::filesystem::path& path, Dst&& dst) {
+    read_tensor(seq, path, std::forward<Dst>(dst));
+}
+
+// Reads the tensor file at `path` into a new ArrayT of the file's extents
+template <typename ArrayT, typename Policy>
+    requires IsTensorArray<ArrayT> && IsExecutionPolicy<Policy> && std::is_trivially_copyable_v<typename ArrayT::value_type>
+ArrayT read_tensor(const Policy& policy, const std::filesystem::path& path) {
+    using T = typename ArrayT::value_type;
+    using extents_type = typename ArrayT::extents_type;
+    constexpr std::size_t rank = ArrayT::rank();
+    detail::binary_file file(path, detail::file_mode::read);
+    const auto info = detail::read_tensor_file_info<T, rank>(file, path);
+    std::array<typename ArrayT::index_type, rank> exts;
+    for (std::size_t r = 0; r < rank; ++r) {
+        if (extents_type::static_extent(r) != std::dynamic_extent && extents_type::static_extent(r) != info.extents[r]) {
+            std::stringstream ss;
+            ss << "extent " << r << " is " << info.extents[r] << ", the static extent is " << extents_type::static_extent(r);
+            detail::throw_tensor_file_error(path, ss.str());
+        }
+        exts[r] = static_cast<typename ArrayT::index_type>(info.extents[r]);
+    }
+    const extents_type e(exts);
+    ArrayT a(e);
+    detail::read_tensor_data(policy, file, path, info, a.to_span());
+    return a;
+}
+
+template <typename ArrayT>
+    requires IsTensorArray<ArrayT> && std::is_trivially_copyable_v<typename ArrayT::value_type>
+ArrayT read_tensor(const std::filesystem::path& path) {
+    return read_tensor<ArrayT>(seq, path);
+}
+
+} // namespace nabla
+
+#endif // NABLA_IO_HPP
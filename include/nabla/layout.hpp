@@ -2,5 +2,7 @@
 #define NABLA_LAYOUT_HPP
 
 #include "nabla/layout/left_stride.hpp"
+#include "nabla/layout/left_broadcast.hpp"
+#include "nabla/layout/right_stride.hpp"
 
 #endif // NABLA_LAYOUT_HPP
@@ -0,0 +1,176 @@
+#ifndef NABLA_LAYOUT_LEFT_BROADCAST_HPP
+#define NABLA_LAYOUT_LEFT_BROADCAST_HPP
+
+#include <algorithm>
+#include <array>
+#include <sstream>
+#include <stacktrace>
+#include <stdexcept>
+#include "nabla/concepts.hpp"
+#include "nabla/layout/left_iterator.hpp"
+
+namespace nabla {
+
+// Strided layout that admits zero strides. A zero stride repeats a single
+// element along its dimension, so a mapping with a zero stride on a dimension
+// of extent > 1 is not unique. It backs read-only broadcast views, where a
+// size-1 dimension is stretched without copying. Since the views are never
+// written through, strides may come in any order, e.g. from a RightStride
+// tensor; iteration is always left-major.
+struct LeftBroadcast {
+    template <typename Extents>
+    class mapping {
+        //
+        // Member types
+        //
+        public:
+            using mapping_tag = void; // for concept IsMapping
+            using layout_type = LeftBroadcast;
+            using extents_type = Extents;
+            using index_type = typename extents_type::index_type;
+            using size_type = typename extents_type::size_type;
+            using rank_type = typename extents_type::rank_type;
+            using coord_type = std::array<index_type, extents_type::rank()>;
+            using iterator_type = LeftIterator<mapping>;
+
+        //
+        // Data members
+        //
+        private:
+            extents_type _extents{};
+            coord_type _strides{};
+
+        //
+        // Helpers
+        //
+        private:
+            constexpr void _assert_constructor() const;
+
+        //
+        // Constructors
+        //
+        public:
+            constexpr mapping() = default;
+            constexpr mapping(const mapping&) = default;
+            constexpr mapping(mapping&&) = default;
+            constexpr mapping& operator=(const mapping&) = default;
+            constexpr mapping& operator=(mapping&&) = default;
+
+            template<typename OtherExtents>
+                requires IsExtents<OtherExtents>
+            constexpr mapping(const OtherExtents& exts, const coord_type& strides)
+                : _extents(exts), _strides(strides) {
+                    _assert_constructor();
+                }
+
+            constexpr mapping(const coord_type& exts, const coord_type& strides)
+                : mapping(extents_type(exts), strides) {}
+
+            // the same view through a broadcast-capable mapping
+            template <typename OtherMapping>
+                requires IsMapping<OtherMapping> && (OtherMapping::extents_type::rank() == extents_type::rank())
+            explicit constexpr mapping(const OtherMapping& other)
+                : _extents(other.extents()) {
+                    for (rank_type r = 0; r < extents_type::rank(); ++r) {
+                        _strides[r] = static_cast<index_type>(other.stride(r));
+                    }
+                    _assert_constructor();
+                }
+
+        //
+        // Observers
+        //
+        public:
+            constexpr const extents_type& extents() const noexcept { return _extents; }
+            constexpr const coord_type& strides() const noexcept { return _strides; }
+            constexpr index_type stride(rank_type r) const noexcept { return _strides[r]; }
+
+            constexpr index_type required_span_size() const noexcept {
+                index_type size = 1;
+                for (rank_type r = 0; r < extents_type::rank(); ++r) {
+                    if (_extents.extent(r) == 0) {
+                        return 0;
+                    }
+                    size += (_extents.extent(r) - 1) * _strides[r];
+                }
+                return size;
+            }
+
+            template <typename... IndexTypes>
+                requires(sizeof...(IndexTypes) == extents_type::rank() && (std::is_convertible_v<IndexTypes, index_type> && ...))
+            constexpr index_type operator()(IndexTypes... idxs) const noexcept {
+                return [&]<std::size_t... Is>(std::index_sequence<Is...>) {
+                    return ((static_cast<index_type>(idxs) * _strides[Is]) + ... + index_type(0));
+                }(std::make_index_sequence<sizeof...(IndexTypes)>{});
+            }
+
+            static constexpr bool is_always_unique() noexcept { return false; }
+            static constexpr bool is_always_exhaustive() noexcept { return false; }
+            static constexpr bool is_always_strided() noexcept { return true; }
+
+            // true when no two indices map to the same element: visiting the
+            // dimensions by increasing stride, each stride must step past the
+            // largest offset of the dimensions before it
+            constexpr bool is_unique() const noexcept {
+                std::array<rank_type, extents_type::rank()> order;
+                for (rank_type r = 0; r < extents_type::rank(); ++r) {
+                    order[r] = r;
+                }
+                std::sort(order.begin(), order.end(), [&](rank_type a, rank_type b) { return _strides[a] < _strides[b]; });
+                index_type span = 1;
+                for (rank_type r : order) {
+                    if (_extents.extent(r) <= 1) {
+                        continue;
+                    }
+                    if (_strides[r] < span) {
+                        return false;
+                    }
+                    span += _strides[r] * (_extents.extent(r) - 1);
+                }
+                return true;
+            }
+
+            constexpr bool is_exhaustive() const noexcept {
+                index_type size = 1;
+                for (rank_type r = 0; r < extents_type::rank(); ++r) {
+                    size *= _extents.extent(r);
+                }
+                return is_unique() && required_span_size() == size;
+            }
+
+            static constexpr bool is_strided() noexcept { return true; }
+
+            friend constexpr bool operator==(const mapping& a, const mapping& b) noexcept {
+                return a._extents == b._extents && a._strides == b._strides;
+            }
+
+        //
+        // Iterators
+        //
+        public:
+            iterator_type begin() const {
+                return iterator_type(this);
+            }
+            iterator_type end() const {
+                return iterator_type(this, true);
+            }
+
+    }; // class mapping
+}; // struct LeftBroadcast
+
+template <typename Extents>
+constexpr void LeftBroadcast::mapping<Extents>::_assert_constructor() const {
+    for (rank_type i = 0; i < extents_type::rank(); ++i) {
+        if (_strides[i] < 0) {
+            std::stringstream ss;
+            ss << "LeftBroadcast::mapping error: strides[" << i << "] = " << _strides[i] << " must be >= 0."
+                << "\n\n"
+                << std::stacktrace::current() << std::endl;
+            throw std::out_of_range(ss.str());
+        }
+    }
+}
+
+} // namespace nabla
+
+#endif // NABLA_LAYOUT_LEFT_BROADCAST_HPP
@@ -1,44 +1,83 @@
 #ifndef NABLA_LAYOUT_LEFT_ITERATOR_HPP
 #define NABLA_LAYOUT_LEFT_ITERATOR_HPP
 
+#include <array>
+#include <cstddef>
+#include <iterator>
+
 namespace nabla {
 
-// forward iterator that avoids integer multiplication in incrementer.
-// Constructors still use multiplication.
+// random access iterator over the codomain of a mapping in left-major order.
+// Increment and decrement avoid integer multiplication by using precomputed
+// wrap-around deltas. Jumps decompose the linear position into coordinates in
+// O(rank).
 template <typename MapT>
 class LeftIterator {
     public:
         using mapping_type = MapT;
         using index_type = typename mapping_type::index_type;
+        using rank_type = typename mapping_type::rank_type;
         using coord_type = std::array<index_type, mapping_type::extents_type::rank()>;
 
     private:
+        static constexpr rank_type _rank = mapping_type::extents_type::rank();
+
         const mapping_type* _mapping = nullptr;
         coord_type _indices{};
         coord_type _deltas{};
         index_type _flat_index = 0;
+        std::ptrdiff_t _position = 0;
 
     public:
         using difference_type = std::ptrdiff_t;
         using value_type = index_type;
         using reference = const value_type;
         using pointer = void;
-        using iterator_category = std::forward_iterator_tag;
+        using iterator_category = std::random_access_iterator_tag;
+        using iterator_concept = std::random_access_iterator_tag;
 
         LeftIterator() = default;
 
         // begin iterator constructor
         LeftIterator(const mapping_type* mapping)
-            : _mapping(mapping) {}
+            : _mapping(mapping) {
+                init_deltas();
+            }
 
         // end iterator constructor
         LeftIterator(const mapping_type* mapping, bool)
-            : _mapping(mapping), _flat_index(mapping->required_span_size()) {}
+            : _mapping(mapping) {
+                init_deltas();
+                seek(size());
+            }
+
+        // iterator at linear position `position` in [0, size]
+        LeftIterator(const mapping_type* mapping, difference_type position)
+            : _mapping(mapping) {
+                init_deltas();
+                seek(position);
+            }
 
         reference operator*() const {
             return _flat_index;
         }
 
+        reference operator[](difference_type n) const {
+            return *(*this + n);
+        }
+
+        // number of elements in the iteration space
+        difference_type size() const {
+            difference_type n = 1;
+            for (rank_type r = 0; r < _rank; ++r) {
+                n *= static_cast<difference_type>(_mapping->extents().extent(r));
+            }
+            return n;
+        }
+
+        difference_type position() const noexcept { return _position; }
+        const coord_type& indices() const noexcept { return _indices; }
+
         LeftIterator& operator++() {
             increment();
             return *this;
@@ -50,31 +89,111 @@ class LeftIterator {
             return tmp;
         }
 
+        LeftIterator& operator--() {
+            decrement();
+            return *this;
+        }
+
+        LeftIterator operator--(int) {
+            LeftIterator tmp = *this;
+            --(*this);
+            return tmp;
+        }
+
+        LeftIterator& operator+=(difference_type n) {
+            seek(_position + n);
+            return *this;
+        }
+
+        LeftIterator& operator-=(difference_type n) {
+            seek(_position - n);
+            return *this;
+        }
+
+        friend LeftIterator operator+(LeftIterator it, difference_type n) {
+            return it += n;
+        }
+
+        friend LeftIterator operator+(difference_type n, LeftIterator it) {
+            return it += n;
+        }
+
+        friend LeftIterator operator-(LeftIterator it, difference_type n) {
+            return it -= n;
+        }
+
+        friend difference_type operator-(const LeftIterator& a, const LeftIterator& b) {
+            return a._position - b._position;
+        }
+
         bool operator==(const LeftIterator& other) const {
-            return _flat_index == other._flat_index;
+            return _position == other._position;
         }
 
         bool operator!=(const LeftIterator& other) const {
             return !(*this == other);
         }
 
+        auto operator<=>(const LeftIterator& other) const {
+            return _position <=> other._position;
+        }
+
     private:
+        void init_deltas() {
+            for (rank_type r = 0; r < _rank; ++r) {
+                _deltas[r] = _mapping->stride(r) * _mapping->extents().extent(r);
+            }
+        }
+
+        // O(rank) jump to a linear position. The past-the-end position maps
+        // to required_span_size() to agree with increment().
+        void seek(difference_type position) {
+            _position = position;
+            _indices = {};
+            if (position >= size()) {
+                _flat_index = _mapping->required_span_size();
+                return;
+            }
+            _flat_index = 0;
+            for (rank_type r = 0; r < _rank; ++r) {
+                const auto extent = static_cast<difference_type>(_mapping->extents().extent(r));
+                _indices[r] = static_cast<index_type>(position % extent);
+                position /= extent;
+                _flat_index += _indices[r] * _mapping->stride(r);
+            }
+        }
+
         void increment() {
+            ++_position;
             index_type prev_index = _flat_index;
-            for (typename mapping_type::rank_type r = 0; r < mapping_type::extents_type::rank(); ++r) {
+            for (rank_type r = 0; r < _rank; ++r) {
                 _flat_index += _mapping->stride(r);
                 if (++_indices[r] < _mapping->extents().extent(r)) {
                     return;
                 }
                 // Wrap around this dimension
-                if (_deltas[r] == 0) {
-                    _deltas[r] = _flat_index;
-                }
                 _flat_index -= _deltas[r];
                 _indices[r] = 0;
             }
             _flat_index = prev_index + 1; // one past the end
         }
+
+        void decrement() {
+            if (_position-- >= size()) {
+                seek(_position);
+                return;
+            }
+            for (rank_type r = 0; r < _rank; ++r) {
+                if (_indices[r] > 0) {
+                    --_indices[r];
+                    _flat_index -= _mapping->stride(r);
+                    return;
+                }
+                // Wrap around this dimension
+                _indices[r] = _mapping->extents().extent(r) - 1;
+                _flat_index += _deltas[r] - _mapping->stride(r);
+            }
+        }
     };
 
 } // namespace nabla
@@ -6,6 +6,7 @@
 #include <stacktrace>
 #include <stdexcept>
 #include "nabla/concepts.hpp"
+#include "nabla/utility/helpers.hpp"
 #include "nabla/layout/left_iterator.hpp"
 
 namespace nabla {
@@ -163,17 +164,31 @@ constexpr void LeftStride::mapping<Extents>::_assert_constructor() const {
             throw std::out_of_range(ss.str());
         }
     }
-    index_type min_stride = 1;
+    // Elements must not overlap: visited by increasing stride, every
+    // dimension must step past the largest offset of the dimensions before
+    // it. Any order is allowed, so permuted and transposed views are valid.
+    std::array<rank_type, extents_type::rank()> order;
     for (rank_type i = 0; i < extents_type::rank(); ++i) {
+        if (this->extents().extent(i) == 0) {
+            return;
+        }
+        order[i] = i;
+    }
+    utility::insertion_sort(order.begin(), order.end(), [&](rank_type a, rank_type b) { return this->stride(a) < this->stride(b); });
+    index_type min_stride = 1;
+    for (rank_type i : order) {
+        if (this->extents().extent(i) == 1) {
+            continue;
+        }
         if (this->stride(i) < min_stride) {
             std::stringstream ss;
             ss << "LeftStride::mapping error: strides[" << i << "] = " << this->stride(i) << " < " << min_stride
-                << " at extents[" << i << "] = " << this->extents().extent(i) << ". Stride must be at least 1 for the first extents."
+                << " at extents[" << i << "] = " << this->extents().extent(i) << ". Dimensions overlap, stride must exceed the largest offset reached by the dimensions with smaller strides."
                 << "\n\n"
                 << std::stacktrace::current() << std::endl;
             throw std::out_of_range(ss.str());
         }
-        min_stride *= this->extents().extent(i);
+        min_stride += this->stride(i) * (this->extents().extent(i) - 1);
     }
 }
 
@@ -0,0 +1,199 @@
+#ifndef NABLA_LAYOUT_RIGHT_ITERATOR_HPP
+#define NABLA_LAYOUT_RIGHT_ITERATOR_HPP
+
+#include <array>
+#include <cstddef>
+#include <iterator>
+
+namespace nabla {
+
+// random access iterator over the codomain of a mapping in right-major order,
+// the last index moving fastest. Mirror image of LeftIterator.
+template <typename MapT>
+class RightIterator {
+    public:
+        using mapping_type = MapT;
+        using index_type = typename mapping_type::index_type;
+        using rank_type = typename mapping_type::rank_type;
+        using coord_type = std::array<index_type, mapping_type::extents_type::rank()>;
+
+    private:
+        static constexpr rank_type _rank = mapping_type::extents_type::rank();
+
+        const mapping_type* _mapping = nullptr;
+        coord_type _indices{};
+        coord_type _deltas{};
+        index_type _flat_index = 0;
+        std::ptrdiff_t _position = 0;
+
+    public:
+        using difference_type = std::ptrdiff_t;
+        using value_type = index_type;
+        using reference = const value_type;
+        using pointer = void;
+        using iterator_category = std::random_access_iterator_tag;
+        using iterator_concept = std::random_access_iterator_tag;
+
+        RightIterator() = default;
+
+        // begin iterator constructor
+        RightIterator(const mapping_type* mapping)
+            : _mapping(mapping) {
+                init_deltas();
+            }
+
+        // end iterator constructor
+        RightIterator(const mapping_type* mapping, bool)
+            : _mapping(mapping) {
+                init_deltas();
+                seek(size());
+            }
+
+        // iterator at linear position `position` in [0, size]
+        RightIterator(const mapping_type* mapping, difference_type position)
+            : _mapping(mapping) {
+                init_deltas();
+                seek(position);
+            }
+
+        reference operator*() const {
+            return _flat_index;
+        }
+
+        reference operator[](difference_type n) const {
+            return *(*this + n);
+        }
+
+        // number of elements in the iteration space
+        difference_type size() const {
+            difference_type n = 1;
+            for (rank_type r = 0; r < _rank; ++r) {
+                n *= static_cast<difference_type>(_mapping->extents().extent(r));
+            }
+            return n;
+        }
+
+        difference_type position() const noexcept { return _position; }
+        const coord_type& indices() const noexcept { return _indices; }
+
+        RightIterator& operator++() {
+            increment();
+            return *this;
+        }
+
+        RightIterator operator++(int) {
+            RightIterator tmp = *this;
+            ++(*this);
+            return tmp;
+        }
+
+        RightIterator& operator--() {
+            decrement();
+            return *this;
+        }
+
+        RightIterator operator--(int) {
+            RightIterator tmp = *this;
+            --(*this);
+            return tmp;
+        }
+
+        RightIterator& operator+=(difference_type n) {
+            seek(_position + n);
+            return *this;
+        }
+
+        RightIterator& operator-=(difference_type n) {
+            seek(_position - n);
+            return *this;
+        }
+
+        friend RightIterator operator+(RightIterator it, difference_type n) {
+            return it += n;
+        }
+
+        friend RightIterator operator+(difference_type n, RightIterator it) {
+            return it += n;
+        }
+
+        friend RightIterator operator-(RightIterator it, difference_type n) {
+            return it -= n;
+        }
+
+        friend difference_type operator-(const RightIterator& a, const RightIterator& b) {
+            return a._position - b._position;
+        }
+
+        bool operator==(const RightIterator& other) const {
+            return _position == other._position;
+        }
+
+        bool operator!=(const RightIterator& other) const {
+            return !(*this == other);
+        }
+
+        auto operator<=>(const RightIterator& other) const {
+            return _position <=> other._position;
+        }
+
+    private:
+        void init_deltas() {
+            for (rank_type r = 0; r < _rank; ++r) {
+                _deltas[r] = _mapping->stride(r) * _mapping->extents().extent(r);
+            }
+        }
+
+        // O(rank) jump to a linear position. The past-the-end position maps
+        // to required_span_size() to agree with increment().
+        void seek(difference_type position) {
+            _position = position;
+            _indices = {};
+            if (position >= size()) {
+                _flat_index = _mapping->required_span_size();
+                return;
+            }
+            _flat_index = 0;
+            for (rank_type r = _rank; r-- > 0;) {
+                const auto extent = static_cast<difference_type>(_mapping->extents().extent(r));
+                _indices[r] = static_cast<index_type>(position % extent);
+                position /= extent;
+                _flat_index += _indices[r] * _mapping->stride(r);
+            }
+        }
+
+        void increment() {
+            ++_position;
+            index_type prev_index = _flat_index;
+            for (rank_type r = _rank; r-- > 0;) {
+                _flat_index += _mapping->stride(r);
+                if (++_indices[r] < _mapping->extents().extent(r)) {
+                    return;
+                }
+                // Wrap around this dimension
+                _flat_index -= _deltas[r];
+                _indices[r] = 0;
+            }
+            _flat_index = prev_index + 1; // one past the end
+        }
+
+        void decrement() {
+            if (_position-- >= size()) {
+                seek(_position);
+                return;
+            }
+            for (rank_type r = _rank; r-- > 0;) {
+                if (_indices[r] > 0) {
+                    --_indices[r];
+                    _flat_index -= _mapping->stride(r);
+                    return;
+                }
+                // Wrap around this dimension
+                _indices[r] = _mapping->extents().extent(r) - 1;
+                _flat_index += _deltas[r] - _mapping->stride(r);
+            }
+        }
+    };
+
+} // namespace nabla
+
+#endif // NABLA_LAYOUT_RIGHT_ITERATOR_HPP
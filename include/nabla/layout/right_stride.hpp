@@ -0,0 +1,186 @@
+#ifndef NABLA_LAYOUT_RIGHT_STRIDE_HPP
+#define NABLA_LAYOUT_RIGHT_STRIDE_HPP
+
+#include <array>
+#include <sstream>
+#include <stacktrace>
+#include <stdexcept>
+#include "nabla/concepts.hpp"
+#include "nabla/utility/helpers.hpp"
+#include "nabla/layout/right_iterator.hpp"
+
+namespace nabla {
+
+// Row-major counterpart of LeftStride: the last index is the fastest and
+// iteration walks the last index first.
+struct RightStride {
+    template <typename Extents>
+    class mapping : public mdspan_ns::layout_stride::mapping<Extents> {
+        //
+        // Member types
+        //
+        public:
+            using mapping_tag = void; // for concept IsMapping
+            using base_t = mdspan_ns::layout_stride::mapping<Extents>;
+            using layout_type = RightStride;
+            using extents_type = typename base_t::extents_type;
+            using index_type = typename base_t::index_type;
+            using rank_type = typename base_t::rank_type;
+            using coord_type = std::array<index_type, extents_type::rank()>;
+            using iterator_type = RightIterator<mapping>;
+
+        //
+        // Helpers
+        //
+        private:
+            static constexpr coord_type _default_strides(const extents_type& exts);
+            constexpr void _assert_constructor() const;
+
+            template <typename... IndexTypes>
+                requires(sizeof...(IndexTypes) == Extents::rank() && (std::is_convertible_v<IndexTypes, typename RightStride::mapping<Extents>::index_type> && ...))
+            constexpr void _assert_index(IndexTypes... idxs) const;
+
+        //
+        // Constructors
+        //
+        public:
+
+            // NOTE: base_t constructors are ambiguous with mapping{ {...} } brace-init constructor so we redefine them all here
+
+            constexpr mapping() = default;
+            constexpr mapping(const mapping&) = default;
+            constexpr mapping(mapping&&) = default;
+            constexpr mapping& operator=(const mapping&) = default;
+            constexpr mapping& operator=(mapping&&) = default;
+
+            template<typename OtherExtents>
+                requires IsExtents<OtherExtents>
+            constexpr mapping(const OtherExtents& exts, const coord_type& strides)
+                : base_t::mapping(exts, strides) {
+                    _assert_constructor();
+                }
+
+            template<typename OtherExtents>
+                requires IsExtents<OtherExtents>
+            constexpr mapping(const OtherExtents& exts)
+                : mapping(exts, _default_strides(exts)) {}
+
+            constexpr mapping(const coord_type& exts, const coord_type& strides)
+                : mapping(extents_type(exts), strides) {}
+
+            constexpr mapping(const coord_type& exts)
+                : mapping(extents_type(exts)) {}
+
+            constexpr mapping(const base_t& other)
+                : base_t::mapping(other) {
+                    _assert_constructor();
+                }
+
+        //
+        // Submap
+        //
+        public:
+            // For ADL use by submdspan
+            template<typename... SliceSpecifiers>
+            friend constexpr auto submdspan_mapping(const mapping& src, SliceSpecifiers&&... slices) {
+                using SubExtents = decltype(mdspan_ns::submdspan_extents(src.extents(), slices...));
+                using SubMap = mapping<SubExtents>;
+                auto mdspan_mapping_result = submdspan_mapping(static_cast<const base_t&>(src), std::forward<SliceSpecifiers>(slices)...);
+                return mdspan_ns::submdspan_mapping_result<SubMap>{mdspan_mapping_result.mapping, mdspan_mapping_result.offset};
+            }
+
+        //
+        // Iterators
+        //
+        public:
+            iterator_type begin() const {
+                return iterator_type(this);
+            }
+            iterator_type end() const {
+                return iterator_type(this, true);
+            }
+
+    }; // class mapping
+}; // struct RightStride
+
+template <typename Extents>
+typename RightStride::mapping<Extents>::coord_type
+constexpr RightStride::mapping<Extents>::_default_strides(const extents_type& exts) {
+    coord_type strides;
+    index_type stride = 1;
+    for (rank_type i = extents_type::rank(); i-- > 0;) {
+        strides[i] = stride;
+        stride *= exts.extent(i);
+    }
+    return strides;
+}
+
+template <typename Extents>
+constexpr void RightStride::mapping<Extents>::_assert_constructor() const {
+    for (rank_type i = 0; i < extents_type::rank(); ++i) {
+        if (this->extents().extent(i) < 0) {
+            std::stringstream ss;
+            ss << "RightStride::mapping error: extents[" << i << "] = " << this->extents().extent(i) << " must be >= 0."
+                << "\n\n"
+                << std::stacktrace::current() << std::endl;
+            throw std::out_of_range(ss.str());
+        }
+    }
+    for (rank_type i = 0; i < extents_type::rank(); ++i) {
+        if (this->stride(i) <= 0) {
+            std::stringstream ss;
+            ss << "RightStride::mapping error: strides[" << i << "] = " << this->stride(i) << " must be > 0."
+                << "\n\n"
+                << std::stacktrace::current() << std::endl;
+            throw std::out_of_range(ss.str());
+        }
+    }
+    // Elements must not overlap: visited by increasing stride, every
+    // dimension must step past the largest offset of the dimensions before
+    // it. Any order is allowed, so permuted and transposed views are valid.
+    std::array<rank_type, extents_type::rank()> order;
+    for (rank_type i = 0; i < extents_type::rank(); ++i) {
+        if (this->extents().extent(i) == 0) {
+            return;
+        }
+        order[i] = i;
+    }
+    utility::insertion_sort(order.begin(), order.end(), [&](rank_type a, rank_type b) { return this->stride(a) < this->stride(b); });
+    index_type min_stride = 1;
+    for (rank_type i : order) {
+        if (this->extents().extent(i) == 1) {
+            continue;
+        }
+        if (this->stride(i) < min_stride) {
+            std::stringstream ss;
+            ss << "RightStride::mapping error: strides[" << i << "] = " << this->stride(i) << " < " << min_stride
+                << " at extents[" << i << "] = " << this->extents().extent(i) << ". Dimensions overlap, stride must exceed the largest offset reached by the dimensions with smaller strides."
+                << "\n\n"
+                << std::stacktrace::current() << std::endl;
+            throw std::out_of_range(ss.str());
+        }
+        min_stride += this->stride(i) * (this->extents().extent(i) - 1);
+    }
+}
+
+template <typename Extents>
+template <typename... IndexTypes>
+    requires(sizeof...(IndexTypes) == Extents::rank() && (std::is_convertible_v<IndexTypes, typename RightStride::mapping<Extents>::index_type> && ...))
+constexpr void RightStride::mapping<Extents>::_assert_index(IndexTypes... idxs) const {
+    coord_type idx_arr{static_cast<index_type>(idxs)...};
+    for (rank_type i = 0; i < extents_type::rank(); ++i) {
+        if (idx_arr[i] < 0 || idx_arr[i] >= this->extents().extent(i)) {
+            std::stringstream ss;
+            ss << "RightStride::mapping error: index " << i << " is out of bounds\n"
+                << "\tindices:     " << nabla::temp::to_string(idx_arr) << "\n"
+                << "\tupper bound: " << nabla::temp::to_string(this->extents(), -1) << "\n"
+                << "\n\n"
+                << std::stacktrace::current() << std::endl;
+            throw std::out_of_range(ss.str());
+        }
+    }
+}
+
+} // namespace nabla
+
+#endif // NABLA_LAYOUT_RIGHT_STRIDE_HPP
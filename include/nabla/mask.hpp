@@ -0,0 +1,467 @@
+#ifndef NABLA_MASK_HPP
+#define NABLA_MASK_HPP
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+#include "nabla/types.hpp"
+#include "nabla/concepts.hpp"
+#include "nabla/layout.hpp"
+#include "nabla/assign.hpp"
+#include "nabla/broadcast.hpp"
+#include "nabla/expr_evaluator.hpp"
+#include "nabla/parallel.hpp"
+#include "nabla/tensor_span.hpp"
+
+// Bit-packed boolean tensors. A MaskArray stores one bit per element in
+// 64-bit words, in the order of its (exhaustive) layout, so a mask is an
+// eighth of a tensor of bool or bytes. Logical operations and counts run a
+// word at a time. Elements are read as bool and written through a proxy
+// reference, and to_span() gives a TensorSpan with bit_accessor for code
+// that works on spans:
+//
+//     auto inside = nb::make_mask(rho, [](double r) { return r > 0.1; });
+//     inside &= ~boundary;
+//     nb::masked_assign(phi, inside, phi + dt * rhs);
+//
+// Bits past the last element are kept zero.
+
+namespace nabla {
+
+namespace detail {
+
+    using mask_word = std::uint64_t;
+
+    inline constexpr std::size_t mask_word_bits = 64;
+
+    constexpr std::size_t mask_words(std::size_t size) noexcept {
+        return (size + mask_word_bits - 1) / mask_word_bits;
+    }
+
+    // bits of the last word that hold elements
+    constexpr mask_word tail_bits(std::size_t size) noexcept {
+        const std::size_t r = size % mask_word_bits;
+        return r == 0 ? ~mask_word(0) : (mask_word(1) << r) - 1;
+    }
+
+} // namespace detail
+
+// Data handle of a bit tensor: the words and the bit offset of the handle's
+// element
+struct bit_handle {
+    std::uint64_t* words = nullptr;
+    std::size_t offset = 0;
+
+    constexpr bit_handle() noexcept = default;
+    constexpr bit_handle(std::uint64_t* w, std::size_t i = 0) noexcept
+        : words(w), offset(i) {}
+};
+
+// Proxy reference to a bit
+class bit_reference {
+    std::uint64_t* _word;
+    std::uint64_t _bit;
+
+    public:
+        constexpr bit_reference(std::uint64_t* words, std::size_t i) noexcept
+            : _word(words + i / detail::mask_word_bits), _bit(std::uint64_t(1) << (i % detail::mask_word_bits)) {}
+
+        constexpr bit_reference(const bit_reference&) = default;
+
+        constexpr operator bool() const noexcept { return (*_word & _bit) != 0; }
+
+        constexpr const bit_reference& operator=(bool value) const noexcept {
+            *_word = value ? (*_word | _bit) : (*_word & ~_bit);
+            return *this;
+        }
+
+        constexpr const bit_reference& operator=(const bit_reference& other) const noexcept {
+            return *this = static_cast<bool>(other);
+        }
+
+        constexpr const bit_reference& operator&=(bool value) const noexcept { return *this = static_cast<bool>(*this) && value; }
+        constexpr const bit_reference& operator|=(bool value) const noexcept { return *this = static_cast<bool>(*this) || value; }
+        constexpr const bit_reference& operator^=(bool value) const noexcept { return *this = static_cast<bool>(*this) != value; }
+};
+
+template <typename T>
+class bit_accessor;
+
+template <>
+class bit_accessor<const bool> {
+    public:
+        using element_type = const bool;
+        using reference = bool;
+        using data_handle_type = bit_handle;
+        using offset_policy = bit_accessor;
+        using read_accessor_type = bit_accessor;
+        using write_accessor_type = bit_accessor<bool>;
+
+        constexpr bit_accessor() noexcept = default;
+
+        constexpr reference access(const data_handle_type& p, std::size_t i) const noexcept {
+            const std::size_t k = p.offset + i;
+            return ((p.words[k / detail::mask_word_bits] >> (k % detail::mask_word_bits)) & 1) != 0;
+        }
+
+        constexpr data_handle_type offset(const data_handle_type& p, std::size_t i) const noexcept {
+            return {p.words, p.offset + i};
+        }
+
+        constexpr write_accessor_type to_write() const noexcept;
+};
+
+template <>
+class bit_accessor<bool> : public bit_accessor<const bool> {
+    public:
+        using element_type = bool;
+        using reference = bit_reference;
+        using data_handle_type = bit_handle;
+        using offset_policy = bit_accessor;
+        using read_accessor_type = bit_accessor<const bool>;
+        using write_accessor_type = bit_accessor;
+
+        constexpr bit_accessor() noexcept = default;
+
+        constexpr reference access(const data_handle_type& p, std::size_t i) const noexcept {
+            return {p.words, p.offset + i};
+        }
+
+        constexpr data_handle_type offset(const data_handle_type& p, std::size_t i) const noexcept {
+            return {p.words, p.offset + i};
+        }
+
+        constexpr write_accessor_type to_write() const noexcept {
+            return {};
+        }
+};
+
+constexpr bit_accessor<bool> bit_accessor<const bool>::to_write() const noexcept {
+    return {};
+}
+
+template <typename Extents, typename LayoutPolicy = LeftStride>
+class MaskArray {
+    //
+    // Member types
+    //
+    public:
+        using element_type = bool;
+        using value_type   = bool;
+        using word_type    = std::uint64_t;
+
+        using extents_type = Extents;
+        using index_type   = typename extents_type::index_type;
+        using size_type    = typename extents_type::size_type;
+        using rank_type    = typename extents_type::rank_type;
+
+        using layout_type  = LayoutPolicy;
+        using mapping_type = typename layout_type::template mapping<extents_type>;
+
+        using span_type       = TensorSpan<bool, extents_type, layout_type, bit_accessor<bool>>;
+        using const_span_type = TensorSpan<const bool, extents_type, layout_type, bit_accessor<const bool>>;
+
+    //
+    // Data members
+    //
+    private:
+        mapping_type _mapping;
+        std::vector<word_type> _words;
+
+    //
+    // Constructors
+    //
+    public:
+        MaskArray() = default;
+
+        // all elements false
+        template <typename... IndexTypes>
+            requires((std::is_convertible_v<IndexTypes, index_type> && ...))
+        explicit MaskArray(IndexTypes... exts)
+            : MaskArray(extents_type(exts...)) {}
+
+        explicit MaskArray(const extents_type& exts)
+            : _mapping(exts), _words(detail::mask_words(static_cast<std::size_t>(_mapping.required_span_size()))) {}
+
+    //
+    // Observers
+    //
+    public:
+        static constexpr rank_type rank() noexcept { return extents_type::rank(); }
+        constexpr index_type extent(rank_type r) const noexcept { return _mapping.extents().extent(r); }
+        constexpr const extents_type& extents() const noexcept { return _mapping.extents(); }
+        constexpr const mapping_type& mapping() const noexcept { return _mapping; }
+        constexpr index_type stride(rank_type r) const noexcept { return _mapping.stride(r); }
+        constexpr index_type size() const noexcept { return static_cast<index_type>(_mapping.required_span_size()); }
+        constexpr bool empty() const noexcept { return size() == 0; }
+
+        // the packed bits, element k in bit k % 64 of word k / 64
+        word_type* data() noexcept { return _words.data(); }
+        const word_type* data() const noexcept { return _words.data(); }
+        std::size_t num_words() const noexcept { return _words.size(); }
+
+    //
+    // Element access
+    //
+    public:
+        template <typename... IndexTypes>
+            requires((std::is_convertible_v<IndexTypes, index_type> && ...))
+        bool operator()(IndexTypes... idxs) const noexcept {
+            return bit_accessor<const bool>().access(bit_handle(const_cast<word_type*>(_words.data())), _mapping(idxs...));
+        }
+
+        template <typename... IndexTypes>
+            requires((std::is_convertible_v<IndexTypes, index_type> && ...))
+        bit_reference operator()(IndexTypes... idxs) noexcept {
+            return {_words.data(), static_cast<std::size_t>(_mapping(idxs...))};
+        }
+
+        const_span_type to_span() const noexcept {
+            return const_span_type(bit_handle(const_cast<word_type*>(_words.data())), _mapping);
+        }
+
+        span_type to_span() noexcept {
+            return span_type(bit_handle(_words.data()), _mapping);
+        }
+
+    //
+    // Word-at-a-time operations
+    //
+    public:
+        void fill(bool value) noexcept {
+            std::fill(_words.begin(), _words.end(), value ? ~word_type(0) : word_type(0));
+            clear_tail();
+        }
+
+        void zero() noexcept { fill(false); }
+
+        // negates every element
+        void flip() noexcept {
+            for (word_type& w : _words) {
+                w = ~w;
+            }
+            clear_tail();
+        }
+
+        MaskArray& operator&=(const MaskArray& other) {
+            combine(other, [](word_type a, word_type b) { return a & b; });
+            return *this;
+        }
+
+        MaskArray& operator|=(const MaskArray& other) {
+            combine(other, [](word_type a, word_type b) { return a | b; });
+            return *this;
+        }
+
+        MaskArray& operator^=(const MaskArray& other) {
+            combine(other, [](word_type a, word_type b) { return a ^ b; });
+            return *this;
+        }
+
+        // number of true elements
+        std::size_t count() const noexcept {
+            std::size_t n = 0;
+            for (word_type w : _words) {
+                n += static_cast<std::size_t>(std::popcount(w));
+            }
+            return n;
+        }
+
+        bool any() const noexcept {
+            return std::any_of(_words.begin(), _words.end(), [](word_type w) { return w != 0; });
+        }
+
+        bool all() const noexcept { return count() == static_cast<std::size_t>(size()); }
+        bool none() const noexcept { return !any(); }
+
+        friend bool operator==(const MaskArray& a, const MaskArray& b) noexcept {
+            return a.extents() == b.extents() && a._words == b._words;
+        }
+
+    private:
+        void clear_tail() noexcept {
+            if (!_words.empty()) {
+                _words.back() &= detail::tail_bits(static_cast<std::size_t>(size()));
+            }
+        }
+
+        template <typename Op>
+        void combine(const MaskArray& other, Op op) {
+            detail::assert_same_extents(*this, other, "nabla::MaskArray");
+            const word_type* in = other._words.data();
+            word_type* out = _words.data();
+            const std::size_t n = _words.size();
+            for (std::size_t w = 0; w < n; ++w) {
+                out[w] = op(out[w], in[w]);
+            }
+        }
+};
+
+template <typename Extents, typename LayoutPolicy>
+MaskArray<Extents, LayoutPolicy> operator&(MaskArray<Extents, LayoutPolicy> a, const MaskArray<Extents, LayoutPolicy>& b) {
+    return a &= b;
+}
+
+template <typename Extents, typename LayoutPolicy>
+MaskArray<Extents, LayoutPolicy> operator|(MaskArray<Extents, LayoutPolicy> a, const MaskArray<Extents, LayoutPolicy>& b) {
+    return a |= b;
+}
+
+template <typename Extents, typename LayoutPolicy>
+MaskArray<Extents, LayoutPolicy> operator^(MaskArray<Extents, LayoutPolicy> a, const MaskArray<Extents, LayoutPolicy>& b) {
+    return a ^= b;
+}
+
+template <typename Extents, typename LayoutPolicy>
+MaskArray<Extents, LayoutPolicy> operator~(MaskArray<Extents, LayoutPolicy> a) {
+    a.flip();
+    return a;
+}
+
+namespace detail {
+
+    template <typename T>
+    inline constexpr bool is_mask_array = false;
+
+    template <typename Extents, typename LayoutPolicy>
+    inline constexpr bool is_mask_array<MaskArray<Extents, LayoutPolicy>> = true;
+
+    // Calls f(offset, indices) for the elements of a mapping
+    template <typename MapT, typename F>
+    void for_each_index(const MapT& map, F&& f) {
+        for (auto it = map.begin(); it != map.end(); ++it) {
+            std::apply([&](auto... idx) { f(static_cast<std::size_t>(map(idx...)), idx...); }, it.indices());
+        }
+    }
+
+    // Stores load(k) to out[k] for the set bits k of words [w0, w1). Full
+    // words are stored as a run, empty ones skipped.
+    template <typename T, typename Load>
+    void masked_store(T* out, const mask_word* words, std::size_t w0, std::size_t w1, Load&& load) {
+        for (std::size_t w = w0; w < w1; ++w) {
+            mask_word bits = words[w];
+            const std::size_t base = w * mask_word_bits;
+            if (bits == ~mask_word(0)) {
+                for (std::size_t k = base; k < base + mask_word_bits; ++k) {
+                    out[k] = load(k);
+                }
+            } else {
+                for (; bits != 0; bits &= bits - 1) {
+                    const std::size_t k = base + static_cast<std::size_t>(std::countr_zero(bits));
+                    out[k] = load(k);
+                }
+            }
+        }
+    }
+
+    template <typename Policy, typename F>
+    void for_word_ranges(const Policy& policy, std::size_t num_words, F&& f) {
+        if constexpr (std::is_same_v<Policy, parallel_policy>) {
+            const std::size_t grain = (policy.grain_size + mask_word_bits - 1) / mask_word_bits;
+            parallel_for(policy, num_words, grain, f);
+        } else {
+            f(std::size_t(0), num_words);
+        }
+    }
+
+} // namespace detail
+
+// Mask of the elements of x for which pred holds. Sources in the mask's
+// order are read in sequence and packed a word at a time.
+template <typename LayoutPolicy = LeftStride, typename X, typename Pred>
+    requires IsTensorLike<X>
+MaskArray<typename std::remove_cvref_t<X>::extents_type, LayoutPolicy> make_mask(const X& x, Pred&& pred) {
+    using mask_type = MaskArray<typename std::remove_cvref_t<X>::extents_type, LayoutPolicy>;
+    mask_type mask(x.extents());
+    auto* words = mask.data();
+    if constexpr (detail::is_same_order<typename mask_type::span_type, X>) {
+        std::size_t k = 0;
+        detail::mask_word bits = 0;
+        for (auto it = x.begin(); it != x.end(); ++it) {
+            bits |= detail::mask_word(pred(*it) ? 1 : 0) << (k % detail::mask_word_bits);
+            if (++k % detail::mask_word_bits == 0) {
+                words[k / detail::mask_word_bits - 1] = bits;
+                bits = 0;
+            }
+        }
+        if (k % detail::mask_word_bits != 0) {
+            words[k / detail::mask_word_bits] = bits;
+        }
+    } else {
+        detail::for_each_index(mask.mapping(), [&](std::size_t k, auto... idx) {
+            if (pred(x(idx...))) {
+                words[k / detail::mask_word_bits] |= detail::mask_word(1) << (k % detail::mask_word_bits);
+            }
+        });
+    }
+    return mask;
+}
+
+// Assigns src to the elements of dst where mask is true, leaving the others
+// untouched. When dst and the leaves of src share the mask's strides, the
+// mask is read a word at a time: empty words are skipped, full ones
+// assigned as a run and the others bit by bit. The parallel policy splits
+// the words across threads.
+template <typename Policy, typename Dst, typename Extents, typename LayoutPolicy, typename Src>
+    requires IsExecutionPolicy<Policy> && (IsTensorSpan<Dst> || IsTensorArray<Dst>) && IsTensorLike<Src>
+void masked_assign(const Policy& policy, Dst&& dst, const MaskArray<Extents, LayoutPolicy>& mask, const Src& src) {
+    using dst_type = std::remove_cvref_t<Dst>;
+    detail::assert_same_extents(dst, mask, "nabla::masked_assign");
+    detail::assert_same_extents(dst, src, "nabla::masked_assign");
+    if constexpr (detail::IsPointerBacked<dst_type>) {
+        const auto kernel = detail::lower(src);
+        if (detail::same_strides(dst.mapping(), mask.mapping()) && kernel.has_strides(detail::strides_of(mask.mapping()))) {
+            auto* out = detail::data_pointer(dst);
+            detail::for_word_ranges(policy, mask.num_words(), [&](std::size_t w0, std::size_t w1) {
+                detail::masked_store(out, mask.data(), w0, w1, [&](std::size_t k) {
+                    return kernel.at(static_cast<detail::offset_type>(k));
+                });
+            });
+            return;
+        }
+    }
+    detail::for_each_index(mask.mapping(), [&](std::size_t, auto... idx) {
+        if (mask(idx...)) {
+            dst(idx...) = src(idx...);
+        }
+    });
+}
+
+// Assigns value to the elements of dst where mask is true
+template <typename Policy, typename Dst, typename Extents, typename LayoutPolicy>
+    requires IsExecutionPolicy<Policy> && (IsTensorSpan<Dst> || IsTensorArray<Dst>)
+void masked_assign(const Policy& policy, Dst&& dst, const MaskArray<Extents, LayoutPolicy>& mask,
+                   const typename std::remove_cvref_t<Dst>::value_type& value) {
+    using dst_type = std::remove_cvref_t<Dst>;
+    detail::assert_same_extents(dst, mask, "nabla::masked_assign");
+    if constexpr (detail::IsPointerBacked<dst_type>) {
+        if (detail::same_strides(dst.mapping(), mask.mapping())) {
+            auto* out = detail::data_pointer(dst);
+            detail::for_word_ranges(policy, mask.num_words(), [&](std::size_t w0, std::size_t w1) {
+                detail::masked_store(out, mask.data(), w0, w1, [&](std::size_t) { return value; });
+            });
+            return;
+        }
+    }
+    detail::for_each_index(mask.mapping(), [&](std::size_t, auto... idx) {
+        if (mask(idx...)) {
+            dst(idx...) = value;
+        }
+    });
+}
+
+template <typename Dst, typename Extents, typename LayoutPolicy, typename Src>
+    requires (IsTensorSpan<Dst> || IsTensorArray<Dst>) &&
+             (IsTensorLike<Src> || std::is_convertible_v<const Src&, typename std::remove_cvref_t<Dst>::value_type>)
+void masked_assign(Dst&& dst, const MaskArray<Extents, LayoutPolicy>& mask, const Src& src) {
+    masked_assign(seq, std::forward<Dst>(dst), mask, src);
+}
+
+} // namespace nabla
+
+#endif // NABLA_MASK_HPP
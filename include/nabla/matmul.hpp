@@ -0,0 +1,272 @@
+#ifndef NABLA_MATMUL_HPP
+#define NABLA_MATMUL_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <memory>
+#include <sstream>
+#include <stacktrace>
+#include <stdexcept>
+#include <type_traits>
+#include <utility>
+#include "nabla/types.hpp"
+#include "nabla/concepts.hpp"
+#include "nabla/expr_evaluator.hpp"
+#include "nabla/parallel.hpp"
+
+// General matrix product C = alpha*A*B + beta*C for rank-2 tensors of any
+// strides, organized after GotoBLAS/BLIS. B is packed a KC x NC panel at a
+// time and A an MC x KC block at a time into contiguous slivers, so the
+// micro-kernel streams both with unit stride whatever the operands' layouts:
+// the MR x NR block of C lives in registers, a KC x NR sliver of B in L1,
+// the block of A in L2 and the panel of B in L3. Edges are zero-padded in
+// the packed buffers and clipped when C is written. Under the parallel
+// policy each thread packs and multiplies its own rows of the block of A
+// against the shared panel of B.
+
+namespace nabla {
+
+template <typename T>
+concept IsMatrix = (IsTensorSpan<T> || IsTensorArray<T>) && std::remove_cvref_t<T>::rank() == 2;
+
+namespace detail {
+
+    // Register and cache blocking for element type T. mr spans two 16-byte
+    // vectors, so the twelve vectors of mr x nr accumulators fit in the
+    // sixteen vector registers of SSE2 with room for the operands. The block
+    // of A takes 128 KiB and the panel of B 4 MiB.
+    template <typename T>
+    struct GemmBlocking {
+        static constexpr std::size_t mr = std::max<std::size_t>(1, 32 / sizeof(T));
+        static constexpr std::size_t nr = 6;
+        static constexpr std::size_t kc = std::max<std::size_t>(64, 1024 / sizeof(T));
+        static constexpr std::size_t mc = std::max<std::size_t>(mr, (std::size_t(1) << 17) / (kc * sizeof(T)) / mr * mr);
+        static constexpr std::size_t nc = std::max<std::size_t>(nr, (std::size_t(1) << 22) / (kc * sizeof(T)) / nr * nr);
+    };
+
+    template <typename C, typename A, typename B>
+    void assert_matmul_extents(const C& c, const A& a, const B& b) {
+        if (static_cast<std::size_t>(c.extent(0)) != static_cast<std::size_t>(a.extent(0)) ||
+            static_cast<std::size_t>(c.extent(1)) != static_cast<std::size_t>(b.extent(1)) ||
+            static_cast<std::size_t>(a.extent(1)) != static_cast<std::size_t>(b.extent(0))) {
+            std::stringstream ss;
+            ss << "nabla::matmul error: extents mismatch\n"
+                << "\tC: " << nabla::temp::to_string(c.extents()) << "\n"
+                << "\tA: " << nabla::temp::to_string(a.extents()) << "\n"
+                << "\tB: " << nabla::temp::to_string(b.extents()) << "\n"
+                << "\n\n"
+                << std::stacktrace::current() << std::endl;
+            throw std::invalid_argument(ss.str());
+        }
+    }
+
+    // Packs rows [i0, i0 + m) and columns [p0, p0 + k) of a into slivers of
+    // mr rows, each stored column by column
+    template <typename T, std::size_t MR, typename LeafT>
+    void pack_a(T* out, const LeafT& a, std::size_t i0, std::size_t m, std::size_t p0, std::size_t k) {
+        const auto& strides = a.reference_strides();
+        for (std::size_t s = 0; s < m; s += MR) {
+            const std::size_t rows = std::min(MR, m - s);
+            offset_type offset = static_cast<offset_type>(i0 + s) * strides[0] + static_cast<offset_type>(p0) * strides[1];
+            for (std::size_t p = 0; p < k; ++p, offset += strides[1], out += MR) {
+                std::size_t i = 0;
+                for (; i < rows; ++i) {
+                    out[i] = static_cast<T>(a.at(offset + static_cast<offset_type>(i) * strides[0]));
+                }
+                for (; i < MR; ++i) {
+                    out[i] = T(0);
+                }
+            }
+        }
+    }
+
+    // Packs rows [p0, p0 + k) and columns [j0, j0 + n) of b into slivers of
+    // nr columns, each stored row by row
+    template <typename T, std::size_t NR, typename LeafT>
+    void pack_b(T* out, const LeafT& b, std::size_t p0, std::size_t k, std::size_t j0, std::size_t n) {
+        const auto& strides = b.reference_strides();
+        for (std::size_t s = 0; s < n; s += NR) {
+            const std::size_t cols = std::min(NR, n - s);
+            offset_type offset = static_cast<offset_type>(p0) * strides[0] + static_cast<offset_type>(j0 + s) * strides[1];
+            for (std::size_t p = 0; p < k; ++p, offset += strides[0], out += NR) {
+                std::size_t j = 0;
+                for (; j < cols; ++j) {
+                    out[j] = static_cast<T>(b.at(offset + static_cast<offset_type>(j) * strides[1]));
+                }
+                for (; j < NR; ++j) {
+                    out[j] = T(0);
+                }
+            }
+        }
+    }
+
+    // c[0:m, 0:n] = alpha*a*b + beta*c for an mr-row sliver a and an nr-column
+    // sliver b, both packed. C is not read when beta is zero.
+    template <typename T, std::size_t MR, std::size_t NR>
+    void gemm_micro_kernel(std::size_t k, const T* a, const T* b,
+                           T* c, offset_type rs, offset_type cs, std::size_t m, std::size_t n,
+                           const T& alpha, const T& beta) {
+        T acc[NR][MR] = {};
+        // the column loop is unrolled at compile time so that acc is
+        // indexed by constants and can stay in registers
+        const auto update = [&]<std::size_t... J>(std::index_sequence<J...>) {
+            for (std::size_t p = 0; p < k; ++p, a += MR, b += NR) {
+                ([&] {
+                    const T bj = b[J];
+                    for (std::size_t i = 0; i < MR; ++i) {
+                        acc[J][i] += a[i] * bj;
+                    }
+                }(), ...);
+            }
+        };
+        update(std::make_index_sequence<NR>{});
+        for (std::size_t j = 0; j < n; ++j) {
+            T* col = c + static_cast<offset_type>(j) * cs;
+            for (std::size_t i = 0; i < m; ++i) {
+                T& out = col[static_cast<offset_type>(i) * rs];
+                out = beta == T(0) ? alpha * acc[j][i] : alpha * acc[j][i] + beta * out;
+            }
+        }
+    }
+
+    // Multiplies rows [i0, i0 + m) of the packed block of A against a packed
+    // k x n panel of B whose first column is column j0 of C
+    template <typename T>
+    void gemm_macro_kernel(const T* packed_a, const T* packed_b, std::size_t m, std::size_t n, std::size_t k,
+                           T* c, offset_type rs, offset_type cs, const T& alpha, const T& beta) {
+        using blocking = GemmBlocking<T>;
+        constexpr std::size_t mr = blocking::mr;
+        constexpr std::size_t nr = blocking::nr;
+        for (std::size_t j = 0; j < n; j += nr) {
+            for (std::size_t i = 0; i < m; i += mr) {
+                gemm_micro_kernel<T, mr, nr>(k, packed_a + i * k, packed_b + j * k,
+                                             c + static_cast<offset_type>(i) * rs + static_cast<offset_type>(j) * cs, rs, cs,
+                                             std::min(mr, m - i), std::min(nr, n - j), alpha, beta);
+            }
+        }
+    }
+
+    // Packing buffer for one MC x KC block of A. Each thread keeps its own
+    // for its lifetime, so packing allocates once per thread and type rather
+    // than once per panel of B.
+    template <typename T>
+    T* packed_a_buffer() {
+        using blocking = GemmBlocking<T>;
+        thread_local const auto buffer = std::make_unique_for_overwrite<T[]>(blocking::mc * blocking::kc);
+        return buffer.get();
+    }
+
+    // c = beta*c, without reading c when beta is zero
+    template <typename T>
+    void scale_matrix(T* c, offset_type rs, offset_type cs, std::size_t m, std::size_t n, const T& beta) {
+        for (std::size_t j = 0; j < n; ++j) {
+            for (std::size_t i = 0; i < m; ++i) {
+                T& out = c[static_cast<offset_type>(i) * rs + static_cast<offset_type>(j) * cs];
+                out = beta == T(0) ? T(0) : beta * out;
+            }
+        }
+    }
+
+    // C = alpha*A*B + beta*C where C is m x n at c with strides (rs, cs).
+    // run_rows(slivers, f) calls f(begin, end) over a partition of the
+    // [0, slivers) mr-row slivers of a block of A.
+    template <typename T, typename LeafA, typename LeafB, typename RunRows>
+    void gemm(T* c, offset_type rs, offset_type cs, std::size_t m, std::size_t n, std::size_t k,
+              const LeafA& a, const LeafB& b, const T& alpha, const T& beta, RunRows&& run_rows) {
+        using blocking = GemmBlocking<T>;
+        constexpr std::size_t mr = blocking::mr;
+        constexpr std::size_t nr = blocking::nr;
+        if (m == 0 || n == 0) {
+            return;
+        }
+        if (k == 0 || alpha == T(0)) {
+            scale_matrix(c, rs, cs, m, n, beta);
+            return;
+        }
+        const std::size_t slivers = (m + mr - 1) / mr;
+        const std::size_t panel_k = std::min(blocking::kc, k);
+        const std::size_t panel_n = (std::min(blocking::nc, n) + nr - 1) / nr * nr;
+        auto packed_b = std::make_unique_for_overwrite<T[]>(panel_k * panel_n);
+        for (std::size_t jc = 0; jc < n; jc += blocking::nc) {
+            const std::size_t nc = std::min(blocking::nc, n - jc);
+            for (std::size_t pc = 0; pc < k; pc += blocking::kc) {
+                const std::size_t kc = std::min(blocking::kc, k - pc);
+                const T beta_pc = pc == 0 ? beta : T(1);
+                pack_b<T, nr>(packed_b.get(), b, pc, kc, jc, nc);
+                run_rows(slivers, [&](std::size_t begin, std::size_t end) {
+                    T* packed_a = packed_a_buffer<T>();
+                    for (std::size_t s = begin; s < end; s += blocking::mc / mr) {
+                        const std::size_t ic = s * mr;
+                        const std::size_t mc = std::min(std::min(end, s + blocking::mc / mr) * mr, m) - ic;
+                        pack_a<T, mr>(packed_a, a, ic, mc, pc, kc);
+                        gemm_macro_kernel(packed_a, packed_b.get(), mc, nc, kc,
+                                          c + static_cast<offset_type>(ic) * rs + static_cast<offset_type>(jc) * cs,
+                                          rs, cs, alpha, beta_pc);
+                    }
+                });
+            }
+        }
+    }
+
+    template <typename Dst, typename A, typename B, typename RunRows>
+    void matmul(Dst& c, const A& a, const B& b,
+                const typename std::remove_cvref_t<Dst>::value_type& alpha,
+                const typename std::remove_cvref_t<Dst>::value_type& beta, RunRows&& run_rows) {
+        assert_matmul_extents(c, a, b);
+        const auto strides = strides_of(c.mapping());
+        gemm(data_pointer(c), strides[0], strides[1],
+             static_cast<std::size_t>(a.extent(0)), static_cast<std::size_t>(b.extent(1)), static_cast<std::size_t>(a.extent(1)),
+             lower(a), lower(b), alpha, beta, std::forward<RunRows>(run_rows));
+    }
+
+} // namespace detail
+
+// C = alpha*A*B + beta*C. A and B may have any strides and accessors, C
+// must be plain memory and must not overlap A or B. C is not read when
+// beta is zero.
+template <typename Dst, typename A, typename B>
+    requires IsMatrix<Dst> && detail::IsPointerBacked<std::remove_cvref_t<Dst>> && IsMatrix<A> && IsMatrix<B>
+void matmul(Dst&& c, const A& a, const B& b,
+            const typename std::remove_cvref_t<Dst>::value_type& alpha = 1,
+            const typename std::remove_cvref_t<Dst>::value_type& beta = 0) {
+    detail::matmul(c, a, b, alpha, beta, [](std::size_t slivers, auto&& f) {
+        f(std::size_t(0), slivers);
+    });
+}
+
+// C = alpha*A*B + beta*C under an execution policy. The parallel policy
+// splits the rows of C across threads when the product has at least
+// serial_cutoff multiply-adds, with at least grain_size multiply-adds per
+// chunk.
+template <typename Policy, typename Dst, typename A, typename B>
+    requires IsExecutionPolicy<Policy> && IsMatrix<Dst> && detail::IsPointerBacked<std::remove_cvref_t<Dst>> &&
+             IsMatrix<A> && IsMatrix<B>
+void matmul(const Policy& policy, Dst&& c, const A& a, const B& b,
+            const typename std::remove_cvref_t<Dst>::value_type& alpha = 1,
+            const typename std::remove_cvref_t<Dst>::value_type& beta = 0) {
+    if constexpr (std::is_same_v<std::remove_cvref_t<Policy>, parallel_policy>) {
+        using blocking = detail::GemmBlocking<typename std::remove_cvref_t<Dst>::value_type>;
+        const std::size_t m = static_cast<std::size_t>(a.extent(0));
+        const std::size_t n = static_cast<std::size_t>(b.extent(1));
+        const std::size_t k = static_cast<std::size_t>(a.extent(1));
+        const bool serial = m * n * k < policy.serial_cutoff;
+        const std::size_t threads = max_threads(policy);
+        detail::matmul(c, a, b, alpha, beta, [&](std::size_t slivers, auto&& f) {
+            if (serial) {
+                f(std::size_t(0), slivers);
+                return;
+            }
+            // multiply-adds of one sliver against the current panel of B
+            const std::size_t work = blocking::mr * std::min(blocking::nc, n) * std::min(blocking::kc, k);
+            const std::size_t balanced = (slivers + threads - 1) / threads;
+            const std::size_t grain = std::max((policy.grain_size + work - 1) / work, std::min(balanced, blocking::mc / blocking::mr));
+            parallel_for(policy.with_serial_cutoff(0), slivers, grain, f);
+        });
+    } else {
+        matmul(std::forward<Dst>(c), a, b, alpha, beta);
+    }
+}
+
+} // namespace nabla
+
+#endif // NABLA_MATMUL_HPP
@@ -0,0 +1,305 @@
+#ifndef NABLA_MMAP_HPP
+#define NABLA_MMAP_HPP
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <stacktrace>
+#include <stdexcept>
+#include <string>
+#include <system_error>
+#include <type_traits>
+#include <vector>
+#include "nabla/types.hpp"
+#include "nabla/dtype.hpp"
+#include "nabla/shared_accessor.hpp"
+#include "nabla/tensor_span.hpp"
+
+#if __has_include(<sys/mman.h>) && __has_include(<sys/stat.h>) && __has_include(<fcntl.h>) && __has_include(<unistd.h>)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#define NABLA_HAS_MMAP 1
+#else
+#define NABLA_HAS_MMAP 0
+#endif
+
+// Tensors over memory-mapped files, either .npy files or raw element data
+// with user extents, e.g.
+//
+//     auto a = nb::mmap_tensor<const double, nb::dims<2>>("a.npy", nb::mmap_advice::sequential);
+//
+// The file is mapped shared, read-only for const element types and
+// read-write otherwise, so writes through the span reach the file. The span's
+// shared_accessor owns the mapping, which is unmapped with the last span or
+// expression over it. Fortran-order data maps directly onto LeftStride, and
+// C-order data gets reversed strides, which LeftStride takes as a transposed
+// view and RightStride as its own order. Without mmap, the file is read into
+// memory instead and writes are not reflected in the file.
+
+namespace nabla {
+
+enum class mmap_advice {
+    normal,     // MADV_NORMAL
+    sequential, // MADV_SEQUENTIAL, aggressive read-ahead
+    random,     // MADV_RANDOM, no read-ahead
+    will_need,  // MADV_WILLNEED, start reading the whole file in
+};
+
+namespace detail {
+
+    // A whole file mapped into memory
+    struct mapped_file {
+        std::shared_ptr<std::byte[]> data;
+        std::size_t size = 0;
+    };
+
+    [[noreturn]] inline void throw_mmap_error(int error, const std::filesystem::path& path, const char* what) {
+        std::stringstream ss;
+        ss << "nabla::mmap_tensor error: " << what << " of " << path << " failed"
+            << "\n\n"
+            << std::stacktrace::current() << std::endl;
+        throw std::system_error(error, std::generic_category(), ss.str());
+    }
+
+    [[noreturn]] inline void throw_format_error(const std::filesystem::path& path, const std::string& what) {
+        std::stringstream ss;
+        ss << "nabla::mmap_tensor error: " << path << ": " << what
+            << "\n\n"
+            << std::stacktrace::current() << std::endl;
+        throw std::invalid_argument(ss.str());
+    }
+
+#if NABLA_HAS_MMAP
+    inline int to_madvise(mmap_advice advice) noexcept {
+        switch (advice) {
+            case mmap_advice::sequential: return MADV_SEQUENTIAL;
+            case mmap_advice::random: return MADV_RANDOM;
+            case mmap_advice::will_need: return MADV_WILLNEED;
+            default: return MADV_NORMAL;
+        }
+    }
+
+    inline mapped_file map_file(const std::filesystem::path& path, bool writable, mmap_advice advice) {
+        const int fd = ::open(path.c_str(), writable ? O_RDWR : O_RDONLY);
+        if (fd < 0) {
+            throw_mmap_error(errno, path, "open");
+        }
+        struct ::stat st;
+        if (::fstat(fd, &st) != 0) {
+            const int error = errno;
+            ::close(fd);
+            throw_mmap_error(error, path, "fstat");
+        }
+        mapped_file file;
+        file.size = static_cast<std::size_t>(st.st_size);
+        if (file.size == 0) {
+            ::close(fd);
+            return file;
+        }
+        void* p = ::mmap(nullptr, file.size, writable ? PROT_READ | PROT_WRITE : PROT_READ, MAP_SHARED, fd, 0);
+        const int error = errno;
+        ::close(fd); // the mapping keeps its own reference to the file
+        if (p == MAP_FAILED) {
+            throw_mmap_error(error, path, "mmap");
+        }
+        ::madvise(p, file.size, to_madvise(advice));
+        const std::size_t size = file.size;
+        file.data = std::shared_ptr<std::byte[]>(static_cast<std::byte*>(p), [size](std::byte* q) { ::munmap(q, size); });
+        return file;
+    }
+#else
+    inline mapped_file map_file(const std::filesystem::path& path, bool, mmap_advice) {
+        std::ifstream in(path, std::ios::binary | std::ios::ate);
+        if (!in) {
+            throw_mmap_error(ENOENT, path, "open");
+        }
+        mapped_file file;
+        file.size = static_cast<std::size_t>(in.tellg());
+        // max_align_t storage keeps the elements as aligned as a mapping would
+        const std::size_t words = (file.size + sizeof(std::max_align_t) - 1) / sizeof(std::max_align_t);
+        auto words_ptr = std::make_shared<std::max_align_t[]>(words);
+        file.data = std::shared_ptr<std::byte[]>(words_ptr, reinterpret_cast<std::byte*>(words_ptr.get()));
+        in.seekg(0);
+        if (!in.read(reinterpret_cast<char*>(file.data.get()), static_cast<std::streamsize>(file.size))) {
+            throw_mmap_error(EIO, path, "read");
+        }
+        return file;
+    }
+#endif
+
+    //
+    // .npy format
+    //
+
+    // The header of a .npy file: magic "\x93NUMPY", version, header length
+    // (2 bytes in version 1, 4 bytes after) and a python dict literal
+    // {'descr': '<f8', 'fortran_order': False, 'shape': (3, 4), }
+    struct npy_header {
+        std::string descr;
+        bool fortran_order = false;
+        std::vector<std::size_t> shape;
+        std::size_t data_offset = 0;
+    };
+
+    // the value of `key` in the header dict, up to the next ',' or the
+    // matching ')' for tuples
+    inline std::string npy_field(const std::string& dict, const std::string& key, const std::filesystem::path& path) {
+        const std::size_t k = dict.find("'" + key + "'");
+        if (k == std::string::npos) {
+            throw_format_error(path, "npy header has no '" + key + "'");
+        }
+        std::size_t begin = dict.find(':', k);
+        if (begin == std::string::npos) {
+            throw_format_error(path, "malformed npy header");
+        }
+        begin = dict.find_first_not_of(" ", begin + 1);
+        if (begin == std::string::npos) {
+            throw_format_error(path, "malformed npy header");
+        }
+        std::size_t end = dict[begin] == '(' ? dict.find(')', begin) : dict.find_first_of(",}", begin);
+        if (end == std::string::npos) {
+            throw_format_error(path, "malformed npy header");
+        }
+        end += dict[begin] == '(';
+        return dict.substr(begin, end - begin);
+    }
+
+    inline npy_header parse_npy_header(const mapped_file& file, const std::filesystem::path& path) {
+        const auto* bytes = reinterpret_cast<const unsigned char*>(file.data.get());
+        if (file.size < 10 || std::memcmp(bytes, "\x93NUMPY", 6) != 0) {
+            throw_format_error(path, "not an npy file");
+        }
+        const unsigned major = bytes[6];
+        std::size_t length = 0;
+        std::size_t start = 0;
+        if (major == 1) {
+            length = bytes[8] | (std::size_t(bytes[9]) << 8);
+            start = 10;
+        } else if (major == 2 || major == 3) {
+            if (file.size < 12) {
+                throw_format_error(path, "not an npy file");
+            }
+            length = bytes[8] | (std::size_t(bytes[9]) << 8) | (std::size_t(bytes[10]) << 16) | (std::size_t(bytes[11]) << 24);
+            start = 12;
+        } else {
+            throw_format_error(path, "unsupported npy version " + std::to_string(major));
+        }
+        if (start + length > file.size) {
+            throw_format_error(path, "truncated npy header");
+        }
+
+        npy_header header;
+        const std::string dict(reinterpret_cast<const char*>(bytes + start), length);
+        header.data_offset = start + length;
+
+        const std::string descr = npy_field(dict, "descr", path);
+        if (descr.size() < 3 || (descr.front() != '\'' && descr.front() != '"') || descr.back() != descr.front()) {
+            throw_format_error(path, "unsupported npy descr " + descr);
+        }
+        header.descr = descr.substr(1, descr.size() - 2);
+
+        const std::string order = npy_field(dict, "fortran_order", path);
+        if (order != "True" && order != "False") {
+            throw_format_error(path, "malformed npy fortran_order " + order);
+        }
+        header.fortran_order = order == "True";
+
+        const std::string shape = npy_field(dict, "shape", path);
+        for (std::size_t i = 1; i < shape.size() - 1;) {
+            i = shape.find_first_not_of(", ", i);
+            if (i >= shape.size() - 1) {
+                break;
+            }
+            std::size_t used = 0;
+            header.shape.push_back(std::stoull(shape.substr(i), &used));
+            if (used == 0) {
+                throw_format_error(path, "malformed npy shape " + shape);
+            }
+            i += used;
+        }
+        return header;
+    }
+
+    template <typename ElementType, typename Extents, typename LayoutPolicy>
+    auto mapped_span(mapped_file&& file, std::size_t offset, const typename LayoutPolicy::template mapping<Extents>& map,
+                     const std::filesystem::path& path) {
+        using T = std::remove_const_t<ElementType>;
+        using span_type = TensorSpan<ElementType, Extents, LayoutPolicy, shared_accessor<ElementType>>;
+        const std::size_t bytes = map.required_span_size() * sizeof(T);
+        if (offset > file.size || file.size - offset < bytes) {
+            std::stringstream ss;
+            ss << "file holds " << file.size << " bytes, " << offset + bytes << " are needed";
+            throw_format_error(path, ss.str());
+        }
+        if (offset % alignof(T) != 0) {
+            throw_format_error(path, "data offset " + std::to_string(offset) + " is misaligned for the element type");
+        }
+        T* p = reinterpret_cast<T*>(file.data.get() + offset);
+        std::shared_ptr<T[]> data(std::move(file.data), p);
+        return span_type(std::move(data), map);
+    }
+
+} // namespace detail
+
+// Maps the .npy file at `path`, whose dtype must be ElementType in native
+// byte order and whose shape must match Extents
+template <typename ElementType, typename Extents, typename LayoutPolicy = LeftStride>
+    requires std::is_trivially_copyable_v<ElementType>
+TensorSpan<ElementType, Extents, LayoutPolicy, shared_accessor<ElementType>>
+mmap_tensor(const std::filesystem::path& path, mmap_advice advice = mmap_advice::normal) {
+    using T = std::remove_const_t<ElementType>;
+    using index_type = typename Extents::index_type;
+    using mapping_type = typename LayoutPolicy::template mapping<Extents>;
+    constexpr std::size_t rank = Extents::rank();
+
+    detail::mapped_file file = detail::map_file(path, !std::is_const_v<ElementType>, advice);
+    const detail::npy_header header = detail::parse_npy_header(file, path);
+    if (!detail::npy_descr_matches<T>(header.descr)) {
+        detail::throw_format_error(path, "npy dtype '" + header.descr + "' does not match the element type");
+    }
+    if (header.shape.size() != rank) {
+        detail::throw_format_error(path, "npy shape has rank " + std::to_string(header.shape.size()) +
+                                         ", expected " + std::to_string(rank));
+    }
+
+    std::array<index_type, rank> exts;
+    std::array<index_type, rank> strides;
+    index_type stride = 1;
+    for (std::size_t k = 0; k < rank; ++k) {
+        const std::size_t r = header.fortran_order ? k : rank - 1 - k;
+        exts[r] = static_cast<index_type>(header.shape[r]);
+        if (Extents::static_extent(r) != std::dynamic_extent && Extents::static_extent(r) != header.shape[r]) {
+            detail::throw_format_error(path, "npy shape[" + std::to_string(r) + "] = " + std::to_string(header.shape[r]) +
+                                             " does not match the static extent " + std::to_string(Extents::static_extent(r)));
+        }
+        strides[r] = stride;
+        stride *= std::max<index_type>(exts[r], 1);
+    }
+    return detail::mapped_span<ElementType, Extents, LayoutPolicy>(std::move(file), header.data_offset,
+                                                                   mapping_type(Extents(exts), strides), path);
+}
+
+// Maps the raw elements at byte `offset` of the file at `path`, laid out by
+// the default strides of LayoutPolicy for `exts`
+template <typename ElementType, typename Extents, typename LayoutPolicy = LeftStride>
+    requires std::is_trivially_copyable_v<ElementType>
+TensorSpan<ElementType, Extents, LayoutPolicy, shared_accessor<ElementType>>
+mmap_tensor(const std::filesystem::path& path, const Extents& exts, std::size_t offset = 0,
+            mmap_advice advice = mmap_advice::normal) {
+    using mapping_type = typename LayoutPolicy::template mapping<Extents>;
+    detail::mapped_file file = detail::map_file(path, !std::is_const_v<ElementType>, advice);
+    return detail::mapped_span<ElementType, Extents, LayoutPolicy>(std::move(file), offset, mapping_type(exts), path);
+}
+
+} // namespace nabla
+
+#endif // NABLA_MMAP_HPP
@@ -6,10 +6,30 @@
 #include "nabla/types.hpp"
 #include "nabla/concepts.hpp"
 #include "nabla/layout.hpp"
+#include "nabla/aligned_allocator.hpp"
+#include "nabla/default_init_allocator.hpp"
+#include "nabla/aligned_accessor.hpp"
+#include "nabla/parallel.hpp"
+#include "nabla/assign.hpp"
 #include "nabla/tensor_span.hpp"
 #include "nabla/tensor_array.hpp"
 #include "nabla/elementwise_expr.hpp"
 #include "nabla/subspan.hpp"
+#include "nabla/permute.hpp"
+#include "nabla/reduce.hpp"
+#include "nabla/matmul.hpp"
+#include "nabla/workspace.hpp"
+#include "nabla/shared_accessor.hpp"
+#include "nabla/mmap.hpp"
+#include "nabla/io.hpp"
+#include "nabla/codec.hpp"
+#include "nabla/chunk_store.hpp"
+#include "nabla/paging_accessor.hpp"
+#include "nabla/atomic_accessor.hpp"
+#include "nabla/scatter.hpp"
+#include "nabla/quantized_accessor.hpp"
+#include "nabla/mask.hpp"
+#include "nabla/half.hpp"
 
 //#include "nabla/ostream.hpp"
 //#include "nabla/debug/assert.hpp"
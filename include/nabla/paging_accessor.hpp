@@ -0,0 +1,544 @@
+#ifndef NABLA_PAGING_ACCESSOR_HPP
+#define NABLA_PAGING_ACCESSOR_HPP
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <filesystem>
+#include <list>
+#include <optional>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <stacktrace>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+#include "nabla/types.hpp"
+#include "nabla/default_init_allocator.hpp"
+#include "nabla/io.hpp"
+#include "nabla/tensor_span.hpp"
+
+// Out-of-core tensors: a TensorSpan over a file that is paged through a
+// bounded cache of tiles, e.g.
+//
+//     auto u = nb::paged_tensor<const double, nb::dims<3>>("u.nbt", {.cache_size = std::size_t(1) << 30});
+//     nb::TensorArray<double, nb::dims<3>> v(u.extents());
+//     v = 2.0*u + 1.0;
+//
+// The file is cut into tiles of consecutive elements. The data handle holds
+// the shared tile cache and an element offset, and the accessor reads
+// through the cache, loading missing tiles and evicting the least recently
+// used. A miss also queues the next tiles in the direction of traversal for
+// a background thread, so a LeftIterator walk over left-major data, as
+// done by the evaluator, finds its tiles loaded ahead of it. Reads of the
+// last tile a thread used skip the cache's lock. As with plain memory,
+// reading an element while another thread writes the same element is a
+// data race; other elements of the tile may be read meanwhile.
+//
+// Spans of non-const elements access elements through a proxy reference;
+// written tiles are written back on eviction, on flush() of the handle's
+// cache, and when the last span goes away.
+
+namespace nabla {
+
+struct paging_options {
+    // bytes per tile, rounded down to whole elements
+    std::size_t tile_size = std::size_t(1) << 20;
+    // bytes of tiles held in memory
+    std::size_t cache_size = std::size_t(256) << 20;
+    // tiles loaded ahead of a miss, 0 for none
+    std::size_t prefetch = 4;
+};
+
+namespace detail {
+
+    [[noreturn]] inline void throw_paging_error(const std::filesystem::path& path, const std::string& what) {
+        std::stringstream ss;
+        ss << "nabla paged tensor error: " << path << ": " << what
+            << "\n\n"
+            << std::stacktrace::current() << std::endl;
+        throw std::invalid_argument(ss.str());
+    }
+
+    // LRU cache of the tiles of size elements of T stored at byte
+    // data_offset of a file
+    template <typename T>
+    class TileCache {
+        struct Tile {
+            std::unique_ptr<T[]> data;
+            std::size_t count = 0;
+            bool ready = false;
+            bool failed = false;
+            bool dirty = false;
+            bool prefetched = false;
+            std::list<std::size_t>::iterator lru;
+        };
+
+        // The last tile a thread read, keyed by the cache's id, never reused,
+        // and valid while no tile was evicted since. A stale entry is
+        // replaced by the thread's next read; the data of the tile it holds
+        // is freed with the cache.
+        struct LocalTile {
+            std::uint64_t cache_id = 0;
+            std::uint64_t epoch = 0;
+            std::size_t index = 0;
+            std::shared_ptr<Tile> tile;
+        };
+
+        binary_file _file;
+        std::filesystem::path _path;
+        std::uint64_t _data_offset;
+        std::size_t _size;
+        std::size_t _tile_elements;
+        std::size_t _capacity;
+        std::size_t _prefetch;
+        bool _writable;
+        std::optional<tensor_file_header> _header;
+        std::uint64_t _id;
+
+        mutable std::mutex _mutex;
+        mutable std::condition_variable _loaded;
+        mutable std::unordered_map<std::size_t, std::shared_ptr<Tile>> _tiles;
+        mutable std::list<std::size_t> _lru; // most recently used first
+        mutable std::atomic<std::uint64_t> _epoch{0};
+        // evicted tiles that a thread's LocalTile may still hold
+        mutable std::vector<std::weak_ptr<Tile>> _retired;
+        mutable std::size_t _last_miss = 0;
+        mutable bool _written = false;
+
+        mutable std::deque<std::size_t> _prefetch_queue;
+        mutable std::condition_variable _prefetch_cv;
+        bool _stop = false;
+        std::thread _prefetcher;
+
+        public:
+            // `header` is that of a tensor file, whose checksum is kept up to
+            // date on flush
+            TileCache(const std::filesystem::path& path, bool writable, std::uint64_t data_offset, std::size_t size,
+                      const paging_options& options, std::optional<tensor_file_header> header = std::nullopt)
+                : _file(path, writable ? file_mode::update : file_mode::read), _path(path), _data_offset(data_offset),
+                  _size(size), _tile_elements(std::max<std::size_t>(options.tile_size / sizeof(T), 1)),
+                  _capacity(std::max<std::size_t>(options.cache_size / (_tile_elements * sizeof(T)), 1)),
+                  _prefetch(std::min(options.prefetch, _capacity - 1)), _writable(writable), _header(header),
+                  _id(next_id()) {
+                    if (_prefetch > 0) {
+                        _prefetcher = std::thread([this] { prefetch_loop(); });
+                    }
+                }
+
+            TileCache(const TileCache&) = delete;
+            TileCache& operator=(const TileCache&) = delete;
+
+            ~TileCache() {
+                if (_prefetcher.joinable()) {
+                    {
+                        std::lock_guard lock(_mutex);
+                        _stop = true;
+                    }
+                    _prefetch_cv.notify_all();
+                    _prefetcher.join();
+                }
+                try {
+                    flush();
+                } catch (...) {
+                    // call flush() to see write errors
+                }
+                // the LocalTile of a thread that stopped reading keeps its
+                // tile, but not the tile's data
+                for (auto& [index, tile] : _tiles) {
+                    tile->data.reset();
+                }
+                for (const auto& retired : _retired) {
+                    if (auto tile = retired.lock()) {
+                        tile->data.reset();
+                    }
+                }
+            }
+
+            std::size_t size() const noexcept { return _size; }
+            std::size_t tile_elements() const noexcept { return _tile_elements; }
+            std::size_t capacity() const noexcept { return _capacity; }
+
+            // number of tiles in memory
+            std::size_t resident() const {
+                std::lock_guard lock(_mutex);
+                return _tiles.size();
+            }
+
+            T read(std::size_t i) const {
+                static thread_local LocalTile local;
+                const std::size_t index = i / _tile_elements;
+                const std::size_t k = i % _tile_elements;
+                if (local.cache_id == _id && local.index == index && local.epoch == _epoch.load(std::memory_order_acquire)) {
+                    return local.tile->data[k];
+                }
+                const std::uint64_t epoch = _epoch.load(std::memory_order_acquire);
+                std::unique_lock lock(_mutex);
+                std::shared_ptr<Tile> tile = get(index, lock);
+                const T value = tile->data[k];
+                lock.unlock();
+                local = {_id, epoch, index, std::move(tile)};
+                return value;
+            }
+
+            void write(std::size_t i, const T& value) {
+                std::unique_lock lock(_mutex);
+                std::shared_ptr<Tile> tile = get(i / _tile_elements, lock);
+                tile->data[i % _tile_elements] = value;
+                tile->dirty = true;
+            }
+
+            // writes the modified tiles back to the file
+            void flush() const {
+                std::lock_guard lock(_mutex);
+                for (auto& [index, tile] : _tiles) {
+                    if (tile->ready && tile->dirty) {
+                        store(index, *tile);
+                        tile->dirty = false;
+                    }
+                }
+                if (_header && _written) {
+                    update_checksum();
+                    _written = false;
+                }
+            }
+
+        private:
+            static std::uint64_t next_id() noexcept {
+                static std::atomic<std::uint64_t> id{0};
+                return ++id;
+            }
+
+            std::size_t num_tiles() const noexcept {
+                return (_size + _tile_elements - 1) / _tile_elements;
+            }
+
+            void load(std::size_t index, Tile& tile) const {
+                const std::size_t begin = index * _tile_elements;
+                tile.count = std::min(_tile_elements, _size - begin);
+                tile.data.reset(new T[tile.count]);
+                _file.read_at(tile.data.get(), tile.count * sizeof(T), _data_offset + begin * sizeof(T));
+            }
+
+            void store(std::size_t index, const Tile& tile) const {
+                _file.write_at(tile.data.get(), tile.count * sizeof(T), _data_offset + index * _tile_elements * sizeof(T));
+                _written = true;
+            }
+
+            // Rereads the data of the tensor file to checksum it as
+            // write_tensor does
+            void update_checksum() const {
+                const std::size_t bytes = _size * sizeof(T);
+                const std::size_t chunk_size = _header->chunk_size;
+                std::vector<std::uint64_t> checksums((bytes + chunk_size - 1) / chunk_size);
+                default_init_vector<std::byte> buffer(std::min(chunk_size, bytes));
+                for (std::size_t c = 0; c < checksums.size(); ++c) {
+                    const std::size_t n = std::min(chunk_size, bytes - c * chunk_size);
+                    _file.read_at(buffer.data(), n, _data_offset + c * chunk_size);
+                    checksums[c] = checksum64(buffer.data(), n);
+                }
+                const std::uint64_t checksum = combine_checksums(checksums);
+                _file.write_at(&checksum, sizeof(checksum), offsetof(tensor_file_header, checksum));
+            }
+
+            // Inserts a tile that is not loaded yet, evicting least recently
+            // used tiles beyond the capacity. Called with the lock held.
+            std::shared_ptr<Tile> insert(std::size_t index) const {
+                for (auto it = _lru.end(); _tiles.size() >= _capacity && it != _lru.begin();) {
+                    --it;
+                    auto victim = _tiles.find(*it);
+                    if (!victim->second->ready) {
+                        continue;
+                    }
+                    if (victim->second->dirty) {
+                        store(victim->first, *victim->second);
+                    }
+                    if (victim->second.use_count() > 1) {
+                        retire(victim->second);
+                    }
+                    _epoch.fetch_add(1, std::memory_order_release);
+                    _tiles.erase(victim);
+                    it = _lru.erase(it);
+                }
+                auto tile = std::make_shared<Tile>();
+                _lru.push_front(index);
+                tile->lru = _lru.begin();
+                _tiles.emplace(index, tile);
+                return tile;
+            }
+
+            // Remembers an evicted tile held by a LocalTile. Called with the
+            // lock held.
+            void retire(const std::shared_ptr<Tile>& tile) const {
+                std::erase_if(_retired, [](const auto& retired) { return retired.expired(); });
+                _retired.push_back(tile);
+            }
+
+            // Loads a tile inserted by insert() with the lock released
+            void fill(std::size_t index, const std::shared_ptr<Tile>& tile, std::unique_lock<std::mutex>& lock) const {
+                lock.unlock();
+                std::exception_ptr error;
+                try {
+                    load(index, *tile);
+                } catch (...) {
+                    error = std::current_exception();
+                }
+                lock.lock();
+                if (error) {
+                    tile->failed = true;
+                    _lru.erase(tile->lru);
+                    _tiles.erase(index);
+                } else {
+                    tile->ready = true;
+                }
+                _loaded.notify_all();
+                if (error) {
+                    std::rethrow_exception(error);
+                }
+            }
+
+            // The tile, loaded, marked most recently used. Called with the
+            // lock held.
+            std::shared_ptr<Tile> get(std::size_t index, std::unique_lock<std::mutex>& lock) const {
+                if (index >= num_tiles()) {
+                    throw_paging_error(_path, "element out of range");
+                }
+                while (true) {
+                    auto it = _tiles.find(index);
+                    if (it == _tiles.end()) {
+                        auto tile = insert(index);
+                        schedule_prefetch(index);
+                        _last_miss = index;
+                        fill(index, tile, lock);
+                        return tile;
+                    }
+                    std::shared_ptr<Tile> tile = it->second;
+                    if (!tile->ready) {
+                        _loaded.wait(lock, [&] { return tile->ready || tile->failed; });
+                        continue; // reloaded if it failed
+                    }
+                    _lru.splice(_lru.begin(), _lru, tile->lru);
+                    if (tile->prefetched) {
+                        // the traversal caught up with the prefetched tiles
+                        tile->prefetched = false;
+                        schedule_prefetch(index);
+                    }
+                    return tile;
+                }
+            }
+
+            // Queues the tiles after `index` in the direction of the last
+            // two misses, replacing the requests of earlier misses
+            void schedule_prefetch(std::size_t index) const {
+                if (_prefetch == 0) {
+                    return;
+                }
+                _prefetch_queue.clear();
+                const bool backward = index < _last_miss;
+                for (std::size_t d = 1; d <= _prefetch; ++d) {
+                    if (backward ? index < d : index + d >= num_tiles()) {
+                        break;
+                    }
+                    const std::size_t next = backward ? index - d : index + d;
+                    if (!_tiles.contains(next)) {
+                        _prefetch_queue.push_back(next);
+                    }
+                }
+                _prefetch_cv.notify_one();
+            }
+
+            void prefetch_loop() {
+                std::unique_lock lock(_mutex);
+                while (true) {
+                    _prefetch_cv.wait(lock, [this] { return _stop || !_prefetch_queue.empty(); });
+                    if (_stop) {
+                        return;
+                    }
+                    const std::size_t index = _prefetch_queue.front();
+                    _prefetch_queue.pop_front();
+                    if (_tiles.contains(index)) {
+                        continue;
+                    }
+                    auto tile = insert(index);
+                    tile->prefetched = true;
+                    try {
+                        fill(index, tile, lock);
+                    } catch (...) {
+                        // the demand load reports the error
+                    }
+                }
+            }
+    };
+
+} // namespace detail
+
+// Data handle of a paged tensor: the shared tile cache and the element offset
+template <typename T>
+struct paged_handle {
+    std::shared_ptr<detail::TileCache<std::remove_const_t<T>>> cache;
+    std::size_t offset = 0;
+
+    // writes modified tiles back to the file
+    void flush() const { cache->flush(); }
+};
+
+// Proxy reference to an element of a writable paged tensor
+template <typename T>
+class paged_reference {
+    detail::TileCache<T>* _cache;
+    std::size_t _index;
+
+    public:
+        paged_reference(detail::TileCache<T>* cache, std::size_t index) noexcept
+            : _cache(cache), _index(index) {}
+
+        paged_reference(const paged_reference&) = default;
+
+        operator T() const { return _cache->read(_index); }
+
+        const paged_reference& operator=(const T& value) const {
+            _cache->write(_index, value);
+            return *this;
+        }
+
+        const paged_reference& operator=(const paged_reference& other) const {
+            return *this = static_cast<T>(other);
+        }
+
+        const paged_reference& operator+=(const T& value) const { return *this = static_cast<T>(*this) + value; }
+        const paged_reference& operator-=(const T& value) const { return *this = static_cast<T>(*this) - value; }
+        const paged_reference& operator*=(const T& value) const { return *this = static_cast<T>(*this) * value; }
+        const paged_reference& operator/=(const T& value) const { return *this = static_cast<T>(*this) / value; }
+};
+
+template <typename T>
+class paging_accessor;
+
+template <typename T>
+class paging_accessor<const T> {
+    public:
+        using element_type = const T;
+        using reference = T;
+        using data_handle_type = paged_handle<const T>;
+        using offset_policy = paging_accessor;
+        using read_accessor_type = paging_accessor;
+        using write_accessor_type = paging_accessor<T>;
+
+        constexpr paging_accessor() noexcept = default;
+
+        template <typename OtherElementType>
+            requires std::is_convertible_v<OtherElementType(*)[], element_type(*)[]>
+        constexpr paging_accessor(paging_accessor<OtherElementType>) noexcept {}
+
+        reference access(const data_handle_type& p, std::size_t i) const {
+            return p.cache->read(p.offset + i);
+        }
+
+        data_handle_type offset(const data_handle_type& p, std::size_t i) const noexcept {
+            return {p.cache, p.offset + i};
+        }
+
+        write_accessor_type to_write() const noexcept {
+            return {};
+        }
+};
+
+// Data handles of const and non-const paged tensors are interchangeable, so
+// that the non-const span can be sliced to its const base
+template <typename T>
+class paging_accessor : public paging_accessor<const T> {
+    public:
+        using element_type = T;
+        using reference = paged_reference<T>;
+        using data_handle_type = paged_handle<const T>;
+        using offset_policy = paging_accessor;
+        using read_accessor_type = paging_accessor<const T>;
+        using write_accessor_type = paging_accessor;
+
+        constexpr paging_accessor() noexcept = default;
+
+        template <typename OtherElementType>
+            requires std::is_convertible_v<OtherElementType(*)[], element_type(*)[]>
+        constexpr paging_accessor(paging_accessor<OtherElementType>) noexcept {}
+
+        reference access(const data_handle_type& p, std::size_t i) const noexcept {
+            return {p.cache.get(), p.offset + i};
+        }
+
+        data_handle_type offset(const data_handle_type& p, std::size_t i) const noexcept {
+            return {p.cache, p.offset + i};
+        }
+
+        write_accessor_type to_write() const noexcept {
+            return {};
+        }
+};
+
+// Pages the tensor file at `path`, as written by write_tensor. The file's
+// checksum is not verified, as the tensor is never read in full at once,
+// but flushing written tiles updates it, rereading the file.
+template <typename ElementType, typename Extents, typename LayoutPolicy = LeftStride>
+    requires std::is_trivially_copyable_v<ElementType>
+TensorSpan<ElementType, Extents, LayoutPolicy, paging_accessor<ElementType>>
+paged_tensor(const std::filesystem::path& path, const paging_options& options = {}) {
+    using T = std::remove_const_t<ElementType>;
+    using index_type = typename Extents::index_type;
+    using mapping_type = typename LayoutPolicy::template mapping<Extents>;
+    constexpr std::size_t rank = Extents::rank();
+
+    std::array<index_type, rank> exts;
+    std::array<index_type, rank> strides;
+    std::size_t size = 1;
+    std::optional<detail::tensor_file_header> header;
+    {
+        detail::binary_file file(path, detail::file_mode::read);
+        const auto info = detail::read_tensor_file_info<T, rank>(file, path);
+        for (std::size_t r = 0; r < rank; ++r) {
+            if (Extents::static_extent(r) != std::dynamic_extent && Extents::static_extent(r) != info.extents[r]) {
+                detail::throw_paging_error(path, "extent " + std::to_string(r) + " does not match the static extent");
+            }
+            exts[r] = static_cast<index_type>(info.extents[r]);
+            strides[r] = static_cast<index_type>(info.strides[r]);
+            size *= static_cast<std::size_t>(info.extents[r]);
+        }
+        header = info.header;
+    }
+    if (std::filesystem::file_size(path) < header->data_offset + size * sizeof(T)) {
+        detail::throw_paging_error(path, "file is truncated");
+    }
+    auto cache = std::make_shared<detail::TileCache<T>>(path, !std::is_const_v<ElementType>, header->data_offset, size,
+                                                        options, header);
+    using span_type = TensorSpan<ElementType, Extents, LayoutPolicy, paging_accessor<ElementType>>;
+    return span_type(paged_handle<const T>{std::move(cache), 0}, mapping_type(Extents(exts), strides));
+}
+
+// Pages the raw elements at byte `offset` of the file at `path`, laid out by
+// the default strides of LayoutPolicy for `exts`
+template <typename ElementType, typename Extents, typename LayoutPolicy = LeftStride>
+    requires std::is_trivially_copyable_v<ElementType>
+TensorSpan<ElementType, Extents, LayoutPolicy, paging_accessor<ElementType>>
+paged_tensor(const std::filesystem::path& path, const Extents& exts, std::size_t offset = 0,
+             const paging_options& options = {}) {
+    using T = std::remove_const_t<ElementType>;
+    using mapping_type = typename LayoutPolicy::template mapping<Extents>;
+    const mapping_type map(exts);
+    const std::size_t size = map.required_span_size();
+    if (std::filesystem::file_size(path) < offset + size * sizeof(T)) {
+        detail::throw_paging_error(path, "file holds fewer elements than the extents");
+    }
+    auto cache = std::make_shared<detail::TileCache<T>>(path, !std::is_const_v<ElementType>, offset, size, options);
+    using span_type = TensorSpan<ElementType, Extents, LayoutPolicy, paging_accessor<ElementType>>;
+    return span_type(paged_handle<const T>{std::move(cache), 0}, map);
+}
+
+} // namespace nabla
+
+#endif // NABLA_PAGING_ACCESSOR_HPP
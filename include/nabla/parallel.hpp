@@ -0,0 +1,271 @@
+#ifndef NABLA_PARALLEL_HPP
+#define NABLA_PARALLEL_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdlib>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace nabla {
+
+// Fixed-size pool of worker threads fed from a single task queue. Threads
+// that wait on a parallel_for run queued tasks in the meantime, so nested
+// parallel regions cannot deadlock the pool.
+class ThreadPool {
+    std::vector<std::thread> _workers;
+    std::deque<std::function<void()>> _tasks;
+    std::mutex _mutex;
+    std::condition_variable _cv;
+    bool _stop = false;
+
+    public:
+        explicit ThreadPool(unsigned num_workers) {
+            _workers.reserve(num_workers);
+            for (unsigned i = 0; i < num_workers; ++i) {
+                _workers.emplace_back([this] { worker_loop(); });
+            }
+        }
+
+        ThreadPool(const ThreadPool&) = delete;
+        ThreadPool& operator=(const ThreadPool&) = delete;
+
+        ~ThreadPool() {
+            {
+                std::lock_guard lock(_mutex);
+                _stop = true;
+            }
+            _cv.notify_all();
+            for (auto& worker : _workers) {
+                worker.join();
+            }
+        }
+
+        // Process-wide pool. Sized by the NABLA_NUM_THREADS environment
+        // variable when set, otherwise by the hardware concurrency. The
+        // calling thread counts as one of the threads.
+        static ThreadPool& instance() {
+            static ThreadPool pool(default_num_workers());
+            return pool;
+        }
+
+        unsigned num_workers() const noexcept { return static_cast<unsigned>(_workers.size()); }
+
+        void submit(std::function<void()> task) {
+            {
+                std::lock_guard lock(_mutex);
+                _tasks.push_back(std::move(task));
+            }
+            _cv.notify_one();
+        }
+
+        // runs one queued task on the calling thread, if there is one
+        bool try_run_one() {
+            std::function<void()> task;
+            {
+                std::lock_guard lock(_mutex);
+                if (_tasks.empty()) {
+                    return false;
+                }
+                task = std::move(_tasks.front());
+                _tasks.pop_front();
+            }
+            task();
+            return true;
+        }
+
+    private:
+        static unsigned default_num_workers() {
+            unsigned num_threads = std::thread::hardware_concurrency();
+            if (const char* env = std::getenv("NABLA_NUM_THREADS")) {
+                num_threads = static_cast<unsigned>(std::strtoul(env, nullptr, 10));
+            }
+            return num_threads > 1 ? num_threads - 1 : 0;
+        }
+
+        void worker_loop() {
+            while (true) {
+                std::function<void()> task;
+                {
+                    std::unique_lock lock(_mutex);
+                    _cv.wait(lock, [this] { return _stop || !_tasks.empty(); });
+                    if (_stop && _tasks.empty()) {
+                        return;
+                    }
+                    task = std::move(_tasks.front());
+                    _tasks.pop_front();
+                }
+                task();
+            }
+        }
+};
+
+//
+// Execution policies
+//
+// Elements ahead that strided traversals prefetch by default, enough to
+// cover memory latency at a few nanoseconds per element
+inline constexpr std::size_t default_prefetch_distance = 16;
+
+struct sequenced_policy {
+    // elements ahead that strided rows prefetch, 0 for none
+    std::size_t prefetch_distance = default_prefetch_distance;
+
+    constexpr sequenced_policy with_prefetch_distance(std::size_t n) const noexcept {
+        sequenced_policy p = *this;
+        p.prefetch_distance = n;
+        return p;
+    }
+};
+
+struct parallel_policy {
+    // minimum number of elements handed to a thread at once
+    std::size_t grain_size = std::size_t(1) << 14;
+    // below this many elements the work runs on the calling thread
+    std::size_t serial_cutoff = std::size_t(1) << 16;
+    // upper bound on the number of threads, 0 for the whole pool
+    unsigned num_threads = 0;
+    // pool to run on, nullptr for ThreadPool::instance()
+    ThreadPool* pool = nullptr;
+    // bytes of an assignment's destination above which it is written with
+    // streaming stores, 0 for the size of the last level cache
+    std::size_t streaming_threshold = 0;
+    // elements ahead that strided rows prefetch, 0 for none
+    std::size_t prefetch_distance = default_prefetch_distance;
+
+    constexpr parallel_policy with_grain_size(std::size_t n) const noexcept {
+        parallel_policy p = *this;
+        p.grain_size = n;
+        return p;
+    }
+
+    constexpr parallel_policy with_serial_cutoff(std::size_t n) const noexcept {
+        parallel_policy p = *this;
+        p.serial_cutoff = n;
+        return p;
+    }
+
+    constexpr parallel_policy with_threads(unsigned n) const noexcept {
+        parallel_policy p = *this;
+        p.num_threads = n;
+        return p;
+    }
+
+    constexpr parallel_policy with_streaming_threshold(std::size_t n) const noexcept {
+        parallel_policy p = *this;
+        p.streaming_threshold = n;
+        return p;
+    }
+
+    constexpr parallel_policy with_prefetch_distance(std::size_t n) const noexcept {
+        parallel_policy p = *this;
+        p.prefetch_distance = n;
+        return p;
+    }
+
+    constexpr parallel_policy on(ThreadPool& p) const noexcept {
+        parallel_policy q = *this;
+        q.pool = &p;
+        return q;
+    }
+};
+
+inline constexpr sequenced_policy seq{};
+inline constexpr parallel_policy par{};
+
+template <typename T>
+concept IsExecutionPolicy =
+    std::is_same_v<std::remove_cvref_t<T>, sequenced_policy> ||
+    std::is_same_v<std::remove_cvref_t<T>, parallel_policy>;
+
+// Number of threads, the caller included, that work under the policy
+inline std::size_t max_threads(const parallel_policy& policy) {
+    ThreadPool& pool = policy.pool ? *policy.pool : ThreadPool::instance();
+    std::size_t num_threads = std::size_t(pool.num_workers()) + 1;
+    if (policy.num_threads != 0) {
+        num_threads = std::min<std::size_t>(num_threads, policy.num_threads);
+    }
+    return num_threads;
+}
+
+// Calls f(begin, end) over a partition of [0, count) into chunks of `grain`
+// elements. Chunks are claimed dynamically by the calling thread and up to
+// num_threads - 1 pool workers. The first exception thrown is rethrown.
+template <typename F>
+void parallel_for(const parallel_policy& policy, std::size_t count, std::size_t grain, F&& f) {
+    ThreadPool& pool = policy.pool ? *policy.pool : ThreadPool::instance();
+    grain = std::max<std::size_t>(grain, 1);
+    const std::size_t num_chunks = (count + grain - 1) / grain;
+    const std::size_t num_threads = std::min(max_threads(policy), num_chunks);
+    if (count < policy.serial_cutoff || num_threads <= 1) {
+        if (count > 0) {
+            f(std::size_t(0), count);
+        }
+        return;
+    }
+
+    std::atomic<std::size_t> next_chunk{0};
+    std::atomic<std::size_t> pending{num_threads - 1};
+    std::exception_ptr error;
+    std::mutex mutex;
+    std::condition_variable done;
+
+    auto work = [&] {
+        std::size_t chunk;
+        while ((chunk = next_chunk.fetch_add(1, std::memory_order_relaxed)) < num_chunks) {
+            const std::size_t begin = chunk * grain;
+            try {
+                f(begin, std::min(begin + grain, count));
+            } catch (...) {
+                std::lock_guard lock(mutex);
+                if (!error) {
+                    error = std::current_exception();
+                }
+                next_chunk.store(num_chunks, std::memory_order_relaxed);
+            }
+        }
+    };
+
+    for (std::size_t t = 1; t < num_threads; ++t) {
+        pool.submit([&] {
+            work();
+            // decrement under the lock so this frame outlives the notify
+            std::lock_guard lock(mutex);
+            if (pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+                done.notify_all();
+            }
+        });
+    }
+    work();
+    while (true) {
+        {
+            std::unique_lock lock(mutex);
+            if (pending.load(std::memory_order_acquire) == 0) {
+                break;
+            }
+        }
+        if (pool.try_run_one()) {
+            continue;
+        }
+        // wake up periodically to help with tasks queued by nested regions
+        std::unique_lock lock(mutex);
+        if (done.wait_for(lock, std::chrono::milliseconds(1), [&] { return pending.load(std::memory_order_acquire) == 0; })) {
+            break;
+        }
+    }
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+} // namespace nabla
+
+#endif // NABLA_PARALLEL_HPP
@@ -0,0 +1,122 @@
+#ifndef NABLA_PERMUTE_HPP
+#define NABLA_PERMUTE_HPP
+
+#include <array>
+#include <cstddef>
+#include <sstream>
+#include <stacktrace>
+#include <stdexcept>
+#include <type_traits>
+#include "nabla/types.hpp"
+#include "nabla/conj_accessor.hpp"
+#include "nabla/utility/complex.hpp"
+
+// Views that reorder the dimensions of a tensor or conjugate its elements.
+// Only the mapping's extents and strides, or the accessor, change; the data
+// is shared with the original. Assigning a permuted view into plain memory
+// runs a cache-blocked copy (see make_tile_plan in expr_evaluator.hpp).
+
+namespace nabla {
+
+namespace detail {
+
+    template <std::size_t Rank>
+    void assert_permutation(const std::array<std::size_t, Rank>& perm) {
+        std::array<bool, Rank> seen{};
+        for (std::size_t r = 0; r < Rank; ++r) {
+            if (perm[r] >= Rank || seen[perm[r]]) {
+                std::stringstream ss;
+                ss << "nabla::permute error: not a permutation of the dimensions\n"
+                    << "\tpermutation: " << nabla::temp::to_string(perm) << "\n"
+                    << "\n\n"
+                    << std::stacktrace::current() << std::endl;
+                throw std::invalid_argument(ss.str());
+            }
+            seen[perm[r]] = true;
+        }
+    }
+
+    template <std::size_t Rank>
+    constexpr std::array<std::size_t, Rank> reversed_dims() noexcept {
+        std::array<std::size_t, Rank> perm{};
+        for (std::size_t r = 0; r < Rank; ++r) {
+            perm[r] = Rank - 1 - r;
+        }
+        return perm;
+    }
+
+} // namespace detail
+
+// View of t whose dimension r is dimension perm[r] of t
+template <typename ElementType, typename Extents, typename LayoutPolicy, typename AccessorPolicy>
+auto permute(const TensorSpan<ElementType, Extents, LayoutPolicy, AccessorPolicy>& t,
+             const std::array<std::size_t, Extents::rank()>& perm) {
+    using view_extents = dextents<typename Extents::index_type, Extents::rank()>;
+    using view_type = TensorSpan<ElementType, view_extents, LayoutPolicy, AccessorPolicy>;
+    using view_mapping = typename view_type::mapping_type;
+    detail::assert_permutation(perm);
+    typename view_mapping::coord_type exts;
+    typename view_mapping::coord_type strides;
+    for (std::size_t r = 0; r < Extents::rank(); ++r) {
+        exts[r] = t.extent(perm[r]);
+        strides[r] = t.stride(perm[r]);
+    }
+    return view_type(t.data_handle(), view_mapping(exts, strides), t.accessor());
+}
+
+template <typename ElementType, typename Extents, typename LayoutPolicy, typename Container>
+auto permute(TensorArray<ElementType, Extents, LayoutPolicy, Container>& t,
+             const std::array<std::size_t, Extents::rank()>& perm) {
+    return permute(t.to_span(), perm);
+}
+
+template <typename ElementType, typename Extents, typename LayoutPolicy, typename Container>
+auto permute(const TensorArray<ElementType, Extents, LayoutPolicy, Container>& t,
+             const std::array<std::size_t, Extents::rank()>& perm) {
+    return permute(t.to_span(), perm);
+}
+
+// View of t with the order of its dimensions reversed, the matrix transpose
+// for rank 2
+template <typename T>
+    requires IsTensorSpan<T> || IsTensorArray<T>
+auto transpose(T&& t) {
+    return permute(std::forward<T>(t), detail::reversed_dims<std::remove_cvref_t<T>::rank()>());
+}
+
+// Read-only view of the complex conjugate of t. Elements are conjugated as
+// they are read. Real tensors give a plain read-only view, and conjugating a
+// conjugated view gives back a view of the original elements.
+template <typename ElementType, typename Extents, typename LayoutPolicy, typename AccessorPolicy>
+auto conj(const TensorSpan<ElementType, Extents, LayoutPolicy, AccessorPolicy>& t) {
+    using value_type = std::remove_const_t<ElementType>;
+    using read_accessor = typename AccessorPolicy::read_accessor_type;
+    if constexpr (detail::is_conj_accessor<read_accessor>) {
+        using base_accessor = typename read_accessor::base_accessor_type;
+        return TensorSpan<const value_type, Extents, LayoutPolicy, base_accessor>(
+            t.data_handle(), t.mapping(), t.accessor().base());
+    } else if constexpr (utility::IsComplexFP<value_type>) {
+        using accessor = conj_accessor<read_accessor>;
+        return TensorSpan<const value_type, Extents, LayoutPolicy, accessor>(
+            t.data_handle(), t.mapping(), accessor(t.accessor()));
+    } else {
+        return TensorSpan<const value_type, Extents, LayoutPolicy, read_accessor>(
+            t.data_handle(), t.mapping(), t.accessor());
+    }
+}
+
+template <typename ElementType, typename Extents, typename LayoutPolicy, typename Container>
+auto conj(const TensorArray<ElementType, Extents, LayoutPolicy, Container>& t) {
+    return conj(t.to_span());
+}
+
+// Read-only view of the conjugate transpose of t
+template <typename T>
+    requires IsTensorSpan<T> || IsTensorArray<T>
+auto conj_transpose(const T& t) {
+    return conj(transpose(t));
+}
+
+} // namespace nabla
+
+#endif // NABLA_PERMUTE_HPP
@@ -0,0 +1,406 @@
+#ifndef NABLA_QUANTIZED_ACCESSOR_HPP
+#define NABLA_QUANTIZED_ACCESSOR_HPP
+
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <sstream>
+#include <stacktrace>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include "nabla/types.hpp"
+#include "nabla/concepts.hpp"
+#include "nabla/assign.hpp"
+#include "nabla/aligned_accessor.hpp"
+#include "nabla/tensor_span.hpp"
+
+// Fixed-point storage for fields that tolerate 8 or 16 bits of precision.
+// Elements are stored as integers q of type Q and read as the real values
+//
+//     x = (q - zero_point) * scale
+//
+// with one scale and zero point for the whole tensor, or one per channel
+// along an axis. Writes round x / scale + zero_point to the nearest level,
+// saturating at the range of Q. An expression over a quantized tensor reads
+// 1 or 2 bytes per element instead of 4 or 8:
+//
+//     std::vector<std::int8_t> store(nx * ny);
+//     auto x = nb::quantized_span<float, nb::dims<2>>(store.data(), {nx, ny}, {0.05f, 0});
+//     nb::quantize(x, field);            // bulk, from a float tensor
+//     double e = nb::sum(x * x);         // dequantized on the fly
+//
+// The data handle tracks the element offset from the first element of the
+// tensor, so that subspans find the channel of their elements.
+
+namespace nabla {
+
+template <typename T>
+    requires std::floating_point<T>
+struct quantization {
+    T scale = 1;
+    std::int32_t zero_point = 0;
+};
+
+namespace detail {
+
+    template <typename T, typename Q>
+    inline constexpr T quantized_min = static_cast<T>(std::numeric_limits<Q>::min());
+
+    template <typename T, typename Q>
+    inline constexpr T quantized_max = static_cast<T>(std::numeric_limits<Q>::max());
+
+    template <typename T, typename Q>
+    constexpr T dequantize_value(Q q, const quantization<T>& p) noexcept {
+        return static_cast<T>(static_cast<std::int32_t>(q) - p.zero_point) * p.scale;
+    }
+
+    // Rounds half to even by adding and subtracting 1.5 * 2^(digits - 1),
+    // which is exact for the levels of 8 and 16 bit types and, unlike
+    // std::nearbyint, vectorizes without SSE4.1. Fast math would fold the
+    // trick away. NaN fails the first comparison and saturates to the lowest
+    // level.
+    template <typename T, typename Q>
+    constexpr Q quantize_value(T x, const quantization<T>& p) noexcept {
+        T v = x / p.scale + static_cast<T>(p.zero_point);
+        v = v > quantized_min<T, Q> ? v : quantized_min<T, Q>;
+        v = v < quantized_max<T, Q> ? v : quantized_max<T, Q>;
+#if defined(__FAST_MATH__)
+        return static_cast<Q>(std::nearbyint(v));
+#else
+        constexpr T magic = T(1.5) * static_cast<T>(std::uint64_t(1) << (std::numeric_limits<T>::digits - 1));
+        return static_cast<Q>((v + magic) - magic);
+#endif
+    }
+
+    // Quantizes n contiguous elements with the same parameters
+    template <typename T, typename Q>
+    void quantize_n(const T* in, Q* out, std::size_t n, quantization<T> p) noexcept {
+        for (std::size_t k = 0; k < n; ++k) {
+            out[k] = quantize_value<T, Q>(in[k], p);
+        }
+    }
+
+    template <typename T, typename Q>
+    void dequantize_n(const Q* in, T* out, std::size_t n, quantization<T> p) noexcept {
+        for (std::size_t k = 0; k < n; ++k) {
+            out[k] = dequantize_value<T, Q>(in[k], p);
+        }
+    }
+
+    // Dequantizes the elements of a row, whose parameters are constant
+    // unless the row runs across channels
+    template <typename T, typename Q>
+    struct quantized_row_decoder {
+        quantization<T> params;
+        const quantization<T>* channels = nullptr;
+        std::size_t first = 0;
+        std::ptrdiff_t stride = 0;
+        std::size_t channel_stride = 1;
+        std::size_t num_channels = 1;
+
+        T operator()(Q q, std::ptrdiff_t i) const noexcept {
+            if (channels == nullptr) {
+                return dequantize_value<T, Q>(q, params);
+            }
+            const std::size_t offset = first + static_cast<std::size_t>(i * stride);
+            return dequantize_value<T, Q>(q, channels[offset / channel_stride % num_channels]);
+        }
+    };
+
+    [[noreturn]] inline void throw_quantization_error(const std::string& what) {
+        std::stringstream ss;
+        ss << "nabla::quantized_span error: " << what
+            << "\n\n"
+            << std::stacktrace::current() << std::endl;
+        throw std::invalid_argument(ss.str());
+    }
+
+} // namespace detail
+
+// Data handle of a quantized tensor: the integer storage and the offset of
+// the handle's element from the first one
+template <typename Q>
+struct quantized_handle {
+    Q* data = nullptr;
+    std::size_t offset = 0;
+
+    constexpr quantized_handle() noexcept = default;
+    constexpr quantized_handle(Q* p, std::size_t i = 0) noexcept
+        : data(p), offset(i) {}
+};
+
+template <typename T, typename Q>
+class quantized_accessor;
+
+template <typename T, typename Q>
+class quantized_reference;
+
+// Parameters are shared by copies of the accessor, the per-channel ones
+// through a shared_ptr. Channel c covers the elements whose offset o has
+// (o / channel_stride) % channels == c, which is the index along the
+// channel axis for exhaustive layouts.
+template <typename T, typename Q>
+class quantized_accessor<const T, Q> {
+    static_assert(std::floating_point<T>, "nabla::quantized_accessor: elements must be floating point");
+    static_assert(std::signed_integral<Q> && sizeof(Q) <= 2, "nabla::quantized_accessor: storage must be int8_t or int16_t");
+
+    public:
+        using element_type = const T;
+        using reference = T;
+        using data_handle_type = quantized_handle<Q>;
+        using offset_policy = quantized_accessor;
+        using read_accessor_type = quantized_accessor;
+        using write_accessor_type = quantized_accessor<T, Q>;
+        using storage_type = Q;
+
+    private:
+        quantization<T> _params;
+        std::shared_ptr<const std::vector<quantization<T>>> _channels;
+        const quantization<T>* _channel_params = nullptr;
+        std::size_t _channel_stride = 1;
+        std::size_t _num_channels = 1;
+
+    public:
+        constexpr quantized_accessor() noexcept = default;
+
+        constexpr quantized_accessor(const quantization<T>& params) noexcept
+            : _params(params) {}
+
+        quantized_accessor(std::vector<quantization<T>> channels, std::size_t channel_stride)
+            : _channels(std::make_shared<const std::vector<quantization<T>>>(std::move(channels))),
+              _channel_params(_channels->data()),
+              _channel_stride(channel_stride),
+              _num_channels(_channels->size()) {
+            if (_num_channels == 0 || channel_stride == 0) {
+                detail::throw_quantization_error("no channels");
+            }
+        }
+
+        bool per_channel() const noexcept { return _channel_params != nullptr; }
+        std::size_t channel_stride() const noexcept { return _channel_stride; }
+        std::size_t num_channels() const noexcept { return _num_channels; }
+
+        // parameters of the element at `offset` from the first one
+        const quantization<T>& params(std::size_t offset = 0) const noexcept {
+            if (_channel_params == nullptr) {
+                return _params;
+            }
+            return _channel_params[offset / _channel_stride % _num_channels];
+        }
+
+        reference access(const data_handle_type& p, std::size_t i) const noexcept {
+            return detail::dequantize_value<T, Q>(p.data[p.offset + i], params(p.offset + i));
+        }
+
+        constexpr data_handle_type offset(const data_handle_type& p, std::size_t i) const noexcept {
+            return {p.data, p.offset + i};
+        }
+
+        write_accessor_type to_write() const noexcept {
+            return write_accessor_type(*this);
+        }
+
+        // Decoding in the evaluator, see detail::HasRowDecoder
+        Q* storage_pointer(const data_handle_type& p) const noexcept {
+            return p.data + p.offset;
+        }
+
+        detail::quantized_row_decoder<T, Q> row_decoder(const data_handle_type& p, std::size_t offset, std::ptrdiff_t stride) const noexcept {
+            const std::size_t first = p.offset + offset;
+            if (_channel_params == nullptr) {
+                return {_params};
+            }
+            const std::size_t step = static_cast<std::size_t>(stride < 0 ? -stride : stride);
+            if (step < _channel_stride) {
+                // within one channel along the other axes of an exhaustive layout
+                return {params(first)};
+            }
+            return {params(first), _channel_params, first, stride, _channel_stride, _num_channels};
+        }
+};
+
+template <typename T, typename Q>
+class quantized_accessor : public quantized_accessor<const T, Q> {
+    public:
+        using base_type = quantized_accessor<const T, Q>;
+        using element_type = T;
+        using reference = quantized_reference<T, Q>;
+        using data_handle_type = quantized_handle<Q>;
+        using offset_policy = quantized_accessor;
+        using read_accessor_type = base_type;
+        using write_accessor_type = quantized_accessor;
+
+        using base_type::base_type;
+
+        constexpr quantized_accessor() noexcept = default;
+
+        constexpr explicit quantized_accessor(const base_type& other) noexcept
+            : base_type(other) {}
+
+        reference access(const data_handle_type& p, std::size_t i) const noexcept {
+            return {p.data + p.offset + i, this->params(p.offset + i)};
+        }
+
+        constexpr data_handle_type offset(const data_handle_type& p, std::size_t i) const noexcept {
+            return {p.data, p.offset + i};
+        }
+
+        write_accessor_type to_write() const noexcept {
+            return *this;
+        }
+};
+
+// Proxy reference to an element of a writable quantized tensor
+template <typename T, typename Q>
+class quantized_reference {
+    Q* _q;
+    quantization<T> _params;
+
+    public:
+        quantized_reference(Q* q, const quantization<T>& params) noexcept
+            : _q(q), _params(params) {}
+
+        quantized_reference(const quantized_reference&) = default;
+
+        operator T() const noexcept { return detail::dequantize_value<T, Q>(*_q, _params); }
+
+        const quantized_reference& operator=(const T& value) const noexcept {
+            *_q = detail::quantize_value<T, Q>(value, _params);
+            return *this;
+        }
+
+        const quantized_reference& operator=(const quantized_reference& other) const noexcept {
+            return *this = static_cast<T>(other);
+        }
+
+        const quantized_reference& operator+=(const T& value) const noexcept { return *this = static_cast<T>(*this) + value; }
+        const quantized_reference& operator-=(const T& value) const noexcept { return *this = static_cast<T>(*this) - value; }
+        const quantized_reference& operator*=(const T& value) const noexcept { return *this = static_cast<T>(*this) * value; }
+        const quantized_reference& operator/=(const T& value) const noexcept { return *this = static_cast<T>(*this) / value; }
+};
+
+namespace detail {
+
+    template <typename Accessor>
+    inline constexpr bool is_quantized_accessor = false;
+
+    template <typename T, typename Q>
+    inline constexpr bool is_quantized_accessor<quantized_accessor<T, Q>> = true;
+
+    template <typename S>
+    concept IsQuantized = (IsTensorSpan<S> && is_quantized_accessor<typename std::remove_cvref_t<S>::accessor_type>);
+
+    // Calls f(offset, length, params) for runs of the quantized span q that
+    // are contiguous in memory, share their parameters, and sit at the same
+    // offsets in `plain`, which has the strides of q
+    template <typename S, typename F>
+    void for_each_quantized_run(const S& q, F&& f) {
+        const auto& accessor = q.accessor();
+        const std::size_t origin = q.data_handle().offset;
+        const auto [dims, run] = contiguous_prefix(q.mapping());
+        for_each_run(q.mapping(), dims, [&](auto offset) {
+            std::size_t i = static_cast<std::size_t>(offset);
+            const std::size_t end = i + run;
+            while (i < end) {
+                std::size_t next = end;
+                if (accessor.per_channel()) {
+                    const std::size_t stride = accessor.channel_stride();
+                    next = std::min(end, ((origin + i) / stride + 1) * stride - origin);
+                }
+                f(i, next - i, accessor.params(origin + i));
+                i = next;
+            }
+        });
+    }
+
+} // namespace detail
+
+// Quantized view of `data` with a single scale and zero point
+template <typename T, typename Extents, typename LayoutPolicy = LeftStride, typename Q>
+TensorSpan<T, Extents, LayoutPolicy, quantized_accessor<T, Q>>
+quantized_span(Q* data, const typename LayoutPolicy::template mapping<Extents>& map, const quantization<T>& params) {
+    using accessor_type = quantized_accessor<T, Q>;
+    return {quantized_handle<Q>(data), map, accessor_type(params)};
+}
+
+// Quantized view of `data` with one scale and zero point per index along
+// `axis`. The layout must be exhaustive.
+template <typename T, typename Extents, typename LayoutPolicy = LeftStride, typename Q>
+TensorSpan<T, Extents, LayoutPolicy, quantized_accessor<T, Q>>
+quantized_span(Q* data, const typename LayoutPolicy::template mapping<Extents>& map,
+               std::vector<quantization<T>> channels, std::size_t axis) {
+    using accessor_type = quantized_accessor<T, Q>;
+    if (axis >= Extents::rank()) {
+        detail::throw_quantization_error("axis " + std::to_string(axis) + " out of range");
+    }
+    if (channels.size() != static_cast<std::size_t>(map.extents().extent(axis))) {
+        detail::throw_quantization_error(std::to_string(channels.size()) + " channels for an extent of " +
+                                         std::to_string(map.extents().extent(axis)));
+    }
+    if (!map.is_exhaustive()) {
+        detail::throw_quantization_error("per-channel parameters need an exhaustive layout");
+    }
+    const std::size_t stride = static_cast<std::size_t>(map.stride(axis));
+    return {quantized_handle<Q>(data), map, accessor_type(std::move(channels), stride == 0 ? 1 : stride)};
+}
+
+// Quantizes src into dst. Sources in plain memory with the strides of dst
+// are converted a contiguous run at a time, in vectorizable loops; others,
+// such as expressions, are assigned elementwise.
+template <typename Dst, typename Src>
+    requires detail::IsQuantized<Dst> && IsTensorLike<Src>
+void quantize(Dst&& dst, const Src& src) {
+    using dst_type = std::remove_cvref_t<Dst>;
+    using value_type = typename dst_type::value_type;
+    using storage_type = typename dst_type::accessor_type::storage_type;
+#ifdef NABLA_DEBUG
+    detail::assert_same_extents(dst, src, "nabla::quantize");
+#endif
+    if constexpr (detail::IsPointerBacked<Src>) {
+        if constexpr (std::is_same_v<typename Src::value_type, value_type>) {
+            if (detail::same_strides(dst.mapping(), src.mapping())) {
+                const value_type* in = detail::data_pointer(src);
+                storage_type* out = dst.data_handle().data + dst.data_handle().offset;
+                detail::for_each_quantized_run(dst, [&](std::size_t i, std::size_t n, const quantization<value_type>& p) {
+                    detail::quantize_n(in + i, out + i, n, p);
+                });
+                return;
+            }
+        }
+    }
+    assign(dst, src);
+}
+
+// Dequantizes src into dst, the counterpart of quantize
+template <typename Dst, typename Src>
+    requires (IsTensorSpan<Dst> || IsTensorArray<Dst>) && detail::IsQuantized<Src>
+void dequantize(Dst&& dst, const Src& src) {
+    using dst_type = std::remove_cvref_t<Dst>;
+    using value_type = typename Src::value_type;
+    using storage_type = typename Src::accessor_type::storage_type;
+#ifdef NABLA_DEBUG
+    detail::assert_same_extents(dst, src, "nabla::dequantize");
+#endif
+    if constexpr (detail::IsPointerBacked<dst_type>) {
+        if constexpr (std::is_same_v<typename dst_type::value_type, value_type>) {
+            if (detail::same_strides(dst.mapping(), src.mapping())) {
+                const storage_type* in = src.data_handle().data + src.data_handle().offset;
+                value_type* out = detail::data_pointer(dst);
+                detail::for_each_quantized_run(src, [&](std::size_t i, std::size_t n, const quantization<value_type>& p) {
+                    detail::dequantize_n(in + i, out + i, n, p);
+                });
+                return;
+            }
+        }
+    }
+    assign(dst, src);
+}
+
+} // namespace nabla
+
+#endif // NABLA_QUANTIZED_ACCESSOR_HPP
@@ -0,0 +1,455 @@
+#ifndef NABLA_REDUCE_HPP
+#define NABLA_REDUCE_HPP
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <complex>
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <sstream>
+#include <stacktrace>
+#include <stdexcept>
+#include <type_traits>
+#include "nabla/types.hpp"
+#include "nabla/concepts.hpp"
+#include "nabla/elementwise_expr.hpp"
+#include "nabla/expr_evaluator.hpp"
+#include "nabla/assign.hpp"
+#include "nabla/parallel.hpp"
+
+// Reductions over tensors and expressions. The operand is lowered to the same
+// kernel tree used for assignment, so sum(a*b) reads a and b once and never
+// materializes a*b. Each line is folded into a cache line's worth of
+// independent accumulators, which breaks the dependency chain and lets the
+// compiler keep them in vector registers. Under the parallel policy every
+// chunk produces a partial result and the partials are merged in order, so
+// the result only depends on the grain size, not on the thread count.
+
+namespace nabla {
+
+template <typename T>
+concept IsReducible = IsTensorLike<T> && (std::remove_cvref_t<T>::rank() > 0);
+
+namespace detail {
+
+    template <typename T>
+    using lowered_t = decltype(lower(std::declval<const std::remove_cvref_t<T>&>()));
+
+    // value type produced by an operand, which for an expression is the
+    // result type of its operation
+    template <typename T>
+    using reduce_value_t = std::remove_cvref_t<decltype(std::declval<const lowered_t<T>&>().at(0))>;
+
+    template <typename T>
+    struct magnitude_type { using type = T; };
+
+    template <typename T>
+    struct magnitude_type<std::complex<T>> { using type = T; };
+
+    template <typename T>
+    using magnitude_t = typename magnitude_type<T>::type;
+
+    template <typename T>
+    constexpr magnitude_t<T> abs2(const T& x) {
+        if constexpr (std::is_same_v<T, magnitude_t<T>>) {
+            return x * x;
+        } else {
+            return std::norm(x);
+        }
+    }
+
+    template <typename T>
+    constexpr magnitude_t<T> magnitude(const T& x) {
+        if constexpr (std::is_unsigned_v<T>) {
+            return x;
+        } else {
+            using std::abs;
+            return abs(x);
+        }
+    }
+
+    //
+    // Reducers
+    //
+    // A reducer folds values into an accumulator with combine(acc, x, pos),
+    // where pos is the left-major linear position of x, and joins two
+    // accumulators with merge(a, b), where a holds the earlier positions.
+    // identity() must be neutral for both.
+    //
+    template <typename T>
+    struct SumReducer {
+        using acc_type = T;
+        acc_type identity() const { return acc_type(0); }
+        acc_type combine(const acc_type& acc, const T& x, std::size_t) const { return acc + x; }
+        acc_type merge(const acc_type& a, const acc_type& b) const { return a + b; }
+    };
+
+    template <typename T>
+    struct SumSquaresReducer {
+        using acc_type = magnitude_t<T>;
+        acc_type identity() const { return acc_type(0); }
+        acc_type combine(const acc_type& acc, const T& x, std::size_t) const { return acc + abs2(x); }
+        acc_type merge(const acc_type& a, const acc_type& b) const { return a + b; }
+    };
+
+    // Extreme values of T, infinite where T has them so that min and max of
+    // infinite elements are exact
+    template <typename T>
+    constexpr T greatest_value() noexcept {
+        if constexpr (std::numeric_limits<T>::has_infinity) {
+            return std::numeric_limits<T>::infinity();
+        } else {
+            return std::numeric_limits<T>::max();
+        }
+    }
+
+    template <typename T>
+    constexpr T least_value() noexcept {
+        if constexpr (std::numeric_limits<T>::has_infinity) {
+            return -std::numeric_limits<T>::infinity();
+        } else {
+            return std::numeric_limits<T>::lowest();
+        }
+    }
+
+    template <typename T>
+    struct MinReducer {
+        using acc_type = T;
+        acc_type identity() const { return greatest_value<T>(); }
+        acc_type combine(const acc_type& acc, const T& x, std::size_t) const { return x < acc ? x : acc; }
+        acc_type merge(const acc_type& a, const acc_type& b) const { return b < a ? b : a; }
+    };
+
+    template <typename T>
+    struct MaxReducer {
+        using acc_type = T;
+        acc_type identity() const { return least_value<T>(); }
+        acc_type combine(const acc_type& acc, const T& x, std::size_t) const { return acc < x ? x : acc; }
+        acc_type merge(const acc_type& a, const acc_type& b) const { return a < b ? b : a; }
+    };
+
+    template <typename T>
+    struct MaxMagnitudeReducer {
+        using acc_type = magnitude_t<T>;
+        acc_type identity() const { return acc_type(0); }
+        acc_type combine(const acc_type& acc, const T& x, std::size_t) const {
+            const acc_type m = magnitude(x);
+            return acc < m ? m : acc;
+        }
+        acc_type merge(const acc_type& a, const acc_type& b) const { return a < b ? b : a; }
+    };
+
+    template <typename T>
+    struct ArgValue {
+        static constexpr std::size_t npos = std::numeric_limits<std::size_t>::max();
+        T value;
+        std::size_t position = npos;
+    };
+
+    // Tracks the first position whose value is preferred by Compare. Ties
+    // go to the smaller position so that the result does not depend on how
+    // the work was split.
+    template <typename T, typename Compare>
+    struct ArgReducer {
+        using acc_type = ArgValue<T>;
+        acc_type identity() const { return acc_type{T{}, acc_type::npos}; }
+        acc_type combine(const acc_type& acc, const T& x, std::size_t pos) const {
+            return (acc.position == acc_type::npos || Compare{}(x, acc.value)) ? acc_type{x, pos} : acc;
+        }
+        acc_type merge(const acc_type& a, const acc_type& b) const {
+            if (b.position == acc_type::npos) {
+                return a;
+            }
+            if (a.position == acc_type::npos || Compare{}(b.value, a.value) ||
+                (!Compare{}(a.value, b.value) && b.position < a.position)) {
+                return b;
+            }
+            return a;
+        }
+    };
+
+    struct AllReducer {
+        using acc_type = bool;
+        acc_type identity() const { return true; }
+        acc_type combine(acc_type acc, bool x, std::size_t) const { return acc & x; }
+        acc_type merge(acc_type a, acc_type b) const { return a & b; }
+    };
+
+    // |a - b| <= atol + rtol*|b|, as in numpy.isclose. NaNs are never close.
+    template <typename Real>
+    struct IsClose {
+        Real rtol;
+        Real atol;
+
+        template <typename A, typename B>
+        bool operator()(const A& a, const B& b) const {
+            return a == b || magnitude(a - b) <= atol + rtol * magnitude(b);
+        }
+    };
+
+    //
+    // Reduction engine
+    //
+
+    // independent accumulators per line, one cache line's worth
+    template <typename Acc>
+    inline constexpr offset_type reduce_lanes = std::max<offset_type>(1, offset_type(64 / sizeof(Acc)));
+
+    // Folds elements [begin, end) of the plan
+    template <typename Reducer, typename KernelT, std::size_t Rank>
+    typename Reducer::acc_type reduce_plan(const Reducer& reducer, const EvalPlan<Rank>& plan, KernelT& kernel,
+                                           std::size_t begin, std::size_t end) {
+        using acc_type = typename Reducer::acc_type;
+        constexpr offset_type lanes = reduce_lanes<acc_type>;
+        std::array<acc_type, lanes> acc;
+        acc.fill(reducer.identity());
+        visit_lines(plan, kernel, begin, end, [&](offset_type, std::size_t pos, offset_type i0, offset_type i1, auto load, auto) {
+            offset_type i = i0;
+            for (; i + lanes <= i1; i += lanes) {
+                for (offset_type l = 0; l < lanes; ++l) {
+                    acc[l] = reducer.combine(acc[l], load(i + l), pos + static_cast<std::size_t>(i + l));
+                }
+            }
+            for (; i < i1; ++i) {
+                acc[0] = reducer.combine(acc[0], load(i), pos + static_cast<std::size_t>(i));
+            }
+        });
+        acc_type total = acc[0];
+        for (offset_type l = 1; l < lanes; ++l) {
+            total = reducer.merge(total, acc[l]);
+        }
+        return total;
+    }
+
+    // Traverses in the natural order of the leaves' layout when they share
+    // one, otherwise in packed left-major order
+    template <typename T, typename KernelT>
+    auto make_reduce_plan(const T& x, KernelT& kernel) {
+        const auto exts = extents_of(x);
+        auto strides = kernel.reference_strides();
+        if (!kernel.has_strides(strides)) {
+            offset_type stride = 1;
+            for (std::size_t r = 0; r < strides.size(); ++r) {
+                strides[r] = stride;
+                stride *= exts[r];
+            }
+        }
+        return make_plan(exts, strides, kernel);
+    }
+
+    // Folds x and returns finish(total, plan)
+    template <typename Reducer, typename T, typename Finish>
+    auto reduce(const sequenced_policy& policy, const Reducer& reducer, const T& x, Finish&& finish) {
+        auto kernel = lower(x);
+        auto plan = make_reduce_plan(x, kernel);
+        set_prefetch(plan, policy);
+        return finish(reduce_plan(reducer, plan, kernel, 0, plan.size), plan);
+    }
+
+    template <typename Reducer, typename T, typename Finish>
+    auto reduce(const parallel_policy& policy, const Reducer& reducer, const T& x, Finish&& finish) {
+        using acc_type = typename Reducer::acc_type;
+        auto kernel = lower(x);
+        auto plan = make_reduce_plan(x, kernel);
+        set_prefetch(plan, policy);
+        const std::size_t grain = std::max<std::size_t>(chunk_grain(plan, policy.grain_size), 1);
+        const std::size_t num_chunks = (plan.size + grain - 1) / grain;
+        // not a std::vector, whose bool specialization packs bits
+        auto partials = std::make_unique<acc_type[]>(num_chunks);
+        std::fill_n(partials.get(), num_chunks, reducer.identity());
+        parallel_for(policy, plan.size, grain, [&](std::size_t begin, std::size_t end) {
+            auto local_kernel = kernel;
+            partials[begin / grain] = reduce_plan(reducer, plan, local_kernel, begin, end);
+        });
+        acc_type total = reducer.identity();
+        for (std::size_t c = 0; c < num_chunks; ++c) {
+            total = reducer.merge(total, partials[c]);
+        }
+        return finish(total, plan);
+    }
+
+    template <typename Policy, typename Reducer, typename T>
+    typename Reducer::acc_type reduce(const Policy& policy, const Reducer& reducer, const T& x) {
+        return reduce(policy, reducer, x, [](const auto& total, const auto&) { return total; });
+    }
+
+    template <typename T>
+    void assert_not_empty(const T& x, const char* caller) {
+        if (x.size() == 0) {
+            std::stringstream ss;
+            ss << caller << " error: reduction of an empty tensor has no identity\n"
+                << "\textents: " << nabla::temp::to_string(x.extents()) << "\n"
+                << "\n\n"
+                << std::stacktrace::current() << std::endl;
+            throw std::invalid_argument(ss.str());
+        }
+    }
+
+    // coordinates of the element at a position of the plan's traversal
+    template <typename CoordT, std::size_t Rank>
+    CoordT unravel(const EvalPlan<Rank>& plan, std::size_t pos) {
+        CoordT coord{};
+        for (std::size_t d = 0; d < Rank; ++d) {
+            const auto extent = static_cast<std::size_t>(plan.exts[d]);
+            coord[plan.order[d]] = static_cast<typename CoordT::value_type>(pos % extent);
+            pos /= extent;
+        }
+        return coord;
+    }
+
+    template <typename T>
+    auto arg_position() {
+        return [](const auto& best, const auto& plan) {
+            return unravel<typename std::remove_cvref_t<T>::coord_type>(plan, best.position);
+        };
+    }
+
+    template <typename A, typename B>
+    auto product(const A& a, const B& b) {
+        return make_expr_op(std::multiplies<>(), a, b);
+    }
+
+} // namespace detail
+
+//
+// Reductions
+//
+// Every reduction takes an optional execution policy as its first argument.
+//
+
+// sum of all elements, zero for an empty tensor
+template <typename Policy, typename T>
+    requires IsExecutionPolicy<Policy> && IsReducible<T>
+auto sum(const Policy& policy, const T& x) {
+    return detail::reduce(policy, detail::SumReducer<detail::reduce_value_t<T>>{}, x);
+}
+
+template <typename T>
+    requires IsReducible<T>
+auto sum(const T& x) {
+    return sum(seq, x);
+}
+
+// smallest element. Throws std::invalid_argument for an empty tensor.
+template <typename Policy, typename T>
+    requires IsExecutionPolicy<Policy> && IsReducible<T>
+auto min(const Policy& policy, const T& x) {
+    detail::assert_not_empty(x, "nabla::min");
+    return detail::reduce(policy, detail::MinReducer<detail::reduce_value_t<T>>{}, x);
+}
+
+template <typename T>
+    requires IsReducible<T>
+auto min(const T& x) {
+    return min(seq, x);
+}
+
+// largest element. Throws std::invalid_argument for an empty tensor.
+template <typename Policy, typename T>
+    requires IsExecutionPolicy<Policy> && IsReducible<T>
+auto max(const Policy& policy, const T& x) {
+    detail::assert_not_empty(x, "nabla::max");
+    return detail::reduce(policy, detail::MaxReducer<detail::reduce_value_t<T>>{}, x);
+}
+
+template <typename T>
+    requires IsReducible<T>
+auto max(const T& x) {
+    return max(seq, x);
+}
+
+// coordinates of the first smallest element, first in the operand's natural
+// traversal order: left-major unless all leaves share another layout.
+// Throws std::invalid_argument for an empty tensor.
+template <typename Policy, typename T>
+    requires IsExecutionPolicy<Policy> && IsReducible<T>
+auto argmin(const Policy& policy, const T& x) {
+    detail::assert_not_empty(x, "nabla::argmin");
+    return detail::reduce(policy, detail::ArgReducer<detail::reduce_value_t<T>, std::less<>>{}, x, detail::arg_position<T>());
+}
+
+template <typename T>
+    requires IsReducible<T>
+auto argmin(const T& x) {
+    return argmin(seq, x);
+}
+
+// coordinates of the first largest element, first in the same sense as
+// argmin. Throws std::invalid_argument for an empty tensor.
+template <typename Policy, typename T>
+    requires IsExecutionPolicy<Policy> && IsReducible<T>
+auto argmax(const Policy& policy, const T& x) {
+    detail::assert_not_empty(x, "nabla::argmax");
+    return detail::reduce(policy, detail::ArgReducer<detail::reduce_value_t<T>, std::greater<>>{}, x, detail::arg_position<T>());
+}
+
+template <typename T>
+    requires IsReducible<T>
+auto argmax(const T& x) {
+    return argmax(seq, x);
+}
+
+// sum of a(i)*b(i). Complex operands are not conjugated.
+template <typename Policy, typename A, typename B>
+    requires IsExecutionPolicy<Policy> && IsReducible<A> && IsReducible<B>
+auto dot(const Policy& policy, const A& a, const B& b) {
+    detail::assert_same_extents(a, b, "nabla::dot");
+    return sum(policy, detail::product(a, b));
+}
+
+template <typename A, typename B>
+    requires IsReducible<A> && IsReducible<B>
+auto dot(const A& a, const B& b) {
+    return dot(seq, a, b);
+}
+
+// Euclidean norm, sqrt of the sum of |x(i)|^2
+template <typename Policy, typename T>
+    requires IsExecutionPolicy<Policy> && IsReducible<T>
+auto norm2(const Policy& policy, const T& x) {
+    using std::sqrt;
+    return sqrt(detail::reduce(policy, detail::SumSquaresReducer<detail::reduce_value_t<T>>{}, x));
+}
+
+template <typename T>
+    requires IsReducible<T>
+auto norm2(const T& x) {
+    return norm2(seq, x);
+}
+
+// largest |x(i)|, zero for an empty tensor
+template <typename Policy, typename T>
+    requires IsExecutionPolicy<Policy> && IsReducible<T>
+auto norm_inf(const Policy& policy, const T& x) {
+    return detail::reduce(policy, detail::MaxMagnitudeReducer<detail::reduce_value_t<T>>{}, x);
+}
+
+template <typename T>
+    requires IsReducible<T>
+auto norm_inf(const T& x) {
+    return norm_inf(seq, x);
+}
+
+// true when |a(i) - b(i)| <= atol + rtol*|b(i)| for every element, with the
+// defaults of numpy.allclose. NaNs compare unequal.
+template <typename Policy, typename A, typename B>
+    requires IsExecutionPolicy<Policy> && IsReducible<A> && IsReducible<B>
+bool allclose(const Policy& policy, const A& a, const B& b, double rtol = 1e-5, double atol = 1e-8) {
+    detail::assert_same_extents(a, b, "nabla::allclose");
+    using real_type = detail::magnitude_t<detail::reduce_value_t<A>>;
+    const detail::IsClose<real_type> is_close{static_cast<real_type>(rtol), static_cast<real_type>(atol)};
+    return detail::reduce(policy, detail::AllReducer{}, make_expr_op(is_close, a, b));
+}
+
+template <typename A, typename B>
+    requires IsReducible<A> && IsReducible<B>
+bool allclose(const A& a, const B& b, double rtol = 1e-5, double atol = 1e-8) {
+    return allclose(seq, a, b, rtol, atol);
+}
+
+} // namespace nabla
+
+#endif // NABLA_REDUCE_HPP
@@ -0,0 +1,208 @@
+#ifndef NABLA_SCATTER_HPP
+#define NABLA_SCATTER_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <sstream>
+#include <stacktrace>
+#include <stdexcept>
+#include <thread>
+#include <type_traits>
+#include <vector>
+#include "nabla/types.hpp"
+#include "nabla/concepts.hpp"
+#include "nabla/atomic_accessor.hpp"
+#include "nabla/assign.hpp"
+#include "nabla/expr_evaluator.hpp"
+#include "nabla/elementwise_expr.hpp"
+#include "nabla/parallel.hpp"
+#include "nabla/tensor_array.hpp"
+#include "nabla/tensor_span.hpp"
+
+// Concurrent scatter-add, e.g. particle-to-grid deposition, where many
+// work items add into the same tensor:
+//
+//     nb::scatter_add(nb::par, rho, num_particles, [&](std::size_t p, auto& grid) {
+//         nb::atomic_add(grid(ix[p], iy[p]), q[p]);
+//     });
+//
+// The items are split across threads in one of two ways. With atomics every
+// thread adds into the destination through atomic_accessor. Privatized,
+// every thread adds into a zeroed private copy with plain adds and the
+// copies are summed into the destination at the end. Atomics lose when
+// threads keep hitting the same cache lines, privatizing when the tensor
+// is large compared to the number of items. The automatic strategy weighs
+// both with costs measured once per element type: a plain add, an
+// uncontended atomic add, and an atomic add on a line another thread is
+// hammering.
+
+namespace nabla {
+
+enum class scatter_strategy {
+    automatic,
+    atomic,    // add into the destination through atomic_ref
+    privatize, // add into per-thread copies, merged at the end
+};
+
+namespace detail {
+
+    // nanoseconds per add
+    struct scatter_costs {
+        double plain;
+        double atomic;
+        double contended;
+    };
+
+    template <typename T>
+    double time_adds(T* data, std::size_t mask, std::size_t n, bool atomic) {
+        const auto start = std::chrono::steady_clock::now();
+        std::uint32_t state = 12345;
+        for (std::size_t k = 0; k < n; ++k) {
+            state = state * 1664525u + 1013904223u;
+            const std::size_t i = (state >> 8) & mask;
+            if (atomic) {
+                atomic_add(std::atomic_ref<T>(data[i]), T(1));
+            } else {
+                data[i] += T(1);
+            }
+        }
+        const std::chrono::duration<double, std::nano> elapsed = std::chrono::steady_clock::now() - start;
+        return elapsed.count() / static_cast<double>(n);
+    }
+
+    // Measured on first use, in about a millisecond
+    template <typename T>
+    const scatter_costs& measured_scatter_costs() {
+        static const scatter_costs costs = [] {
+            constexpr std::size_t n = std::size_t(1) << 16;
+            // a few KB, so that the measures leave out cache misses
+            std::vector<T> data(1024, T{});
+            scatter_costs c;
+            c.plain = time_adds(data.data(), data.size() - 1, n, false);
+            c.atomic = time_adds(data.data(), data.size() - 1, n, true);
+            // two threads on the same cache line
+            std::vector<T> line(std::max<std::size_t>(64 / sizeof(T), 1), T{});
+            std::atomic<bool> go{false};
+            std::thread other([&] {
+                while (!go.load(std::memory_order_acquire)) {
+                }
+                time_adds(line.data(), 0, n, true);
+            });
+            go.store(true, std::memory_order_release);
+            c.contended = time_adds(line.data(), 0, n, true);
+            other.join();
+            // keeps the plain adds from being optimized away
+            volatile T sink = data[0];
+            (void)sink;
+            return c;
+        }();
+        return costs;
+    }
+
+    // Whether `count` deposits into `size` elements by `threads` threads
+    // are cheaper into private copies
+    template <typename T>
+    bool prefer_privatize(std::size_t count, std::size_t size, std::size_t threads) {
+        // the copies must fit in memory comfortably
+        if (threads * size * sizeof(T) > (std::size_t(1) << 30)) {
+            return false;
+        }
+        const scatter_costs& c = measured_scatter_costs<T>();
+        // chance that another thread is working on the line a deposit
+        // goes to, for deposits spread evenly over the tensor
+        const double lines = std::max(1.0, static_cast<double>(size * sizeof(T)) / 64);
+        const double contention = std::min(1.0, static_cast<double>(threads - 1) / lines);
+        const double atomic_cost = static_cast<double>(count) * (c.atomic + contention * std::max(c.contended - c.atomic, 0.0));
+        // each copy is zeroed and read once by the merge
+        const double private_cost = static_cast<double>(count) * c.plain + 2.0 * static_cast<double>(threads * size) * c.plain;
+        return private_cost < atomic_cost;
+    }
+
+} // namespace detail
+
+// Calls f(i, grid) for every i in [0, count), where f adds its
+// contributions into grid, a tensor with the extents of dst, through
+// atomic_add. Sequentially, grid is dst itself. Under the parallel policy,
+// grid is either dst through atomic_accessor or a private copy of this
+// thread, see scatter_strategy; f must only add into it. Floating point
+// sums differ from the sequential ones by rounding.
+template <typename Policy, typename Dst, typename F>
+    requires IsExecutionPolicy<Policy> && (IsTensorSpan<Dst> || IsTensorArray<Dst>)
+void scatter_add(const Policy& policy, Dst&& dst, std::size_t count, F&& f,
+                 scatter_strategy strategy = scatter_strategy::automatic) {
+    using dst_type = std::remove_cvref_t<Dst>;
+    using value_type = typename dst_type::value_type;
+    using extents_type = typename dst_type::extents_type;
+    static_assert(!std::is_const_v<typename dst_type::element_type>, "nabla::scatter_add: destination is const");
+
+    if constexpr (std::is_same_v<std::remove_cvref_t<Policy>, parallel_policy> && detail::IsPointerBacked<dst_type>) {
+        const std::size_t threads = std::min(max_threads(policy), count);
+        const std::size_t size = static_cast<std::size_t>(dst.size());
+        if (count >= policy.serial_cutoff && threads > 1) {
+            const bool aligned = reinterpret_cast<std::uintptr_t>(detail::data_pointer(dst)) %
+                std::atomic_ref<value_type>::required_alignment == 0;
+            if (strategy == scatter_strategy::automatic) {
+                strategy = !aligned || detail::prefer_privatize<value_type>(count, size, threads)
+                    ? scatter_strategy::privatize : scatter_strategy::atomic;
+            } else if (strategy == scatter_strategy::atomic && !aligned) {
+                std::stringstream ss;
+                ss << "nabla::scatter_add error: destination is not aligned to "
+                    << std::atomic_ref<value_type>::required_alignment << " bytes for atomic adds"
+                    << "\n\n"
+                    << std::stacktrace::current() << std::endl;
+                throw std::invalid_argument(ss.str());
+            }
+            // one chunk of items per thread, so that chunks map to copies
+            const std::size_t grain = (count + threads - 1) / threads;
+            if (strategy == scatter_strategy::atomic) {
+                using atomic_span = TensorSpan<value_type, extents_type, typename dst_type::layout_type, atomic_accessor<value_type>>;
+                const atomic_span shared(detail::data_pointer(dst), dst.mapping());
+                parallel_for(policy, count, grain, [&](std::size_t begin, std::size_t end) {
+                    atomic_span grid = shared;
+                    for (std::size_t i = begin; i < end; ++i) {
+                        f(i, grid);
+                    }
+                });
+                return;
+            }
+            using copy_type = TensorArray<value_type, extents_type>;
+            std::vector<std::optional<copy_type>> copies((count + grain - 1) / grain);
+            parallel_for(policy, count, grain, [&](std::size_t begin, std::size_t end) {
+                // zeroed by the thread that uses it
+                copy_type& grid = copies[begin / grain].emplace(dst.extents());
+                grid.zero();
+                for (std::size_t i = begin; i < end; ++i) {
+                    f(i, grid);
+                }
+            });
+            value_type* merged = copies[0]->data();
+            parallel_for(policy, size, policy.grain_size, [&](std::size_t begin, std::size_t end) {
+                for (std::size_t c = 1; c < copies.size(); ++c) {
+                    const value_type* in = copies[c]->data();
+                    for (std::size_t j = begin; j < end; ++j) {
+                        merged[j] += in[j];
+                    }
+                }
+            });
+            assign(policy, dst, dst + *copies[0]);
+            return;
+        }
+    }
+    for (std::size_t i = 0; i < count; ++i) {
+        f(i, dst);
+    }
+}
+
+template <typename Dst, typename F>
+    requires (IsTensorSpan<Dst> || IsTensorArray<Dst>)
+void scatter_add(Dst&& dst, std::size_t count, F&& f) {
+    scatter_add(seq, std::forward<Dst>(dst), count, std::forward<F>(f));
+}
+
+} // namespace nabla
+
+#endif // NABLA_SCATTER_HPP
@@ -0,0 +1,88 @@
+#ifndef NABLA_SHARED_ACCESSOR_HPP
+#define NABLA_SHARED_ACCESSOR_HPP
+
+#include <cstddef>
+#include <memory>
+#include <type_traits>
+
+// Accessor whose data handle shares ownership of the elements, so that a
+// span keeps its storage alive, e.g. a memory mapping that is unmapped when
+// the last span over it goes away. Offsets alias the owning pointer, and
+// kernels read through raw_pointer(), so spans take the same fast paths as
+// spans over plain pointers.
+
+namespace nabla {
+
+template <typename T>
+class shared_accessor;
+
+template <typename T>
+class shared_accessor<const T> {
+    public:
+        using element_type = const T;
+        using reference = const T&;
+        using data_handle_type = std::shared_ptr<T[]>;
+        using offset_policy = shared_accessor;
+        using read_accessor_type = shared_accessor;
+        using write_accessor_type = shared_accessor<T>;
+
+        constexpr shared_accessor() noexcept = default;
+
+        template <typename OtherElementType>
+            requires std::is_convertible_v<OtherElementType(*)[], element_type(*)[]>
+        constexpr shared_accessor(shared_accessor<OtherElementType>) noexcept {}
+
+        reference access(const data_handle_type& p, std::size_t i) const noexcept {
+            return p.get()[i];
+        }
+
+        // lets kernels read through the pointer without copying the handle
+        element_type* raw_pointer(const data_handle_type& p) const noexcept {
+            return p.get();
+        }
+
+        data_handle_type offset(const data_handle_type& p, std::size_t i) const noexcept {
+            return data_handle_type(p, p.get() + i); // aliasing constructor
+        }
+
+        write_accessor_type to_write() const noexcept {
+            return {};
+        }
+};
+
+template <typename T>
+class shared_accessor : public shared_accessor<const T> {
+    public:
+        using element_type = T;
+        using reference = T&;
+        using data_handle_type = std::shared_ptr<T[]>;
+        using offset_policy = shared_accessor;
+        using read_accessor_type = shared_accessor<const T>;
+        using write_accessor_type = shared_accessor;
+
+        constexpr shared_accessor() noexcept = default;
+
+        template <typename OtherElementType>
+            requires std::is_convertible_v<OtherElementType(*)[], element_type(*)[]>
+        constexpr shared_accessor(shared_accessor<OtherElementType>) noexcept {}
+
+        reference access(const data_handle_type& p, std::size_t i) const noexcept {
+            return p.get()[i];
+        }
+
+        element_type* raw_pointer(const data_handle_type& p) const noexcept {
+            return p.get();
+        }
+
+        data_handle_type offset(const data_handle_type& p, std::size_t i) const noexcept {
+            return data_handle_type(p, p.get() + i);
+        }
+
+        write_accessor_type to_write() const noexcept {
+            return {};
+        }
+};
+
+} // namespace nabla
+
+#endif // NABLA_SHARED_ACCESSOR_HPP
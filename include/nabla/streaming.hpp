@@ -0,0 +1,107 @@
+#ifndef NABLA_STREAMING_HPP
+#define NABLA_STREAMING_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#if __has_include(<unistd.h>)
+#include <unistd.h>
+#endif
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#define NABLA_HAS_STREAMING_STORES 1
+#else
+#define NABLA_HAS_STREAMING_STORES 0
+#endif
+
+// Non-temporal stores for destinations larger than the last level cache. A
+// plain store first reads its cache line from memory (read for ownership)
+// and later writes it back, evicting data that is still needed on the
+// way; written once, a large output costs two transfers per line for one
+// line of useful data. Streaming stores fill whole lines in write-combining
+// buffers and send them straight to memory, so the line is never read.
+// Elements are computed a cache line at a time into a block, which is then
+// streamed out. The stores are weakly ordered, so a writer ends with
+// stream_fence() before its results are used by another thread.
+
+namespace nabla {
+namespace detail {
+
+    inline constexpr std::size_t cache_line_size = 64;
+
+    // elements that can be streamed in 16-byte pieces from a cache line block
+    template <typename T>
+    inline constexpr bool is_streamable =
+        NABLA_HAS_STREAMING_STORES && std::is_trivially_copyable_v<T> && 16 % sizeof(T) == 0;
+
+    // Bytes of the last level cache, 32 MiB when the system does not say
+    inline std::size_t last_level_cache_size() noexcept {
+        static const std::size_t size = [] {
+            long bytes = -1;
+#if defined(_SC_LEVEL3_CACHE_SIZE) && defined(_SC_LEVEL2_CACHE_SIZE)
+            bytes = ::sysconf(_SC_LEVEL3_CACHE_SIZE);
+            if (bytes <= 0) {
+                bytes = ::sysconf(_SC_LEVEL2_CACHE_SIZE);
+            }
+#endif
+            return bytes > 0 ? static_cast<std::size_t>(bytes) : std::size_t(32) << 20;
+        }();
+        return size;
+    }
+
+    // Whether a destination of `bytes` bytes is written with streaming
+    // stores, given a threshold in bytes, 0 for the last level cache size
+    template <typename T>
+    bool use_streaming_stores(std::size_t bytes, std::size_t threshold) noexcept {
+        if constexpr (is_streamable<T>) {
+            return bytes > (threshold == 0 ? last_level_cache_size() : threshold);
+        } else {
+            return false;
+        }
+    }
+
+    // Stores load(i) to out[i] for i in [i0, i1), streaming the whole cache
+    // lines of the range
+    template <typename T, typename Load>
+    void stream_line(T* out, std::ptrdiff_t i0, std::ptrdiff_t i1, Load&& load) {
+        std::ptrdiff_t i = i0;
+#if NABLA_HAS_STREAMING_STORES
+        if constexpr (is_streamable<T>) {
+            constexpr std::ptrdiff_t per_line = cache_line_size / sizeof(T);
+            // elements that straddle lines never reach a line boundary
+            if (reinterpret_cast<std::uintptr_t>(out) % sizeof(T) == 0 && i1 - i0 >= 2 * per_line) {
+                for (; reinterpret_cast<std::uintptr_t>(out + i) % cache_line_size != 0; ++i) {
+                    out[i] = load(i);
+                }
+                alignas(cache_line_size) T block[per_line];
+                for (; i + per_line <= i1; i += per_line) {
+                    for (std::ptrdiff_t k = 0; k < per_line; ++k) {
+                        block[k] = load(i + k);
+                    }
+                    const auto* src = reinterpret_cast<const __m128i*>(block);
+                    auto* dst = reinterpret_cast<__m128i*>(out + i);
+                    for (std::size_t k = 0; k < cache_line_size / 16; ++k) {
+                        _mm_stream_si128(dst + k, _mm_load_si128(src + k));
+                    }
+                }
+            }
+        }
+#endif
+        for (; i < i1; ++i) {
+            out[i] = load(i);
+        }
+    }
+
+    // Orders the streaming stores of this thread before its later stores
+    inline void stream_fence() noexcept {
+#if NABLA_HAS_STREAMING_STORES
+        _mm_sfence();
+#endif
+    }
+
+} // namespace detail
+} // namespace nabla
+
+#endif // NABLA_STREAMING_HPP
@@ -6,7 +6,9 @@
 #include "nabla/tensor_span.hpp"
 #include "nabla/tensor_array_iterator.hpp"
 #include "nabla/default_accessor.hpp"
+#include "nabla/default_init_allocator.hpp"
 #include "nabla/nested_initializer_list.hpp"
+#include "nabla/assign.hpp"
 #include "nabla/concepts.hpp"
 
 namespace nabla {
@@ -182,6 +184,10 @@ class TensorArray {
         constexpr TensorArray(container_type&& ctr, const mapping_type& mapping)
             : _mdarray(mapping, std::move(ctr)) {}
 
+        // materializing constructors. The storage is made like that of the
+        // non-initializing constructors and then assigned, so each element is
+        // written once only when the container's allocator default-initializes,
+        // e.g. default_init_vector<T>; std::vector<T> zeroes it first.
         template <typename U>
             requires IsTensorArray<U> || IsTensorSpan<U>
         constexpr TensorArray(const U& other)
@@ -192,38 +198,43 @@ class TensorArray {
         template <typename U>
             requires IsTensorExpr<U>
         constexpr TensorArray(const U& other)
-            : _mdarray(mapping_type(other.extents(), other.mapping().strides())) {
+            : _mdarray(mapping_type(extents_type(other.extents()))) {
                 *this = other;
             }
 
+        // materialize under an execution policy, e.g. TensorArray(nb::par, expr)
+        template <typename Policy, typename U>
+            requires IsExecutionPolicy<Policy> && IsTensorLike<U>
+        TensorArray(const Policy& policy, const U& other)
+            : _mdarray(mapping_type(extents_type(other.extents()))) {
+                nabla::assign(policy, *this, other);
+            }
+
     //
     // Operator =
     //
     public:
-        // TODO: add runtime debug assert on extents match
         template <typename U>
             requires IsTensorLike<U>
         TensorArray& operator=(const U& other) {
-            auto it = begin();
-            auto end_it = end();
-            auto other_it = other.begin();
-            for (; it != end_it; ++it, ++other_it) {
-                *it = *other_it;
-            }
+            nabla::assign(*this, other);
             return *this;
         }
 
-        // TODO: optimize
-        // TODO: add runtime debug assert on extents match
         TensorArray& operator=(const TensorArray& other) {
-            if (static_cast<const void*>(this) != static_cast<const void*>(&other)) {
-                auto it = begin();
-                auto end_it = end();
-                auto other_it = other.begin();
-                for (; it != end_it; ++it, ++other_it) {
-                    *it = *other_it;
-                }
+            if (static_cast<const void*>(this) == static_cast<const void*>(&other)) {
+                return *this;
             }
+#ifdef NABLA_DEBUG
+            detail::assert_same_extents(*this, other);
+#endif
+            // identical mappings: the gaps of a non-exhaustive layout are owned
+            // by this array, so the whole codomain can be copied at once
+            if (detail::same_strides(mapping(), other.mapping())) {
+                std::copy_n(other.data(), mapping().required_span_size(), data());
+                return *this;
+            }
+            nabla::assign(*this, other);
             return *this;
         }
 
@@ -236,6 +247,10 @@ class TensorArray {
         void swap(TensorArray& t) { std::swap(*this, t); }
         void swap(TensorArray&& t) { std::swap(*this, t); }
 
+        // fills the whole container, including any gaps between strides
+        void fill(const value_type& value) { std::fill(container().begin(), container().end(), value); }
+        void zero() { fill(value_type{}); }
+
     //
     // Element access
     //
@@ -273,16 +288,19 @@ class TensorArray {
     //
     public:
 
-        // operator to const TensorSpan
+        // operator to const TensorSpan. A const TensorSpan stores the
+        // non-const data handle of its writable derived class (see the
+        // inherited const pattern in tensor_span.hpp) and only hands out read
+        // access, so casting away the const of data() is safe here.
         template <typename AccessorType = default_accessor<std::add_const_t<element_type>>>
         constexpr operator TensorSpan<std::add_const_t<element_type>, extents_type, layout_type, AccessorType>() const {
-            return TensorSpan<std::add_const_t<element_type>, extents_type, layout_type, AccessorType>(data(), mapping());
+            return TensorSpan<std::add_const_t<element_type>, extents_type, layout_type, AccessorType>(const_cast<pointer>(data()), mapping());
         }
 
-        // to const TensorSpan
+        // to const TensorSpan, see above
         template <typename AccessorType = default_accessor<std::add_const_t<element_type>>>
         constexpr TensorSpan<std::add_const_t<element_type>, extents_type, layout_type, AccessorType> to_span(const AccessorType& accessor = AccessorType()) const {
-            return TensorSpan<std::add_const_t<element_type>, extents_type, layout_type, AccessorType>(data(), mapping(), accessor);
+            return TensorSpan<std::add_const_t<element_type>, extents_type, layout_type, AccessorType>(const_cast<pointer>(data()), mapping(), accessor);
         }
 
         // operator to TensorSpan
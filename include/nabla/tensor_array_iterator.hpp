@@ -1,6 +1,7 @@
 #ifndef NABLA_TENSOR_ARRAY_ITERATOR_HPP
 #define NABLA_TENSOR_ARRAY_ITERATOR_HPP
 
+#include <iterator>
 #include "nabla/concepts.hpp"
 
 namespace nabla {
@@ -22,12 +23,14 @@ class ConstTensorArrayIterator {
         using difference_type = std::ptrdiff_t;
         using pointer = const element_type*;
         using reference = const element_type&;
-        //using iterator_category = std::forward_iterator_tag;
-        //using iterator_concept = std::forward_iterator<ConstTensorArrayIterator>;
+        using iterator_category = std::random_access_iterator_tag;
+        using iterator_concept = std::random_access_iterator_tag;
 
         ConstTensorArrayIterator() = default;
         ConstTensorArrayIterator(const ConstTensorArrayIterator&) = default;
         ConstTensorArrayIterator(ConstTensorArrayIterator&&) = default;
+        ConstTensorArrayIterator& operator=(const ConstTensorArrayIterator&) = default;
+        ConstTensorArrayIterator& operator=(ConstTensorArrayIterator&&) = default;
 
         ConstTensorArrayIterator(const TensorArrayT* tensor, mapping_iterator_type flat_iter) 
             : _tensor(tensor), _flat_iterator(flat_iter) {}
@@ -47,6 +50,47 @@ class ConstTensorArrayIterator {
             return tmp;
         }
 
+        ConstTensorArrayIterator& operator--() {
+            --_flat_iterator;
+            return *this;
+        }
+
+        ConstTensorArrayIterator operator--(int) {
+            ConstTensorArrayIterator tmp = *this;
+            --(*this);
+            return tmp;
+        }
+
+        reference operator[](difference_type n) const {
+            return _tensor->access(_flat_iterator[n]);
+        }
+
+        ConstTensorArrayIterator& operator+=(difference_type n) {
+            _flat_iterator += n;
+            return *this;
+        }
+
+        ConstTensorArrayIterator& operator-=(difference_type n) {
+            _flat_iterator -= n;
+            return *this;
+        }
+
+        friend ConstTensorArrayIterator operator+(ConstTensorArrayIterator it, difference_type n) {
+            return it += n;
+        }
+
+        friend ConstTensorArrayIterator operator+(difference_type n, ConstTensorArrayIterator it) {
+            return it += n;
+        }
+
+        friend ConstTensorArrayIterator operator-(ConstTensorArrayIterator it, difference_type n) {
+            return it -= n;
+        }
+
+        friend difference_type operator-(const ConstTensorArrayIterator& a, const ConstTensorArrayIterator& b) {
+            return a._flat_iterator - b._flat_iterator;
+        }
+
         bool operator==(const ConstTensorArrayIterator& other) const {
             return _flat_iterator == other._flat_iterator;
         }
@@ -55,6 +99,10 @@ class ConstTensorArrayIterator {
             return !(*this == other);
         }
 
+        auto operator<=>(const ConstTensorArrayIterator& other) const {
+            return _flat_iterator <=> other._flat_iterator;
+        }
+
 }; // class ConstTensorArrayIterator
 
 template <typename TensorArrayT>
@@ -74,12 +122,14 @@ class TensorArrayIterator {
         using difference_type = std::ptrdiff_t;
         using pointer = element_type*;
         using reference = element_type&;
-        //using iterator_category = std::forward_iterator_tag;
-        //using iterator_concept = std::forward_iterator<TensorArrayIterator>;
+        using iterator_category = std::random_access_iterator_tag;
+        using iterator_concept = std::random_access_iterator_tag;
 
         TensorArrayIterator() = default;
         TensorArrayIterator(const TensorArrayIterator&) = default;
         TensorArrayIterator(TensorArrayIterator&&) = default;
+        TensorArrayIterator& operator=(const TensorArrayIterator&) = default;
+        TensorArrayIterator& operator=(TensorArrayIterator&&) = default;
 
         TensorArrayIterator(TensorArrayT* tensor, mapping_iterator_type flat_iter) 
             : _tensor(tensor), _flat_iterator(flat_iter) {}
@@ -99,6 +149,47 @@ class TensorArrayIterator {
             return tmp;
         }
 
+        TensorArrayIterator& operator--() {
+            --_flat_iterator;
+            return *this;
+        }
+
+        TensorArrayIterator operator--(int) {
+            TensorArrayIterator tmp = *this;
+            --(*this);
+            return tmp;
+        }
+
+        reference operator[](difference_type n) const {
+            return _tensor->access(_flat_iterator[n]);
+        }
+
+        TensorArrayIterator& operator+=(difference_type n) {
+            _flat_iterator += n;
+            return *this;
+        }
+
+        TensorArrayIterator& operator-=(difference_type n) {
+            _flat_iterator -= n;
+            return *this;
+        }
+
+        friend TensorArrayIterator operator+(TensorArrayIterator it, difference_type n) {
+            return it += n;
+        }
+
+        friend TensorArrayIterator operator+(difference_type n, TensorArrayIterator it) {
+            return it += n;
+        }
+
+        friend TensorArrayIterator operator-(TensorArrayIterator it, difference_type n) {
+            return it -= n;
+        }
+
+        friend difference_type operator-(const TensorArrayIterator& a, const TensorArrayIterator& b) {
+            return a._flat_iterator - b._flat_iterator;
+        }
+
         bool operator==(const TensorArrayIterator& other) const {
             return _flat_iterator == other._flat_iterator;
         }
@@ -107,6 +198,10 @@ class TensorArrayIterator {
             return !(*this == other);
         }
 
+        auto operator<=>(const TensorArrayIterator& other) const {
+            return _flat_iterator <=> other._flat_iterator;
+        }
+
 }; // class TensorArrayIterator
 
 } // namespace nabla
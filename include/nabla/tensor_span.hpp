@@ -6,6 +6,7 @@
 #include "nabla/tensor_span_iterator.hpp"
 #include "nabla/default_accessor.hpp"
 #include "nabla/nested_initializer_list.hpp"
+#include "nabla/assign.hpp"
 
 namespace nabla {
 
@@ -215,33 +216,23 @@ class TensorSpan : public TensorSpan<const T, Extents, LayoutPolicy, typename Ac
     public:
         using base_type::swap;
 
+        void fill(const value_type& value) const { detail::fill(*this, value); }
+        void zero() const { fill(value_type{}); }
+
     //
     // Operator =
     //
     public:
-        // TODO: add runtime debug assert on extents match
         template <typename U>
             requires IsTensorLike<U>
         TensorSpan& operator=(const U& other) {
-            auto it = begin();
-            auto end_it = end();
-            auto other_it = other.begin();
-            for (; it != end_it; ++it, ++other_it) {
-                *it = *other_it;
-            }
+            nabla::assign(*this, other);
             return *this;
         }
 
-        // TODO: optimize
-        // TODO: add runtime debug assert on extents match
         TensorSpan& operator=(const TensorSpan& other) {
             if (static_cast<const void*>(this) != static_cast<const void*>(&other)) {
-                auto it = begin();
-                auto end_it = end();
-                auto other_it = other.begin();
-                for (; it != end_it; ++it, ++other_it) {
-                    *it = *other_it;
-                }
+                nabla::assign(*this, other);
             }
             return *this;
         }
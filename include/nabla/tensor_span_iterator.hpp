@@ -1,7 +1,11 @@
 #ifndef NABLA_TENSOR_SPAN_ITERATOR_HPP
 #define NABLA_TENSOR_SPAN_ITERATOR_HPP
 
+#include <cstddef>
+#include <iterator>
+#include <type_traits>
 #include "nabla/concepts.hpp"
+#include "nabla/aligned_accessor.hpp"
 
 namespace nabla {
 
@@ -12,28 +16,45 @@ class TensorSpanIterator {
         using mapping_iterator_type = typename TensorSpanT::mapping_type::iterator_type;
 
     private:
+        // accessors over plain memory are read through their raw pointer,
+        // resolved once rather than passing the data handle to every access
+        static constexpr bool _is_raw = detail::IsPlainMemoryAccessor<typename TensorSpanT::accessor_type>;
+        using raw_pointer_type = std::conditional_t<_is_raw, typename TensorSpanT::element_type*, std::nullptr_t>;
+
         const TensorSpanT* _tensor;
         mapping_iterator_type _flat_iterator;
+        raw_pointer_type _data = nullptr;
 
     public:
 
         using element_type = typename TensorSpanT::element_type;
         using value_type = typename TensorSpanT::value_type;
         using difference_type = std::ptrdiff_t;
-        using pointer = element_type*;
-        using reference = element_type&;
-        //using iterator_category = std::forward_iterator_tag;
-        //using iterator_concept = std::forward_iterator<TensorSpanIterator>;
+        // accessors may return elements by value or through a proxy
+        using reference = typename TensorSpanT::reference;
+        using pointer = std::conditional_t<std::is_reference_v<reference>, element_type*, void>;
+        using iterator_category = std::random_access_iterator_tag;
+        using iterator_concept = std::random_access_iterator_tag;
 
         TensorSpanIterator() = default;
         TensorSpanIterator(const TensorSpanIterator&) = default;
         TensorSpanIterator(TensorSpanIterator&&) = default;
+        TensorSpanIterator& operator=(const TensorSpanIterator&) = default;
+        TensorSpanIterator& operator=(TensorSpanIterator&&) = default;
 
         TensorSpanIterator(const TensorSpanT* tensor, mapping_iterator_type flat_iter) 
-            : _tensor(tensor), _flat_iterator(flat_iter) {}
+            : _tensor(tensor), _flat_iterator(flat_iter) {
+                if constexpr (_is_raw) {
+                    _data = detail::raw_pointer(tensor->accessor(), tensor->data_handle());
+                }
+            }
 
         reference operator*() const {
-            return _tensor->access(*_flat_iterator);
+            if constexpr (_is_raw) {
+                return _data[*_flat_iterator];
+            } else {
+                return _tensor->access(*_flat_iterator);
+            }
         }
 
         TensorSpanIterator& operator++() {
@@ -47,6 +68,51 @@ class TensorSpanIterator {
             return tmp;
         }
 
+        TensorSpanIterator& operator--() {
+            --_flat_iterator;
+            return *this;
+        }
+
+        TensorSpanIterator operator--(int) {
+            TensorSpanIterator tmp = *this;
+            --(*this);
+            return tmp;
+        }
+
+        reference operator[](difference_type n) const {
+            if constexpr (_is_raw) {
+                return _data[_flat_iterator[n]];
+            } else {
+                return _tensor->access(_flat_iterator[n]);
+            }
+        }
+
+        TensorSpanIterator& operator+=(difference_type n) {
+            _flat_iterator += n;
+            return *this;
+        }
+
+        TensorSpanIterator& operator-=(difference_type n) {
+            _flat_iterator -= n;
+            return *this;
+        }
+
+        friend TensorSpanIterator operator+(TensorSpanIterator it, difference_type n) {
+            return it += n;
+        }
+
+        friend TensorSpanIterator operator+(difference_type n, TensorSpanIterator it) {
+            return it += n;
+        }
+
+        friend TensorSpanIterator operator-(TensorSpanIterator it, difference_type n) {
+            return it -= n;
+        }
+
+        friend difference_type operator-(const TensorSpanIterator& a, const TensorSpanIterator& b) {
+            return a._flat_iterator - b._flat_iterator;
+        }
+
         bool operator==(const TensorSpanIterator& other) const {
             return _flat_iterator == other._flat_iterator;
         }
@@ -55,6 +121,10 @@ class TensorSpanIterator {
             return !(*this == other);
         }
 
+        auto operator<=>(const TensorSpanIterator& other) const {
+            return _flat_iterator <=> other._flat_iterator;
+        }
+
 }; // class TensorSpanIterator
 
 } // namespace nabla
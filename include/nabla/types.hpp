@@ -1,6 +1,7 @@
 #ifndef NABLA_TYPES_HPP
 #define NABLA_TYPES_HPP
 
+#include <memory>
 #include <vector>
 #include "mdspan/mdspan.hpp" // for extents
 
@@ -14,10 +15,15 @@ namespace nabla {
     using mdspan_ns::full_extent;
 
     struct LeftStride;
+    struct LeftBroadcast;
+    struct RightStride;
 
     template <typename T>
     class default_accessor;
 
+    template <typename T, typename Allocator = std::allocator<T>>
+    class default_init_allocator;
+
     template <
         typename ElementType,
         typename Extents,
@@ -1,6 +1,7 @@
 #ifndef UTILITY_HELPERS_HPP
 #define UTILITY_HELPERS_HPP
 
+#include <algorithm>
 #include <string_view>
 #include <tuple>
 
@@ -38,6 +39,17 @@ void for_each_in_tuple(Tuple&& t, F&& f) {
     for_each_impl(std::forward<Tuple>(t), std::forward<F>(f), std::make_index_sequence<N>{});
 }
 
+// Stable sort for short ranges such as the dimensions of a tensor. Unlike
+// std::stable_sort it never allocates a buffer.
+template <typename It, typename Compare>
+constexpr void insertion_sort(It first, It last, Compare comp) {
+    for (It i = first; i != last; ++i) {
+        for (It j = i; j != first && comp(*j, *(j - 1)); --j) {
+            std::iter_swap(j, j - 1);
+        }
+    }
+}
+
 } // namespace utility
 } // namespace nabla
 
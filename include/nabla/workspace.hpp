@@ -0,0 +1,235 @@
+#ifndef NABLA_WORKSPACE_HPP
+#define NABLA_WORKSPACE_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <memory_resource>
+#include <new>
+#include <type_traits>
+#include <vector>
+#include "nabla/types.hpp"
+
+// Arena allocation for short-lived TensorArrays. A Workspace is a memory
+// resource that hands out memory by bumping an offset into one slab and
+// frees it all at once. Workspace::scope() makes it the current resource of
+// the calling thread until the scope ends, and pmr::TensorArray, whose
+// allocator defaults to the current resource, then takes its storage from
+// the slab:
+//
+//     nb::Workspace ws;
+//     for (int step = 0; step < steps; ++step) {
+//         auto scope = ws.scope();
+//         nb::pmr::TensorArray<double, nb::dims<2>> flux(a*b + c);
+//         ...
+//     } // every array made in the scope is gone, the slab is reused
+//
+// Requests the slab cannot hold are served by the upstream resource. Once
+// the outermost scope has ended, the next allocation grows the slab to the
+// peak usage, so from then on a loop whose steps need the same memory does
+// no heap allocation. Ending a scope never allocates.
+// Arrays made in a scope must not outlive it.
+
+namespace nabla {
+
+namespace detail {
+
+    inline std::pmr::memory_resource*& current_resource_slot() noexcept {
+        thread_local std::pmr::memory_resource* resource = nullptr;
+        return resource;
+    }
+
+} // namespace detail
+
+// Resource of the innermost workspace scope on this thread, or the default
+// resource outside of any scope
+inline std::pmr::memory_resource* current_resource() noexcept {
+    std::pmr::memory_resource* resource = detail::current_resource_slot();
+    return resource ? resource : std::pmr::get_default_resource();
+}
+
+// Polymorphic allocator that defaults to current_resource() instead of the
+// process-wide default resource, also when a container is copied. Like
+// default_init_allocator it leaves trivial elements uninitialized.
+template <typename T>
+class workspace_allocator : public std::pmr::polymorphic_allocator<T> {
+    public:
+        using base_type = std::pmr::polymorphic_allocator<T>;
+
+        workspace_allocator() noexcept
+            : base_type(current_resource()) {}
+
+        workspace_allocator(std::pmr::memory_resource* resource) noexcept
+            : base_type(resource) {}
+
+        workspace_allocator(const workspace_allocator&) = default;
+
+        template <typename U>
+        workspace_allocator(const workspace_allocator<U>& other) noexcept
+            : base_type(other.resource()) {}
+
+        workspace_allocator select_on_container_copy_construction() const noexcept {
+            return workspace_allocator();
+        }
+
+        using base_type::construct;
+
+        template <typename U>
+            requires std::is_trivially_default_constructible_v<U>
+        void construct(U* p) noexcept {
+            ::new (static_cast<void*>(p)) U;
+        }
+};
+
+class Workspace : public std::pmr::memory_resource {
+    public:
+        // saved position of the arena, see rewind()
+        struct Mark {
+            std::size_t offset = 0;
+            std::size_t overflow = 0;
+        };
+
+        // Makes a workspace current on this thread; on destruction restores
+        // the previous resource and frees what was allocated in the scope
+        class Scope {
+            Workspace* _workspace;
+            std::pmr::memory_resource* _previous;
+            Mark _mark;
+
+            public:
+                explicit Scope(Workspace& ws) noexcept
+                    : _workspace(&ws), _previous(detail::current_resource_slot()), _mark(ws.mark()) {
+                        detail::current_resource_slot() = &ws;
+                    }
+
+                Scope(const Scope&) = delete;
+                Scope& operator=(const Scope&) = delete;
+
+                ~Scope() {
+                    detail::current_resource_slot() = _previous;
+                    _workspace->rewind(_mark);
+                }
+        };
+
+    private:
+        struct Block {
+            void* p;
+            std::size_t bytes;
+            std::size_t alignment;
+        };
+
+        static constexpr std::size_t slab_alignment = 64;
+
+        std::pmr::memory_resource* _upstream;
+        std::byte* _slab = nullptr;
+        std::size_t _capacity = 0;
+        std::size_t _offset = 0;
+        std::vector<Block> _overflow;
+        std::size_t _in_use = 0;
+        // slab bytes needed to serve the overflow too, padding included
+        std::size_t _overflow_demand = 0;
+        std::size_t _peak = 0;
+
+    public:
+        explicit Workspace(std::size_t capacity = 0, std::pmr::memory_resource* upstream = std::pmr::get_default_resource())
+            : _upstream(upstream) {
+                reserve(capacity);
+            }
+
+        Workspace(const Workspace&) = delete;
+        Workspace& operator=(const Workspace&) = delete;
+
+        ~Workspace() override {
+            rewind(Mark{});
+            if (_slab) {
+                _upstream->deallocate(_slab, _capacity, slab_alignment);
+            }
+        }
+
+        Scope scope() noexcept {
+            return Scope(*this);
+        }
+
+        std::size_t capacity() const noexcept { return _capacity; }
+        // bytes currently handed out, slab and overflow
+        std::size_t in_use() const noexcept { return _in_use; }
+        // largest slab that the allocations so far would have needed
+        std::size_t peak() const noexcept { return _peak; }
+
+        // Grows the slab to at least `capacity` bytes. Only allowed while
+        // nothing is allocated.
+        void reserve(std::size_t capacity) {
+            if (capacity <= _capacity || _in_use != 0) {
+                return;
+            }
+            capacity = (capacity + slab_alignment - 1) / slab_alignment * slab_alignment;
+            auto* slab = static_cast<std::byte*>(_upstream->allocate(capacity, slab_alignment));
+            if (_slab) {
+                _upstream->deallocate(_slab, _capacity, slab_alignment);
+            }
+            _slab = slab;
+            _capacity = capacity;
+        }
+
+        Mark mark() const noexcept {
+            return {_offset, _overflow.size()};
+        }
+
+        // Frees everything allocated since m was taken. After rewinding to
+        // the empty mark, the next allocation grows the slab to the peak
+        // usage seen so far.
+        void rewind(const Mark& m) noexcept {
+            while (_overflow.size() > m.overflow) {
+                const Block& b = _overflow.back();
+                _upstream->deallocate(b.p, b.bytes, b.alignment);
+                _in_use -= b.bytes;
+                _overflow_demand -= b.bytes + b.alignment;
+                _overflow.pop_back();
+            }
+            _in_use -= _offset - m.offset;
+            _offset = m.offset;
+        }
+
+    private:
+        void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+            if (_in_use == 0 && _peak > _capacity) {
+                reserve(_peak);
+            }
+            const std::size_t start = (_offset + alignment - 1) / alignment * alignment;
+            if (alignment <= slab_alignment && start + bytes <= _capacity) {
+                _in_use += start + bytes - _offset;
+                _offset = start + bytes;
+                _peak = std::max(_peak, _offset + _overflow_demand);
+                return _slab + start;
+            }
+            void* p = _upstream->allocate(bytes, alignment);
+            _overflow.push_back({p, bytes, alignment});
+            _in_use += bytes;
+            _overflow_demand += bytes + alignment;
+            _peak = std::max(_peak, _offset + _overflow_demand);
+            return p;
+        }
+
+        // memory is reclaimed by rewind()
+        void do_deallocate(void*, std::size_t, std::size_t) override {}
+
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+            return this == &other;
+        }
+};
+
+namespace pmr {
+
+    // TensorArray whose storage comes from current_resource() when it is
+    // made, e.g. from a Workspace within its scope
+    template <
+        typename ElementType,
+        typename Extents,
+        typename LayoutPolicy = LeftStride
+    > using TensorArray = nabla::TensorArray<ElementType, Extents, LayoutPolicy,
+                                             std::vector<ElementType, workspace_allocator<ElementType>>>;
+
+} // namespace pmr
+
+} // namespace nabla
+
+#endif // NABLA_WORKSPACE_HPP
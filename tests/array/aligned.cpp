@@ -0,0 +1,105 @@
+#define MDSPAN_DEBUG
+#define MDSPAN_USE_BRACKET_OPERATOR 0
+
+#include <cstdint>
+#include <iostream>
+#include <system_error>
+#include "mdspan/mdspan.hpp"
+#include "nabla/nabla.hpp"
+
+namespace nb = nabla;
+
+template <typename T>
+bool is_aligned(const T* p, std::size_t alignment) {
+    return reinterpret_cast<std::uintptr_t>(p) % alignment == 0;
+}
+
+template <typename TensorT>
+void iota(TensorT& t, float start = 0) {
+    for (auto it = t.begin(); it != t.end(); ++it) {
+        *it = start;
+        start += 1;
+    }
+}
+
+int main() {
+    using Ext = nb::dims<2>;
+    using AlignedArray = nb::TensorArray<float, Ext, nb::LeftStride, nb::aligned_vector<float>>;
+    using PageArray = nb::TensorArray<double, Ext, nb::LeftStride, nb::aligned_vector<double, 4096>>;
+    using HugeArray = nb::TensorArray<float, Ext, nb::LeftStride,
+                                      nb::aligned_vector<float, 64, nb::memory_hint::huge_pages>>;
+
+    int error_count = 0;
+
+    // storage alignment
+    {
+        AlignedArray a(7, 3);
+        PageArray b(5, 5);
+        HugeArray h(1024, 1024);
+        if (!is_aligned(a.data(), 64) || !is_aligned(b.data(), 4096) || !is_aligned(h.data(), std::size_t(1) << 21)) {
+            std::cerr << "Error in aligned_allocator: storage is not aligned\n";
+            ++error_count;
+        }
+        AlignedArray c(a);
+        AlignedArray m(a + a);
+        if (!is_aligned(c.data(), 64) || !is_aligned(m.data(), 64)) {
+            std::cerr << "Error in aligned_allocator: copies are not aligned\n";
+            ++error_count;
+        }
+        static_assert(nb::detail::data_alignment<AlignedArray>() == 64);
+        static_assert(nb::detail::data_alignment<PageArray>() == 4096);
+    }
+
+    // locked pages need RLIMIT_MEMLOCK, so only the failure mode is checked
+    {
+        try {
+            nb::aligned_vector<float, 64, nb::memory_hint::locked> v(1024);
+            if (!is_aligned(v.data(), 64)) {
+                std::cerr << "Error in aligned_allocator: locked storage is not aligned\n";
+                ++error_count;
+            }
+        } catch (const std::system_error&) {
+        }
+    }
+
+    // aligned spans take the plain-memory kernels, subspans drop the guarantee
+    {
+        AlignedArray a(33, 17);
+        AlignedArray r(33, 17);
+        iota(a);
+        auto s = a.to_span(nb::aligned_accessor<float>{});
+        static_assert(nb::detail::IsPointerBacked<decltype(s)>);
+        static_assert(std::is_same_v<decltype(nb::subspan(s, std::pair{1, 3}, nb::full_extent))::accessor_type,
+                                     nb::default_accessor<float>>);
+        auto rs = r.to_span(nb::aligned_accessor<float>{});
+        rs = s*2 + a;
+        float expected = 0;
+        for (auto it = a.begin(); it != a.end(); ++it) {
+            expected += *it;
+        }
+        for (size_t j = 0; j < 17; ++j) {
+            for (size_t i = 0; i < 33; ++i) {
+                if (r(i,j) != 3*a(i,j)) {
+                    std::cerr << "Error in aligned_accessor: expression at (" << i << "," << j << ")\n";
+                    ++error_count;
+                }
+            }
+        }
+        if (nb::sum(s) != expected || s(4, 2) != a(4, 2)) {
+            std::cerr << "Error in aligned_accessor: reads\n";
+            ++error_count;
+        }
+        auto sub = nb::subspan(s, std::pair{1, 3}, std::pair{2, 4});
+        if (sub(0, 0) != a(1, 2)) {
+            std::cerr << "Error in aligned_accessor: subspan\n";
+            ++error_count;
+        }
+    }
+
+    if (error_count == 0) {
+        std::cout << "All tests passed!" << std::endl;
+    } else {
+        std::cout << error_count << " tests failed." << std::endl;
+    }
+    return error_count;
+}
@@ -0,0 +1,120 @@
+#define MDSPAN_DEBUG
+#define MDSPAN_USE_BRACKET_OPERATOR 0
+
+#include <vector>
+#include <array>
+#include <iostream>
+#include "mdspan/mdspan.hpp"
+#include "nabla/nabla.hpp"
+
+namespace nb = nabla;
+
+template <typename TensorT>
+void iota(TensorT& t, int start = 0) {
+    for (auto it = t.begin(); it != t.end(); ++it) {
+        *it = start++;
+    }
+}
+
+template <typename TensorA, typename TensorB>
+    requires (TensorA::rank() == 2 && TensorB::rank() == 2)
+int compare(const char* name, const TensorA& a, const TensorB& b) {
+    for (size_t j = 0; j < a.extent(1); ++j) {
+        for (size_t i = 0; i < a.extent(0); ++i) {
+            if (a(i,j) != b(i,j)) {
+                std::cerr << "Error in " << name << " at (" << i << "," << j << "): expected "
+                          << b(i,j) << ", got " << a(i,j) << "\n";
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
+
+int main() {
+    using Layout = nb::LeftStride;
+    using Ext = nb::dims<2>;
+    using Map = Layout::mapping<Ext>;
+    using TensorArray = nb::TensorArray<int, Ext, Layout>;
+    using TensorSpan = nb::TensorSpan<int, Ext, Layout>;
+
+    int error_count = 0;
+
+    // exhaustive, identical layouts
+    {
+        TensorArray a(5, 7);
+        TensorArray b(5, 7);
+        iota(a);
+        b = a;
+        error_count += compare("exhaustive array copy", b, a);
+
+        TensorSpan sb = b.to_span();
+        b.zero();
+        sb = a.to_span();
+        error_count += compare("exhaustive span copy", sb, a);
+    }
+
+    // non-exhaustive, identical layouts: gaps must be left untouched
+    {
+        Map map({4, 3}, {1, 10});
+        std::vector<int> data1(map.required_span_size(), -1);
+        std::vector<int> data2(map.required_span_size(), -1);
+        TensorSpan a(data1.data(), map);
+        TensorSpan b(data2.data(), map);
+        iota(a);
+        b = a;
+        error_count += compare("strided span copy", b, a);
+        for (size_t j = 0; j < 3; ++j) {
+            for (size_t i = 4; i < 10 && j*10 + i < data2.size(); ++i) {
+                if (data2[j*10 + i] != -1) {
+                    std::cerr << "Error in strided span copy: gap at " << j*10 + i << " was written\n";
+                    ++error_count;
+                }
+            }
+        }
+    }
+
+    // different layouts fall back to the elementwise path
+    {
+        TensorArray a(Map({4, 3}, {1, 10}));
+        TensorArray b(Map({4, 3}));
+        iota(a);
+        b = a;
+        error_count += compare("mixed layout copy", b, a);
+
+        auto sub = nb::subspan(a, std::pair{1, 3}, std::pair{0, 3});
+        TensorArray c(2, 3);
+        c = sub;
+        error_count += compare("subspan copy", c, sub);
+    }
+
+    // fill / zero
+    {
+        TensorArray a(Map({4, 3}, {1, 10}));
+        a.fill(7);
+        TensorArray sevens(4, 3);
+        for (auto it = sevens.begin(); it != sevens.end(); ++it) {
+            *it = 7;
+        }
+        error_count += compare("array fill", a, sevens);
+
+        auto sub = nb::subspan(a, std::pair{1, 3}, std::pair{1, 3});
+        sub.zero();
+        for (size_t j = 0; j < 3; ++j) {
+            for (size_t i = 0; i < 4; ++i) {
+                bool inside = i >= 1 && i < 3 && j >= 1;
+                if (a(i,j) != (inside ? 0 : 7)) {
+                    std::cerr << "Error in span zero at (" << i << "," << j << "): got " << a(i,j) << "\n";
+                    ++error_count;
+                }
+            }
+        }
+    }
+
+    if (error_count == 0) {
+        std::cout << "All tests passed!" << std::endl;
+    } else {
+        std::cout << error_count << " tests failed." << std::endl;
+    }
+    return error_count;
+}
@@ -0,0 +1,147 @@
+#define MDSPAN_DEBUG
+#define MDSPAN_USE_BRACKET_OPERATOR 0
+
+#include <iostream>
+#include <stdexcept>
+#include "mdspan/mdspan.hpp"
+#include "nabla/nabla.hpp"
+
+namespace nb = nabla;
+
+template <typename TensorT>
+void iota(TensorT& t, float start = 0) {
+    for (auto it = t.begin(); it != t.end(); ++it) {
+        *it = start;
+        start += 1;
+    }
+}
+
+template <typename TensorT, typename F>
+    requires (TensorT::rank() == 3)
+int check(const char* name, const TensorT& t, F&& expected) {
+    for (size_t k = 0; k < t.extent(2); ++k) {
+        for (size_t j = 0; j < t.extent(1); ++j) {
+            for (size_t i = 0; i < t.extent(0); ++i) {
+                if (t(i,j,k) != expected(i,j,k)) {
+                    std::cerr << "Error in " << name << " at (" << i << "," << j << "," << k << "): expected "
+                              << expected(i,j,k) << ", got " << t(i,j,k) << "\n";
+                    return 1;
+                }
+            }
+        }
+    }
+    return 0;
+}
+
+int main() {
+    using Layout = nb::LeftStride;
+    using Ext = nb::dims<3>;
+    using TensorArray = nb::TensorArray<float, Ext, Layout>;
+
+    nb::ThreadPool pool(3);
+    const auto policy = nb::par.on(pool).with_serial_cutoff(0).with_grain_size(5);
+
+    int error_count = 0;
+
+    TensorArray a(5, 4, 3);
+    TensorArray row(1, 4, 3);
+    TensorArray col(5, 1, 1);
+    TensorArray one(1, 1, 1);
+    iota(a);
+    iota(row, 100);
+    iota(col, -10);
+    one(0, 0, 0) = 7;
+
+    // broadcast views repeat elements without copying
+    {
+        auto v = nb::broadcast_to(col, std::array<size_t, 3>{5, 4, 3});
+        if (v.data_handle() != col.data() || v.stride(1) != 0 || v.stride(2) != 0 || v.is_unique()) {
+            std::cerr << "Error in broadcast_to: expected a stride 0 view of the operand\n";
+            ++error_count;
+        }
+        error_count += check("broadcast_to", v, [&](size_t i, size_t, size_t) { return col(i,0,0); });
+    }
+
+    // stretched along dimension 0, where the operand is hoisted per row
+    {
+        TensorArray r(5, 4, 3);
+        r = a + row;
+        error_count += check("broadcast inner", r, [&](size_t i, size_t j, size_t k) {
+            return a(i,j,k) + row(0,j,k);
+        });
+    }
+
+    // stretched along the outer dimensions
+    {
+        TensorArray r(5, 4, 3);
+        r = a*col - one;
+        error_count += check("broadcast outer", r, [&](size_t i, size_t j, size_t k) {
+            return a(i,j,k)*col(i,0,0) - one(0,0,0);
+        });
+    }
+
+    // both operands stretched, and nested expressions
+    {
+        TensorArray r(5, 4, 3);
+        r = (col + row)*2 + a;
+        error_count += check("broadcast both", r, [&](size_t i, size_t j, size_t k) {
+            return (col(i,0,0) + row(0,j,k))*2 + a(i,j,k);
+        });
+        auto e = col*row;
+        error_count += check("broadcast expression access", e, [&](size_t i, size_t j, size_t k) {
+            return col(i,0,0)*row(0,j,k);
+        });
+        TensorArray s(5, 4, 3);
+        auto it = e.begin();
+        for (auto out = s.begin(); out != s.end(); ++out, ++it) {
+            *out = *it;
+        }
+        error_count += check("broadcast expression iterator", s, [&](size_t i, size_t j, size_t k) {
+            return col(i,0,0)*row(0,j,k);
+        });
+    }
+
+    // parallel assignment and reductions
+    {
+        TensorArray r(5, 4, 3);
+        nb::assign(policy, r, a - row);
+        error_count += check("broadcast parallel", r, [&](size_t i, size_t j, size_t k) {
+            return a(i,j,k) - row(0,j,k);
+        });
+        float expected = 0;
+        for (size_t k = 0; k < 3; ++k) {
+            for (size_t j = 0; j < 4; ++j) {
+                for (size_t i = 0; i < 5; ++i) {
+                    expected += a(i,j,k)*col(i,0,0);
+                }
+            }
+        }
+        if (nb::sum(policy, a*col) != expected) {
+            std::cerr << "Error in broadcast sum: expected " << expected << ", got " << nb::sum(a*col) << "\n";
+            ++error_count;
+        }
+    }
+
+    // incompatible extents
+    {
+        TensorArray b(4, 4, 3);
+        bool caught = false;
+        try {
+            auto e = a + b;
+            (void)e;
+        } catch (const std::invalid_argument&) {
+            caught = true;
+        }
+        if (!caught) {
+            std::cerr << "Error in broadcast mismatch: expected std::invalid_argument\n";
+            ++error_count;
+        }
+    }
+
+    if (error_count == 0) {
+        std::cout << "All tests passed!" << std::endl;
+    } else {
+        std::cout << error_count << " tests failed." << std::endl;
+    }
+    return error_count;
+}
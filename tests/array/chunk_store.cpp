@@ -0,0 +1,234 @@
+#define MDSPAN_DEBUG
+#define MDSPAN_USE_BRACKET_OPERATOR 0
+
+#include <cmath>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include <unistd.h>
+#include "mdspan/mdspan.hpp"
+#include "nabla/nabla.hpp"
+
+namespace nb = nabla;
+
+template <typename F>
+bool throws(F&& f) {
+    try {
+        f();
+    } catch (const std::invalid_argument&) {
+        return true;
+    }
+    return false;
+}
+
+std::uintmax_t directory_size(const std::filesystem::path& dir) {
+    std::uintmax_t size = 0;
+    for (const auto& entry : std::filesystem::directory_iterator(dir)) {
+        size += entry.file_size();
+    }
+    return size;
+}
+
+int main() {
+    using Ext = nb::dims<3>;
+    using Array = nb::TensorArray<double, Ext>;
+    using Store = nb::ChunkStore<double, Ext>;
+    using ss = nb::strided_slice<size_t, size_t, size_t>;
+    const auto dir = std::filesystem::temp_directory_path() / ("nabla_chunk_store_" + std::to_string(::getpid()));
+    std::filesystem::create_directories(dir);
+
+    int error_count = 0;
+
+    // the codec round trips every kind of data and rejects damaged input
+    {
+        std::mt19937 rng(7);
+        std::vector<std::vector<double>> inputs;
+        inputs.push_back({});
+        inputs.push_back(std::vector<double>(1, 3.5));
+        inputs.push_back(std::vector<double>(5000, 0.0));
+        std::vector<double> smooth(5000), noise(5000);
+        for (size_t i = 0; i < smooth.size(); ++i) {
+            smooth[i] = std::sin(0.01*i);
+            noise[i] = std::uniform_real_distribution<double>(-1, 1)(rng);
+        }
+        inputs.push_back(smooth);
+        inputs.push_back(noise);
+        size_t failures = 0;
+        for (auto codec : {nb::chunk_codec::none, nb::chunk_codec::shuffle_lz, nb::chunk_codec::shuffle_delta_lz}) {
+            for (const auto& in : inputs) {
+                std::vector<std::uint8_t> encoded;
+                const auto used = nb::detail::encode_chunk(in.data(), in.size(), sizeof(double), codec, encoded);
+                std::vector<double> out(in.size());
+                nb::detail::decode_chunk(encoded.data(), encoded.size(), used, out.data(), out.size(), sizeof(double));
+                failures += out != in;
+                failures += in.size() == 5000 && in[1] == 0.0 && codec != nb::chunk_codec::none && encoded.size() > 200;
+            }
+        }
+        std::vector<std::uint8_t> encoded;
+        nb::detail::encode_chunk(smooth.data(), smooth.size(), sizeof(double), nb::chunk_codec::shuffle_lz, encoded);
+        std::vector<double> out(smooth.size());
+        failures += !throws([&] { nb::detail::decode_chunk(encoded.data(), encoded.size() - 3, nb::chunk_codec::shuffle_lz, out.data(), out.size(), sizeof(double)); });
+        failures += !throws([&] { nb::detail::decode_chunk(encoded.data(), encoded.size(), nb::chunk_codec::shuffle_lz, out.data(), out.size() - 1, sizeof(double)); });
+        // empty chunks pass null pointers, clean under -fsanitize=undefined
+        nb::detail::decode_chunk(nullptr, 0, nb::chunk_codec::none, nullptr, 0, sizeof(double));
+        failures += !throws([&] { nb::detail::decode_chunk(encoded.data(), encoded.size(), nb::chunk_codec::shuffle_lz, nullptr, 0, sizeof(double)); });
+        if (failures != 0) {
+            std::cerr << "Error in chunk codec: " << failures << " failures\n";
+            ++error_count;
+        }
+    }
+
+    // smooth field over a grid of 5x4x3 chunks, with partial edge chunks
+    Array a(37, 29, 23);
+    for (size_t k = 0; k < a.extent(2); ++k) {
+        for (size_t j = 0; j < a.extent(1); ++j) {
+            for (size_t i = 0; i < a.extent(0); ++i) {
+                a(i, j, k) = std::sin(0.1*i) * std::cos(0.05*j) + 0.01*k;
+            }
+        }
+    }
+    auto equal = [&](const auto& x, const auto& y) {
+        for (size_t k = 0; k < x.extent(2); ++k) {
+            for (size_t j = 0; j < x.extent(1); ++j) {
+                for (size_t i = 0; i < x.extent(0); ++i) {
+                    if (x(i, j, k) != y(i, j, k)) {
+                        return false;
+                    }
+                }
+            }
+        }
+        return true;
+    };
+
+    // whole tensors round trip through a reopened store, compressed
+    {
+        Store store(dir / "a", a.extents(), {8, 8, 8}, nb::chunk_codec::shuffle_delta_lz);
+        store.write(nb::par, a);
+        Store reopened(dir / "a");
+        Array b(37, 29, 23);
+        reopened.read(nb::par, b);
+        Array c(37, 29, 23);
+        reopened.read(c);
+        if (reopened.codec() != nb::chunk_codec::shuffle_delta_lz || reopened.chunk_shape()[2] != 8 ||
+            reopened.grid_extent(0) != 5 || !equal(a, b) || !equal(a, c)) {
+            std::cerr << "Error in chunk store: round trip\n";
+            ++error_count;
+        }
+        if (directory_size(dir / "a") >= 5*4*3*512*sizeof(double)) {
+            std::cerr << "Error in chunk store: no compression, " << directory_size(dir / "a") << " bytes\n";
+            ++error_count;
+        }
+        // edge chunks store their padding as zeros, the files do not depend
+        // on the run
+        Store again(dir / "again", a.extents(), {8, 8, 8}, nb::chunk_codec::shuffle_delta_lz);
+        again.write(a);
+        auto bytes = [](const std::filesystem::path& path) {
+            std::ifstream in(path, std::ios::binary);
+            return std::string(std::istreambuf_iterator<char>(in), {});
+        };
+        if (bytes(dir / "a" / "4.3.2") != bytes(dir / "again" / "4.3.2") || bytes(dir / "a" / "4.0.0") != bytes(dir / "again" / "4.0.0")) {
+            std::cerr << "Error in chunk store: edge chunks differ between writes\n";
+            ++error_count;
+        }
+    }
+
+    // writes of part of a chunk merge with its contents
+    {
+        Store store(dir / "a");
+        Array block(5, 12, 3);
+        block.fill(-1.0);
+        store.write(nb::par, block, {6, 3, 9});
+        Array b(37, 29, 23);
+        store.read(nb::par, b);
+        size_t mismatches = 0;
+        for (size_t k = 0; k < 23; ++k) {
+            for (size_t j = 0; j < 29; ++j) {
+                for (size_t i = 0; i < 37; ++i) {
+                    const bool inside = i >= 6 && i < 11 && j >= 3 && j < 15 && k >= 9 && k < 12;
+                    mismatches += b(i, j, k) != (inside ? -1.0 : a(i, j, k));
+                }
+            }
+        }
+        store.write(a);
+        if (mismatches != 0) {
+            std::cerr << "Error in chunk store: partial write, " << mismatches << " mismatches\n";
+            ++error_count;
+        }
+    }
+
+    // subspan-style regions, with dropped dimensions and strides
+    {
+        Store store(dir / "a");
+        auto r = store.read(nb::par, nb::full_extent, 5, ss{2, 20, 3});
+        auto q = store.read(std::pair<size_t, size_t>{30, 37}, ss{0, 29, 10}, 22);
+        static_assert(decltype(r)::rank() == 2 && decltype(q)::rank() == 2);
+        size_t mismatches = r.extent(0) != 37 || r.extent(1) != 7 || q.extent(0) != 7 || q.extent(1) != 3;
+        for (size_t m = 0; m < 7; ++m) {
+            for (size_t i = 0; i < 37; ++i) {
+                mismatches += r(i, m) != a(i, 5, 2 + 3*m);
+            }
+        }
+        for (size_t j = 0; j < 3; ++j) {
+            for (size_t i = 0; i < 7; ++i) {
+                mismatches += q(i, j) != a(30 + i, 10*j, 22);
+            }
+        }
+        Array b(10, 10, 10);
+        store.read(nb::par, b, {27, 19, 13});
+        mismatches += !equal(b, nb::subspan(a, ss{27, 10, 1}, ss{19, 10, 1}, ss{13, 10, 1}));
+        if (mismatches != 0) {
+            std::cerr << "Error in chunk store: regions, " << mismatches << " mismatches\n";
+            ++error_count;
+        }
+        if (!throws([&] { store.read(nb::full_extent, nb::full_extent, ss{20, 4, 1}); }) ||
+            !throws([&] { store.read(b, {28, 0, 0}); })) {
+            std::cerr << "Error in chunk store: out of range regions\n";
+            ++error_count;
+        }
+    }
+
+    // regions decode only the chunks they touch; missing chunks read as zero
+    {
+        Store store(dir / "a");
+        {
+            std::ofstream damaged(dir / "a" / "4.3.2", std::ios::binary | std::ios::trunc);
+            damaged << "not a chunk, but long enough";
+        }
+        std::filesystem::remove(dir / "a" / "0.0.0");
+        auto r = store.read(nb::par, ss{0, 16, 1}, ss{0, 16, 1}, 0);
+        bool ok = r(0, 0) == 0 && r(7, 7) == 0 && r(8, 0) == a(8, 0, 0) && r(15, 15) == a(15, 15, 0);
+        ok = ok && throws([&] { Array b(37, 29, 23); store.read(nb::par, b); });
+        if (!ok) {
+            std::cerr << "Error in chunk store: chunk selection\n";
+            ++error_count;
+        }
+    }
+
+    // stores of another type or shape do not open
+    {
+        std::filesystem::create_directories(dir / "other");
+        std::ofstream(dir / "other" / "file") << "x";
+        bool ok = throws([&] { nb::ChunkStore<float, Ext> s(dir / "a"); }) &&
+                  throws([&] { nb::ChunkStore<double, nb::dims<2>> s(dir / "a"); }) &&
+                  throws([&] { nb::ChunkStore<double, nb::extents<size_t, 36, std::dynamic_extent, std::dynamic_extent>> s(dir / "a"); }) &&
+                  throws([&] { Store s(dir / "missing"); }) &&
+                  throws([&] { Store s(dir / "other", Ext(2, 2, 2), {1, 1, 1}); });
+        if (!ok) {
+            std::cerr << "Error in chunk store: validation\n";
+            ++error_count;
+        }
+    }
+
+    std::filesystem::remove_all(dir);
+
+    if (error_count == 0) {
+        std::cout << "All tests passed!" << std::endl;
+    } else {
+        std::cout << error_count << " tests failed." << std::endl;
+    }
+    return error_count;
+}
@@ -0,0 +1,164 @@
+#define MDSPAN_DEBUG
+#define MDSPAN_USE_BRACKET_OPERATOR 0
+
+#include <bit>
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <vector>
+#include "mdspan/mdspan.hpp"
+#include "nabla/nabla.hpp"
+
+namespace nb = nabla;
+
+int main() {
+    using Ext = nb::dims<2>;
+    using Array = nb::TensorArray<float, Ext>;
+
+    nb::ThreadPool pool(3);
+    const auto policy = nb::par.on(pool).with_serial_cutoff(0).with_grain_size(100);
+
+    int error_count = 0;
+
+    // every float16 widens exactly and narrows back to itself
+    {
+        size_t wrong = 0;
+        for (std::uint32_t b = 0; b < 65536; ++b) {
+            const auto h = nb::float16::from_bits(static_cast<std::uint16_t>(b));
+            const float x = h;
+            if (std::isnan(x)) {
+                wrong += (b & 0x7c00u) != 0x7c00u || !std::isnan(static_cast<float>(nb::float16(x)));
+            } else {
+                wrong += nb::float16(x).bits != b;
+            }
+        }
+        if (wrong != 0) {
+            std::cerr << "Error in float16 round trip: " << wrong << " bit patterns differ\n";
+            ++error_count;
+        }
+    }
+
+    // narrowing rounds to nearest even and saturates to infinity
+    {
+        struct Case { float x; std::uint16_t half; std::uint16_t bf; };
+        const Case cases[] = {
+            {1.0f, 0x3c00, 0x3f80},
+            {65504.0f, 0x7bff, 0x4780},
+            {65520.0f, 0x7c00, 0x4780},
+            {1.0f + 0x1p-11f, 0x3c00, 0x3f80},
+            {1.0f + 3 * 0x1p-11f, 0x3c02, 0x3f80},
+            {0x1p-24f, 0x0001, 0x3380},
+            {0x1p-25f, 0x0000, 0x3300},
+            {-0.0f, 0x8000, 0x8000},
+            {std::bit_cast<float>(0x3f808000u), 0x3c04, 0x3f80},
+            {std::bit_cast<float>(0x3f818000u), 0x3c0c, 0x3f82},
+            {std::numeric_limits<float>::infinity(), 0x7c00, 0x7f80},
+        };
+        for (const auto& c : cases) {
+            if (nb::float16(c.x).bits != c.half || nb::bfloat16(c.x).bits != c.bf) {
+                std::cerr << "Error in narrowing " << c.x << ": got " << std::hex << nb::float16(c.x).bits
+                          << " and " << nb::bfloat16(c.x).bits << std::dec << "\n";
+                ++error_count;
+            }
+        }
+        const float nan = std::numeric_limits<float>::quiet_NaN();
+        if (!std::isnan(static_cast<float>(nb::float16(nan))) || !std::isnan(static_cast<float>(nb::bfloat16(nan)))) {
+            std::cerr << "Error in narrowing NaN\n";
+            ++error_count;
+        }
+        static_assert(nb::float16(1.5f).bits == 0x3e00 && static_cast<float>(nb::bfloat16::from_bits(0x4049)) == 3.140625f);
+    }
+
+    Array a(37, 11);
+    for (size_t j = 0; j < a.extent(1); ++j) {
+        for (size_t i = 0; i < a.extent(0); ++i) {
+            a(i, j) = std::sin(0.3f * i) * std::exp2(static_cast<float>(j) * 3 - 14) + (i == 5 ? 1e6f : 0.0f);
+        }
+    }
+
+    // assignment converts in bulk, agreeing with the scalar conversions
+    auto check_assign = [&]<typename S>(const char* name, S) {
+        nb::TensorArray<S, Ext> h(37, 11), p(37, 11);
+        h = a;
+        nb::assign(policy, p, a);
+        Array b(37, 11), c(37, 11);
+        b = h;
+        nb::assign(policy, c, p);
+        size_t wrong = 0;
+        for (size_t j = 0; j < a.extent(1); ++j) {
+            for (size_t i = 0; i < a.extent(0); ++i) {
+                const float expected = S(a(i, j));
+                wrong += h(i, j).bits != S(a(i, j)).bits || p(i, j).bits != h(i, j).bits;
+                wrong += b(i, j) != expected || c(i, j) != expected;
+            }
+        }
+        nb::TensorArray<S, Ext, nb::RightStride> r(37, 11);
+        r = a;
+        for (size_t j = 0; j < a.extent(1); ++j) {
+            for (size_t i = 0; i < a.extent(0); ++i) {
+                wrong += r(i, j).bits != h(i, j).bits;
+            }
+        }
+        if (wrong != 0) {
+            std::cerr << "Error in " << name << " assignment: " << wrong << " elements differ\n";
+            ++error_count;
+        }
+    };
+    check_assign("float16", nb::float16{});
+    check_assign("bfloat16", nb::bfloat16{});
+
+    // float views compute in float and round once on the way out
+    {
+        nb::TensorArray<nb::float16, Ext> h(37, 11);
+        h = a;
+        const Array wide(h);
+        auto x = nb::as_float(h);
+        if (nb::sum(x * 2.0f) != nb::sum(wide * 2.0f)) {
+            std::cerr << "Error in as_float expression\n";
+            ++error_count;
+        }
+        const auto& ch = h;
+        if (nb::sum(nb::as_float(ch)) != nb::sum(wide)) {
+            std::cerr << "Error in const as_float\n";
+            ++error_count;
+        }
+
+        nb::TensorArray<nb::float16, Ext> g(h);
+        x = x * 0.5f + 1.0f;
+        nb::assign(policy, nb::as_float(g), nb::as_float(g) * 0.5f + 1.0f);
+        size_t wrong = 0;
+        for (size_t j = 0; j < a.extent(1); ++j) {
+            for (size_t i = 0; i < a.extent(0); ++i) {
+                const nb::float16 expected(wide(i, j) * 0.5f + 1.0f);
+                wrong += h(i, j).bits != expected.bits || g(i, j).bits != expected.bits;
+            }
+        }
+        if (wrong != 0) {
+            std::cerr << "Error in as_float assignment: " << wrong << " elements differ\n";
+            ++error_count;
+        }
+
+        auto sx = nb::subspan(x, std::pair{3, 20}, std::pair{2, 9});
+        sx(0, 0) += 1.0f;
+        sx = sx * 2.0f;
+        wrong = 0;
+        for (size_t j = 0; j < sx.extent(1); ++j) {
+            for (size_t i = 0; i < sx.extent(0); ++i) {
+                const float before = g(i + 3, j + 2) + (i == 0 && j == 0 ? 1.0f : 0.0f);
+                wrong += h(i + 3, j + 2).bits != nb::float16(static_cast<float>(nb::float16(before)) * 2.0f).bits;
+            }
+        }
+        if (wrong != 0 || h(2, 2).bits != g(2, 2).bits) {
+            std::cerr << "Error in as_float subspan: " << wrong << " elements differ\n";
+            ++error_count;
+        }
+    }
+
+    if (error_count == 0) {
+        std::cout << "All tests passed!" << std::endl;
+    } else {
+        std::cout << error_count << " tests failed." << std::endl;
+    }
+    return error_count;
+}
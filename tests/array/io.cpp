@@ -0,0 +1,174 @@
+#define MDSPAN_DEBUG
+#define MDSPAN_USE_BRACKET_OPERATOR 0
+
+#include <complex>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <unistd.h>
+#include "mdspan/mdspan.hpp"
+#include "nabla/nabla.hpp"
+
+namespace nb = nabla;
+
+template <typename F>
+bool throws(F&& f) {
+    try {
+        f();
+    } catch (const std::invalid_argument&) {
+        return true;
+    }
+    return false;
+}
+
+template <typename A, typename B>
+bool equal(const A& a, const B& b) {
+    for (size_t k = 0; k < a.extent(2); ++k) {
+        for (size_t j = 0; j < a.extent(1); ++j) {
+            for (size_t i = 0; i < a.extent(0); ++i) {
+                if (a(i, j, k) != b(i, j, k)) {
+                    return false;
+                }
+            }
+        }
+    }
+    return true;
+}
+
+int main() {
+    using Ext = nb::dims<3>;
+    using Array = nb::TensorArray<double, Ext>;
+    using RightArray = nb::TensorArray<double, Ext, nb::RightStride>;
+    using ss = nb::strided_slice<size_t, size_t, size_t>;
+    const auto dir = std::filesystem::temp_directory_path() / ("nabla_io_" + std::to_string(::getpid()));
+    std::filesystem::create_directories(dir);
+
+    int error_count = 0;
+
+    // 13 MB, several chunks
+    Array a(130, 101, 127);
+    for (size_t k = 0; k < a.extent(2); ++k) {
+        for (size_t j = 0; j < a.extent(1); ++j) {
+            for (size_t i = 0; i < a.extent(0); ++i) {
+                a(i, j, k) = static_cast<double>(i) + 1000.0*j - 0.25*k;
+            }
+        }
+    }
+
+    // round trips of a packed array, in parallel and sequentially
+    {
+        nb::write_tensor(nb::par, dir / "a.nbt", a);
+        auto b = nb::read_tensor<Array>(nb::par, dir / "a.nbt");
+        Array c(130, 101, 127);
+        nb::read_tensor(dir / "a.nbt", c);
+        nb::write_tensor(dir / "a_seq.nbt", a);
+        if (!equal(a, b) || !equal(a, c) || std::filesystem::file_size(dir / "a.nbt") != std::filesystem::file_size(dir / "a_seq.nbt")) {
+            std::cerr << "Error in tensor io: round trip\n";
+            ++error_count;
+        }
+        auto d = nb::read_tensor<Array>(nb::par, dir / "a_seq.nbt");
+        if (!equal(a, d)) {
+            std::cerr << "Error in tensor io: sequential write, parallel read\n";
+            ++error_count;
+        }
+    }
+
+    // strided subspans are gathered and scattered by runs
+    {
+        auto s = nb::subspan(a, ss{3, 100, 1}, ss{1, 50, 2}, ss{0, 127, 1});
+        nb::write_tensor(nb::par, dir / "s.nbt", s);
+        auto b = nb::read_tensor<Array>(nb::par, dir / "s.nbt");
+        Array c(130, 101, 127);
+        c.zero();
+        auto t = nb::subspan(c, ss{3, 100, 1}, ss{1, 50, 2}, ss{0, 127, 1});
+        nb::read_tensor(nb::par, dir / "s.nbt", t);
+        if (b.extent(0) != 100 || b.extent(1) != 25 || !equal(s, b) || !equal(s, t) || c(0, 0, 0) != 0 || c(3, 2, 0) != 0) {
+            std::cerr << "Error in tensor io: strided subspan\n";
+            ++error_count;
+        }
+    }
+
+    // files keep the writer's order and read into any layout
+    {
+        RightArray r(a);
+        nb::write_tensor(nb::par, dir / "r.nbt", r);
+        auto b = nb::read_tensor<Array>(nb::par, dir / "r.nbt");
+        auto c = nb::read_tensor<RightArray>(nb::par, dir / "a.nbt");
+        auto p = nb::permute(a, std::array<size_t, 3>{2, 0, 1});
+        nb::write_tensor(dir / "p.nbt", p);
+        auto d = nb::read_tensor<Array>(nb::par, dir / "p.nbt");
+        if (!equal(a, b) || !equal(a, c) || !equal(p, d)) {
+            std::cerr << "Error in tensor io: layouts\n";
+            ++error_count;
+        }
+    }
+
+    // other element types and non-pointer accessors
+    {
+        using cfloat = std::complex<float>;
+        nb::TensorArray<cfloat, nb::dims<2>> z(7, 3);
+        for (size_t j = 0; j < 3; ++j) {
+            for (size_t i = 0; i < 7; ++i) {
+                z(i, j) = cfloat(i, j);
+            }
+        }
+        nb::write_tensor(dir / "z.nbt", nb::conj(z));
+        auto w = nb::read_tensor<nb::TensorArray<cfloat, nb::dims<2>>>(dir / "z.nbt");
+        if (w(5, 2) != cfloat(5, -2) || throws([&] { nb::read_tensor<nb::TensorArray<std::complex<double>, nb::dims<2>>>(dir / "z.nbt"); }) == false) {
+            std::cerr << "Error in tensor io: complex and conj\n";
+            ++error_count;
+        }
+    }
+
+    // rank 0 tensors hold one element and no extents
+    {
+        using Scalar = nb::TensorArray<double, nb::extents<std::size_t>>;
+        Scalar x;
+        x() = 2.5;
+        nb::write_tensor(dir / "x.nbt", x);
+        auto y = nb::read_tensor<Scalar>(dir / "x.nbt");
+        Scalar z;
+        nb::read_tensor(nb::par, dir / "x.nbt", z);
+        if (y() != 2.5 || z() != 2.5) {
+            std::cerr << "Error in tensor io: rank 0 round trip\n";
+            ++error_count;
+        }
+    }
+
+    // mismatched and damaged files are rejected
+    {
+        Array small(4, 4, 4);
+        bool ok = throws([&] { nb::read_tensor(dir / "a.nbt", small); }) &&
+                  throws([&] { nb::read_tensor<nb::TensorArray<float, Ext>>(dir / "a.nbt"); }) &&
+                  throws([&] { nb::read_tensor<nb::TensorArray<double, nb::dims<2>>>(dir / "a.nbt"); }) &&
+                  throws([&] { nb::read_tensor<nb::TensorArray<double, nb::extents<size_t, 131, std::dynamic_extent, std::dynamic_extent>>>(dir / "a.nbt"); });
+
+        std::filesystem::copy_file(dir / "a.nbt", dir / "bad.nbt");
+        {
+            std::fstream f(dir / "bad.nbt", std::ios::binary | std::ios::in | std::ios::out);
+            f.seekg(4096 + 5*1000*1000 + 3);
+            const char c = static_cast<char>(f.get() ^ 1);
+            f.seekp(4096 + 5*1000*1000 + 3);
+            f.put(c);
+        }
+        ok = ok && throws([&] { nb::read_tensor<Array>(nb::par, dir / "bad.nbt"); });
+        std::filesystem::resize_file(dir / "bad.nbt", 4096 + 1000);
+        ok = ok && throws([&] { nb::read_tensor<Array>(nb::par, dir / "bad.nbt"); });
+        std::filesystem::resize_file(dir / "bad.nbt", 10);
+        ok = ok && throws([&] { nb::read_tensor<Array>(dir / "bad.nbt"); });
+        if (!ok) {
+            std::cerr << "Error in tensor io: validation\n";
+            ++error_count;
+        }
+    }
+
+    std::filesystem::remove_all(dir);
+
+    if (error_count == 0) {
+        std::cout << "All tests passed!" << std::endl;
+    } else {
+        std::cout << error_count << " tests failed." << std::endl;
+    }
+    return error_count;
+}
@@ -0,0 +1,171 @@
+#define MDSPAN_DEBUG
+#define MDSPAN_USE_BRACKET_OPERATOR 0
+
+#include <cstddef>
+#include <iostream>
+#include <stdexcept>
+#include "mdspan/mdspan.hpp"
+#include "nabla/nabla.hpp"
+
+namespace nb = nabla;
+
+template <typename F>
+bool throws(F&& f) {
+    try {
+        f();
+    } catch (const std::invalid_argument&) {
+        return true;
+    }
+    return false;
+}
+
+int main() {
+    using Ext = nb::dims<2>;
+    using Array = nb::TensorArray<double, Ext>;
+    using Mask = nb::MaskArray<Ext>;
+
+    nb::ThreadPool pool(3);
+    const auto policy = nb::par.on(pool).with_serial_cutoff(0).with_grain_size(100);
+
+    int error_count = 0;
+
+    // 13 x 11 = 143 elements, two full words and a partial one
+    Array a(13, 11);
+    for (size_t j = 0; j < a.extent(1); ++j) {
+        for (size_t i = 0; i < a.extent(0); ++i) {
+            a(i, j) = static_cast<double>((i * 7 + j * 3) % 10);
+        }
+    }
+    auto big = [](double x) { return x >= 5; };
+    auto odd = [](double x) { return static_cast<int>(x) % 2 == 1; };
+
+    // masks from predicates, element access and spans
+    {
+        const Mask m = nb::make_mask(a, big);
+        const auto right = nb::make_mask(nb::TensorArray<double, Ext, nb::RightStride>(a), big);
+        size_t wrong = 0, count = 0;
+        for (size_t j = 0; j < a.extent(1); ++j) {
+            for (size_t i = 0; i < a.extent(0); ++i) {
+                wrong += m(i, j) != big(a(i, j));
+                wrong += right(i, j) != big(a(i, j));
+                wrong += m.to_span()(i, j) != big(a(i, j));
+                count += big(a(i, j));
+            }
+        }
+        if (wrong != 0) {
+            std::cerr << "Error in make_mask: " << wrong << " elements differ\n";
+            ++error_count;
+        }
+        if (m.count() != count || !m.any() || m.all() || m.none()) {
+            std::cerr << "Error in count: expected " << count << ", got " << m.count() << "\n";
+            ++error_count;
+        }
+        if (m != nb::make_mask(a * 1.0, big)) {
+            std::cerr << "Error in make_mask expression\n";
+            ++error_count;
+        }
+
+        Mask w(13, 11);
+        w(4, 3) = true;
+        w(12, 10) = true;
+        w.to_span()(0, 0) = true;
+        w(12, 10) = false;
+        if (!w(4, 3) || !w(0, 0) || w(12, 10) || w.count() != 2) {
+            std::cerr << "Error in element writes\n";
+            ++error_count;
+        }
+    }
+
+    // word-at-a-time logic keeps the bits past the end clear
+    {
+        const Mask b = nb::make_mask(a, big);
+        const Mask o = nb::make_mask(a, odd);
+        const Mask both = b & o, either = b | o, one = b ^ o, neither = ~(b | o);
+        size_t wrong = 0;
+        for (size_t j = 0; j < a.extent(1); ++j) {
+            for (size_t i = 0; i < a.extent(0); ++i) {
+                const bool x = big(a(i, j)), y = odd(a(i, j));
+                wrong += both(i, j) != (x && y);
+                wrong += either(i, j) != (x || y);
+                wrong += one(i, j) != (x != y);
+                wrong += neither(i, j) != !(x || y);
+            }
+        }
+        if (wrong != 0) {
+            std::cerr << "Error in mask logic: " << wrong << " elements differ\n";
+            ++error_count;
+        }
+        if (either.count() + neither.count() != 143) {
+            std::cerr << "Error in ~: bits past the end are set\n";
+            ++error_count;
+        }
+        Mask full(13, 11);
+        full.fill(true);
+        if (full.count() != 143 || !full.all() || (~full).any()) {
+            std::cerr << "Error in fill\n";
+            ++error_count;
+        }
+        Mask other(11, 13);
+        if (!throws([&] { other &= b; })) {
+            std::cerr << "Error in &=: expected std::invalid_argument for mismatched extents\n";
+            ++error_count;
+        }
+    }
+
+    // masked assignment, word at a time and by index
+    {
+        const Mask m = nb::make_mask(a, big);
+        Array expected(13, 11);
+        for (size_t j = 0; j < a.extent(1); ++j) {
+            for (size_t i = 0; i < a.extent(0); ++i) {
+                expected(i, j) = big(a(i, j)) ? 2 * a(i, j) + 1 : -1;
+            }
+        }
+        auto check = [&](const char* name, const auto& c) {
+            size_t wrong = 0;
+            for (size_t j = 0; j < a.extent(1); ++j) {
+                for (size_t i = 0; i < a.extent(0); ++i) {
+                    wrong += c(i, j) != expected(i, j);
+                }
+            }
+            if (wrong != 0) {
+                std::cerr << "Error in " << name << ": " << wrong << " elements differ\n";
+                ++error_count;
+            }
+        };
+        Array c(13, 11);
+        c.fill(-1);
+        nb::masked_assign(c, m, 2 * a + 1);
+        check("masked_assign", c);
+
+        c.fill(-1);
+        nb::masked_assign(policy, c, m, 2 * a + 1);
+        check("masked_assign parallel", c);
+
+        nb::TensorArray<double, Ext, nb::RightStride> r(13, 11);
+        r.fill(-1);
+        nb::masked_assign(r, m, 2 * a + 1);
+        check("masked_assign by index", r);
+
+        c.fill(-1);
+        nb::masked_assign(c, m, 3.0);
+        nb::masked_assign(policy, c, ~m, 4.0);
+        size_t wrong = 0;
+        for (size_t j = 0; j < a.extent(1); ++j) {
+            for (size_t i = 0; i < a.extent(0); ++i) {
+                wrong += c(i, j) != (big(a(i, j)) ? 3.0 : 4.0);
+            }
+        }
+        if (wrong != 0) {
+            std::cerr << "Error in masked_assign scalar: " << wrong << " elements differ\n";
+            ++error_count;
+        }
+    }
+
+    if (error_count == 0) {
+        std::cout << "All tests passed!" << std::endl;
+    } else {
+        std::cout << error_count << " tests failed." << std::endl;
+    }
+    return error_count;
+}
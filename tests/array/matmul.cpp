@@ -0,0 +1,157 @@
+#define MDSPAN_DEBUG
+#define MDSPAN_USE_BRACKET_OPERATOR 0
+
+#include <cmath>
+#include <complex>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+#include "mdspan/mdspan.hpp"
+#include "nabla/nabla.hpp"
+
+namespace nb = nabla;
+
+// small integers, so that every product is exact in any summation order
+template <typename TensorT>
+void fill_pattern(TensorT& t, int seed) {
+    for (auto it = t.begin(); it != t.end(); ++it, seed += 7) {
+        *it = static_cast<typename TensorT::value_type>(seed % 7 - 3);
+    }
+}
+
+template <typename CT, typename CT0, typename AT, typename BT, typename T>
+int check(const char* name, const CT& c, const CT0& c0, const AT& a, const BT& b, T alpha, T beta) {
+    for (size_t j = 0; j < c.extent(1); ++j) {
+        for (size_t i = 0; i < c.extent(0); ++i) {
+            T expected = 0;
+            for (size_t p = 0; p < a.extent(1); ++p) {
+                expected += static_cast<T>(a(i,p))*static_cast<T>(b(p,j));
+            }
+            expected = alpha*expected;
+            if (beta != T(0)) {
+                expected += beta*static_cast<T>(c0(i,j));
+            }
+            if (c(i,j) != expected) {
+                std::cerr << "Error in " << name << " at (" << i << "," << j << "): expected "
+                          << expected << ", got " << c(i,j) << "\n";
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
+
+int main() {
+    using Matrix = nb::TensorArray<float, nb::dims<2>>;
+    using RightMatrix = nb::TensorArray<float, nb::dims<2>, nb::RightStride>;
+    using Complex = std::complex<double>;
+
+    nb::ThreadPool pool(3);
+    const auto policy = nb::par.on(pool).with_serial_cutoff(0).with_grain_size(1);
+
+    int error_count = 0;
+
+    // extents that cross the register, kc and mc blocks with ragged edges
+    Matrix a(150, 300);
+    Matrix b(300, 37);
+    fill_pattern(a, 1);
+    fill_pattern(b, 2);
+
+    {
+        Matrix c(150, 37);
+        nb::matmul(c, a, b);
+        error_count += check("matmul", c, c, a, b, 1.0f, 0.0f);
+
+        Matrix c0(150, 37);
+        fill_pattern(c0, 3);
+        c = c0;
+        nb::matmul(c, a, b, 2.0f, -3.0f);
+        error_count += check("matmul alpha beta", c, c0, a, b, 2.0f, -3.0f);
+
+        c = c0;
+        nb::matmul(policy, c, a, b, 1.0f, 1.0f);
+        error_count += check("matmul parallel", c, c0, a, b, 1.0f, 1.0f);
+    }
+
+    // C is not read when beta is zero
+    {
+        Matrix c(150, 37);
+        c.fill(std::numeric_limits<float>::quiet_NaN());
+        nb::matmul(c, a, b);
+        error_count += check("matmul beta zero", c, c, a, b, 1.0f, 0.0f);
+    }
+
+    // strided operands: subspans, transposed views and row-major arrays
+    {
+        auto sa = nb::subspan(a, std::pair{5, 100}, std::pair{10, 270});
+        auto sb = nb::subspan(b, std::pair{20, 280}, nb::full_extent);
+        Matrix big(120, 50);
+        big.zero();
+        auto sc = nb::subspan(big, std::pair{10, 105}, std::pair{3, 40});
+        nb::matmul(sc, sa, sb);
+        error_count += check("matmul subspans", sc, sc, sa, sb, 1.0f, 0.0f);
+        if (big(9, 3) != 0 || big(10, 2) != 0 || big(105, 40) != 0) {
+            std::cerr << "Error in matmul subspans: wrote outside of C\n";
+            ++error_count;
+        }
+
+        Matrix at(300, 150);
+        at = nb::transpose(a);
+        RightMatrix br(300, 37);
+        br = b;
+        RightMatrix cr(150, 37);
+        nb::matmul(policy, cr, nb::transpose(at), br);
+        error_count += check("matmul transposed and row-major", cr, cr, a, b, 1.0f, 0.0f);
+    }
+
+    // complex, through a conjugating view
+    {
+        nb::TensorArray<Complex, nb::dims<2>> z(30, 20);
+        nb::TensorArray<Complex, nb::dims<2>> w(30, 25);
+        double n = 0;
+        for (auto it = z.begin(); it != z.end(); ++it, ++n) {
+            *it = Complex(std::fmod(n, 5) - 2, std::fmod(n, 3) - 1);
+        }
+        for (auto it = w.begin(); it != w.end(); ++it, ++n) {
+            *it = Complex(std::fmod(n, 4) - 1, std::fmod(n, 7) - 3);
+        }
+        nb::TensorArray<Complex, nb::dims<2>> h(20, 25);
+        nb::matmul(h, nb::conj_transpose(z), w, Complex(0, 1));
+        error_count += check("matmul complex", h, h, nb::conj_transpose(z), w, Complex(0, 1), Complex(0));
+    }
+
+    // empty inner extent scales C by beta
+    {
+        auto e0 = nb::subspan(a, std::pair{0, 4}, std::pair{0, 0});
+        auto e1 = nb::subspan(b, std::pair{0, 0}, std::pair{0, 3});
+        Matrix c(4, 3);
+        c.fill(2);
+        nb::matmul(c, e0, e1, 1.0f, 0.5f);
+        if (c(3, 2) != 1) {
+            std::cerr << "Error in matmul: empty product should scale C by beta\n";
+            ++error_count;
+        }
+    }
+
+    // mismatched extents
+    {
+        Matrix c(150, 36);
+        bool caught = false;
+        try {
+            nb::matmul(c, a, b);
+        } catch (const std::invalid_argument&) {
+            caught = true;
+        }
+        if (!caught) {
+            std::cerr << "Error in matmul: expected std::invalid_argument\n";
+            ++error_count;
+        }
+    }
+
+    if (error_count == 0) {
+        std::cout << "All tests passed!" << std::endl;
+    } else {
+        std::cout << error_count << " tests failed." << std::endl;
+    }
+    return error_count;
+}
@@ -0,0 +1,146 @@
+#define MDSPAN_DEBUG
+#define MDSPAN_USE_BRACKET_OPERATOR 0
+
+#include <atomic>
+#include <iostream>
+#include <stdexcept>
+#include <vector>
+#include "mdspan/mdspan.hpp"
+#include "nabla/nabla.hpp"
+
+namespace nb = nabla;
+
+template <typename TensorT>
+void iota(TensorT& t, float start = 0) {
+    for (auto it = t.begin(); it != t.end(); ++it) {
+        *it = start;
+        start += 1;
+    }
+}
+
+template <typename TensorA, typename TensorB>
+int compare(const char* name, const TensorA& a, const TensorB& b) {
+    auto it_b = b.begin();
+    for (auto it_a = a.begin(); it_a != a.end(); ++it_a, ++it_b) {
+        if (*it_a != *it_b) {
+            std::cerr << "Error in " << name << ": expected " << *it_b << ", got " << *it_a << "\n";
+            return 1;
+        }
+    }
+    return 0;
+}
+
+int main() {
+    using Layout = nb::LeftStride;
+    using Ext = nb::dims<3>;
+    using Map = Layout::mapping<Ext>;
+    using TensorArray = nb::TensorArray<float, Ext, Layout>;
+
+    nb::ThreadPool pool(3);
+    const auto policy = nb::par.on(pool).with_serial_cutoff(0).with_grain_size(7);
+
+    int error_count = 0;
+
+    TensorArray a(9, 8, 5);
+    TensorArray b(Map({9, 8, 5}, {2, 20, 200}));
+    iota(a);
+    iota(b, 1000);
+
+    // shared offsets, split inside the single contiguous line
+    {
+        TensorArray expected(9, 8, 5);
+        expected = a*2 + a;
+        TensorArray r(9, 8, 5);
+        nb::assign(policy, r, a*2 + a);
+        error_count += compare("contiguous", r, expected);
+    }
+
+    // per-leaf strides
+    {
+        TensorArray expected(9, 8, 5);
+        expected = a*b - b;
+        TensorArray r(9, 8, 5);
+        nb::assign(policy.with_grain_size(20), r, a*b - b);
+        error_count += compare("mixed strides", r, expected);
+    }
+
+    // strided subspan destination
+    {
+        TensorArray r1(Map({9, 8, 5}, {1, 12, 100}));
+        TensorArray r2(Map({9, 8, 5}, {1, 12, 100}));
+        r1.fill(-1);
+        r2.fill(-1);
+        auto s1 = nb::subspan(r1, std::pair{1, 8}, std::pair{2, 7}, std::pair{0, 5});
+        auto s2 = nb::subspan(r2, std::pair{1, 8}, std::pair{2, 7}, std::pair{0, 5});
+        auto sa = nb::subspan(a, std::pair{0, 7}, std::pair{0, 5}, std::pair{0, 5});
+        s1 = sa + 1;
+        nb::assign(policy, s2, sa + 1);
+        error_count += compare("subspan destination", r2.container(), r1.container());
+    }
+
+    // materialization
+    {
+        TensorArray expected(a*a);
+        TensorArray r(policy, a*a);
+        error_count += compare("materialization", r, expected);
+    }
+
+    // streaming stores, with lines and chunks that start and end inside
+    // cache lines
+    {
+        const auto streaming = policy.with_grain_size(100).with_streaming_threshold(1);
+        TensorArray big(Map({67, 31, 5}, {1, 70, 3000}));
+        TensorArray expected(Map({67, 31, 5}, {1, 70, 3000}));
+        big.fill(-1);
+        expected.fill(-1);
+        TensorArray c(67, 31, 5);
+        iota(c);
+        expected = c*3 + 1;
+        nb::assign(streaming, big, c*3 + 1);
+        error_count += compare("streaming strided", big.container(), expected.container());
+
+        TensorArray r(67, 31, 5);
+        nb::assign(streaming, r, c - 2);
+        TensorArray r_expected(67, 31, 5);
+        r_expected = c - 2;
+        error_count += compare("streaming contiguous", r, r_expected);
+
+        std::vector<float> line(200, -1.0f);
+        nb::detail::stream_line(line.data() + 3, 5, 150, [](std::ptrdiff_t i) { return static_cast<float>(i); });
+        for (size_t i = 0; i < line.size(); ++i) {
+            const float want = i >= 8 && i < 153 ? static_cast<float>(i - 3) : -1.0f;
+            if (line[i] != want) {
+                std::cerr << "Error in stream_line at " << i << ": expected " << want << ", got " << line[i] << "\n";
+                ++error_count;
+                break;
+            }
+        }
+    }
+
+    // exceptions thrown by a chunk reach the caller
+    {
+        std::atomic<int> calls{0};
+        bool caught = false;
+        try {
+            nb::parallel_for(policy, 100, 10, [&](size_t begin, size_t) {
+                ++calls;
+                if (begin == 50) {
+                    throw std::runtime_error("chunk failed");
+                }
+            });
+        } catch (const std::runtime_error&) {
+            caught = true;
+        }
+        if (!caught) {
+            std::cerr << "Error in parallel_for: exception was not propagated\n";
+            ++error_count;
+        }
+    }
+
+    if (error_count == 0) {
+        std::cout << "All tests passed!" << std::endl;
+    } else {
+        std::cout << error_count << " tests failed." << std::endl;
+    }
+    return error_count;
+}
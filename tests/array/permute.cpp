@@ -0,0 +1,162 @@
+#define MDSPAN_DEBUG
+#define MDSPAN_USE_BRACKET_OPERATOR 0
+
+#include <complex>
+#include <iostream>
+#include <stdexcept>
+#include "mdspan/mdspan.hpp"
+#include "nabla/nabla.hpp"
+
+namespace nb = nabla;
+
+template <typename TensorT>
+void iota(TensorT& t, float start = 0) {
+    for (auto it = t.begin(); it != t.end(); ++it) {
+        *it = start;
+        start += 1;
+    }
+}
+
+template <typename TensorT, typename F>
+    requires (TensorT::rank() == 2)
+int check(const char* name, const TensorT& t, F&& expected) {
+    for (size_t j = 0; j < t.extent(1); ++j) {
+        for (size_t i = 0; i < t.extent(0); ++i) {
+            if (t(i,j) != expected(i,j)) {
+                std::cerr << "Error in " << name << " at (" << i << "," << j << "): expected "
+                          << expected(i,j) << ", got " << t(i,j) << "\n";
+                return 1;
+            }
+        }
+    }
+    return 0;
+}
+
+template <typename TensorT, typename F>
+    requires (TensorT::rank() == 3)
+int check(const char* name, const TensorT& t, F&& expected) {
+    for (size_t k = 0; k < t.extent(2); ++k) {
+        for (size_t j = 0; j < t.extent(1); ++j) {
+            for (size_t i = 0; i < t.extent(0); ++i) {
+                if (t(i,j,k) != expected(i,j,k)) {
+                    std::cerr << "Error in " << name << " at (" << i << "," << j << "," << k << "): expected "
+                              << expected(i,j,k) << ", got " << t(i,j,k) << "\n";
+                    return 1;
+                }
+            }
+        }
+    }
+    return 0;
+}
+
+int main() {
+    using Matrix = nb::TensorArray<float, nb::dims<2>>;
+    using Tensor3 = nb::TensorArray<float, nb::dims<3>>;
+    using Complex = std::complex<double>;
+
+    nb::ThreadPool pool(3);
+    const auto policy = nb::par.on(pool).with_serial_cutoff(0).with_grain_size(100);
+
+    int error_count = 0;
+
+    // sizes that are not multiples of the tile edge
+    Matrix a(150, 71);
+    iota(a);
+
+    // views share data and swap extents and strides
+    {
+        auto t = nb::transpose(a);
+        if (t.extent(0) != 71 || t.extent(1) != 150 || t.stride(0) != 150 || t.stride(1) != 1 ||
+            t.data_handle() != a.data()) {
+            std::cerr << "Error in transpose: expected a view with swapped extents and strides\n";
+            ++error_count;
+        }
+        error_count += check("transpose view", t, [&](size_t i, size_t j) { return a(j,i); });
+        t(3, 5) = -1;
+        if (a(5, 3) != -1) {
+            std::cerr << "Error in transpose: write through view\n";
+            ++error_count;
+        }
+        a(5, 3) = 5 + 3*150;
+    }
+
+    // assigning a transposed view runs the blocked copy
+    {
+        Matrix r(71, 150);
+        r = nb::transpose(a);
+        error_count += check("transpose assign", r, [&](size_t i, size_t j) { return a(j,i); });
+        Matrix m(nb::transpose(a));
+        error_count += check("transpose materialization", m, [&](size_t i, size_t j) { return a(j,i); });
+        Matrix p(71, 150);
+        nb::assign(policy, p, nb::transpose(a));
+        error_count += check("transpose parallel", p, [&](size_t i, size_t j) { return a(j,i); });
+        nb::TensorArray<float, nb::dims<2>, nb::RightStride> rr(71, 150);
+        rr = nb::transpose(a);
+        error_count += check("transpose into RightStride", rr, [&](size_t i, size_t j) { return a(j,i); });
+        Matrix e(71, 150);
+        e = nb::transpose(a)*2 + r;
+        error_count += check("transpose expression", e, [&](size_t i, size_t j) { return a(j,i)*3; });
+        auto s = nb::subspan(nb::transpose(a), std::pair{10, 20}, std::pair{3, 140});
+        Matrix sr(10, 137);
+        sr = s;
+        error_count += check("transpose subspan", sr, [&](size_t i, size_t j) { return a(j+3,i+10); });
+    }
+
+    // general permutations
+    {
+        Tensor3 b(9, 70, 5);
+        iota(b);
+        auto v = nb::permute(b, {2, 0, 1});
+        if (v.extent(0) != 5 || v.extent(1) != 9 || v.extent(2) != 70 || v.stride(0) != 630) {
+            std::cerr << "Error in permute: wrong extents or strides\n";
+            ++error_count;
+        }
+        Tensor3 r(5, 9, 70);
+        r = v;
+        error_count += check("permute assign", r, [&](size_t i, size_t j, size_t k) { return b(j,k,i); });
+        Tensor3 p(5, 9, 70);
+        nb::assign(policy, p, v);
+        error_count += check("permute parallel", p, [&](size_t i, size_t j, size_t k) { return b(j,k,i); });
+        Tensor3 u(9, 70, 5);
+        u = nb::permute(r, {1, 2, 0});
+        error_count += check("permute round trip", u, [&](size_t i, size_t j, size_t k) { return b(i,j,k); });
+
+        bool caught = false;
+        try {
+            auto bad = nb::permute(b, {0, 2, 0});
+            (void)bad;
+        } catch (const std::invalid_argument&) {
+            caught = true;
+        }
+        if (!caught) {
+            std::cerr << "Error in permute: expected std::invalid_argument\n";
+            ++error_count;
+        }
+    }
+
+    // lazy conjugation
+    {
+        nb::TensorArray<Complex, nb::dims<2>> z(40, 90);
+        double n = 0;
+        for (auto it = z.begin(); it != z.end(); ++it, ++n) {
+            *it = Complex(n, -2*n);
+        }
+        auto c = nb::conj(z);
+        static_assert(std::is_same_v<decltype(nb::conj(c))::accessor_type, nb::default_accessor<const Complex>>);
+        error_count += check("conj view", c, [&](size_t i, size_t j) { return std::conj(z(i,j)); });
+        nb::TensorArray<Complex, nb::dims<2>> h(90, 40);
+        h = nb::conj_transpose(z);
+        error_count += check("conj_transpose", h, [&](size_t i, size_t j) { return std::conj(z(j,i)); });
+        h = nb::conj(nb::conj_transpose(z)) + nb::transpose(z);
+        error_count += check("conj round trip", h, [&](size_t i, size_t j) { return z(j,i)*2.0; });
+        auto r = nb::conj(a);
+        static_assert(std::is_same_v<decltype(r)::accessor_type, nb::default_accessor<const float>>);
+    }
+
+    if (error_count == 0) {
+        std::cout << "All tests passed!" << std::endl;
+    } else {
+        std::cout << error_count << " tests failed." << std::endl;
+    }
+    return error_count;
+}
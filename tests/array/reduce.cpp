@@ -0,0 +1,201 @@
+#define MDSPAN_DEBUG
+#define MDSPAN_USE_BRACKET_OPERATOR 0
+
+#include <cmath>
+#include <complex>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+#include "mdspan/mdspan.hpp"
+#include "nabla/nabla.hpp"
+
+namespace nb = nabla;
+
+template <typename TensorT>
+void iota(TensorT& t, double start = 0, double step = 1) {
+    for (auto it = t.begin(); it != t.end(); ++it) {
+        *it = start;
+        start += step;
+    }
+}
+
+template <typename T>
+int check(const char* name, const T& value, const T& expected) {
+    if (value != expected) {
+        std::cerr << "Error in " << name << ": expected " << expected << ", got " << value << "\n";
+        return 1;
+    }
+    return 0;
+}
+
+template <typename CoordT>
+int check_coord(const char* name, const CoordT& value, const CoordT& expected) {
+    if (value != expected) {
+        std::cerr << "Error in " << name << ": expected (" << expected[0] << "," << expected[1] << "," << expected[2]
+                  << "), got (" << value[0] << "," << value[1] << "," << value[2] << ")\n";
+        return 1;
+    }
+    return 0;
+}
+
+int main() {
+    using Layout = nb::LeftStride;
+    using Ext = nb::dims<3>;
+    using Map = Layout::mapping<Ext>;
+    using TensorArray = nb::TensorArray<double, Ext, Layout>;
+    using coord_type = TensorArray::coord_type;
+
+    nb::ThreadPool pool(3);
+    const auto policy = nb::par.on(pool).with_serial_cutoff(0).with_grain_size(13);
+
+    int error_count = 0;
+
+    // integer valued doubles keep every sum exact regardless of order
+    TensorArray a(9, 8, 5);
+    TensorArray b(Map({9, 8, 5}, {2, 20, 200}));
+    iota(a, 1);
+    iota(b, -100);
+    const double n = 360;
+
+    // sums over tensors and fused expressions
+    {
+        error_count += check("sum", nb::sum(a), n*(n+1)/2);
+        error_count += check("sum strided", nb::sum(b), n*(-100 + (-100 + n - 1))/2);
+        double expected = 0;
+        for (auto ia = a.begin(), ib = b.begin(); ia != a.end(); ++ia, ++ib) {
+            expected += *ia * *ib + 1;
+        }
+        error_count += check("sum expression", nb::sum(a*b + 1), expected);
+        error_count += check("sum parallel", nb::sum(policy, a*b + 1), expected);
+
+        // const arrays convert to const spans
+        const TensorArray& ca = a;
+        nb::TensorSpan<const double, Ext, Layout> cs = ca.to_span();
+        error_count += check("sum const span", nb::sum(cs), n*(n+1)/2);
+        error_count += check("sum const expression", nb::sum(ca*2), n*(n+1));
+    }
+
+    // min, max, argmin, argmax
+    {
+        TensorArray c(9, 8, 5);
+        iota(c, 1000, -1);
+        c(4, 3, 2) = 5000;
+        c(6, 3, 2) = 5000;
+        c(1, 7, 4) = -5000;
+        error_count += check("max", nb::max(c), 5000.0);
+        error_count += check("min", nb::min(c), -5000.0);
+        error_count += check("max expression", nb::max(c - a), 5000.0 - a(4, 3, 2));
+        error_count += check_coord("argmax", nb::argmax(c), coord_type{4, 3, 2});
+        error_count += check_coord("argmin", nb::argmin(c), coord_type{1, 7, 4});
+        error_count += check_coord("argmax parallel", nb::argmax(policy, c), coord_type{4, 3, 2});
+        error_count += check_coord("argmin parallel", nb::argmin(policy, c), coord_type{1, 7, 4});
+        error_count += check("min parallel", nb::min(policy, c), -5000.0);
+        error_count += check_coord("argmax ties", nb::argmax(policy.with_grain_size(1), a*0), coord_type{0, 0, 0});
+    }
+
+    // min and max of infinite elements
+    {
+        const double inf = std::numeric_limits<double>::infinity();
+        TensorArray c(9, 8, 5);
+        c.fill(inf);
+        error_count += check("min of +inf", nb::min(c), inf);
+        error_count += check("min of +inf parallel", nb::min(policy, c), inf);
+        c.fill(-inf);
+        error_count += check("max of -inf", nb::max(c), -inf);
+        error_count += check("max of -inf parallel", nb::max(policy, c), -inf);
+        nb::TensorArray<float, nb::dims<1>> f(nb::dims<1>(37));
+        f.fill(std::numeric_limits<float>::infinity());
+        if (nb::min(f) != std::numeric_limits<float>::infinity()) {
+            std::cerr << "Error in min of +inf float: got " << nb::min(f) << "\n";
+            ++error_count;
+        }
+    }
+
+    // dot and norms
+    {
+        double expected = 0;
+        for (auto ia = a.begin(), ib = b.begin(); ia != a.end(); ++ia, ++ib) {
+            expected += *ia * *ib;
+        }
+        error_count += check("dot", nb::dot(a, b), expected);
+        error_count += check("dot parallel", nb::dot(policy, a, b), expected);
+        error_count += check("norm2", nb::norm2(a), std::sqrt(n*(n+1)*(2*n+1)/6));
+        error_count += check("norm_inf", nb::norm_inf(b), 259.0);
+        error_count += check("norm_inf parallel", nb::norm_inf(policy, b), 259.0);
+
+        using Complex = std::complex<double>;
+        nb::TensorArray<Complex, Ext, Layout> z(2, 2, 1);
+        z(0, 0, 0) = {3, 4};
+        z(1, 0, 0) = {0, 1};
+        z(0, 1, 0) = {1, 0};
+        z(1, 1, 0) = {0, 0};
+        error_count += check("complex norm2", nb::norm2(z), std::sqrt(27.0));
+        error_count += check("complex norm_inf", nb::norm_inf(z), 5.0);
+        error_count += check("complex dot", nb::dot(z, z), Complex{-7 - 1 + 1, 24});
+    }
+
+    // allclose
+    {
+        TensorArray c(a);
+        error_count += check("allclose equal", nb::allclose(a, c), true);
+        c(8, 7, 4) += 1e-3;
+        error_count += check("allclose tolerance", nb::allclose(a, c), true);
+        c(0, 0, 0) += 1e-3;
+        error_count += check("allclose outside", nb::allclose(policy, a, c), false);
+        error_count += check("allclose rtol", nb::allclose(a, c, 1e-3), true);
+        c(0, 0, 0) = std::numeric_limits<double>::quiet_NaN();
+        error_count += check("allclose nan", nb::allclose(c, c), false);
+    }
+
+    // subspans and empty tensors
+    {
+        auto sa = nb::subspan(a, std::pair{1, 4}, std::pair{2, 5}, std::pair{0, 2});
+        double expected = 0;
+        for (auto it = sa.begin(); it != sa.end(); ++it) {
+            expected += *it;
+        }
+        error_count += check("sum subspan", nb::sum(sa), expected);
+        error_count += check("sum subspan parallel", nb::sum(policy, sa*1), expected);
+
+        TensorArray e(3, 2, 0);
+        error_count += check("sum empty", nb::sum(e), 0.0);
+        bool caught = false;
+        try {
+            nb::max(e);
+        } catch (const std::invalid_argument&) {
+            caught = true;
+        }
+        if (!caught) {
+            std::cerr << "Error in max empty: expected std::invalid_argument\n";
+            ++error_count;
+        }
+    }
+
+    // rows that skip cache lines prefetch ahead, up to past the end of the data
+    {
+        auto sa = nb::subspan(a, 4, nb::full_extent, nb::full_extent);
+        double expected = 0;
+        for (auto it = sa.begin(); it != sa.end(); ++it) {
+            expected += 2 * *it;
+        }
+        for (std::size_t d : {0, 1, 4, 1000}) {
+            error_count += check("sum prefetch", nb::sum(nb::seq.with_prefetch_distance(d), sa*2), expected);
+            error_count += check("sum prefetch parallel", nb::sum(policy.with_prefetch_distance(d), sa*2), expected);
+        }
+        TensorArray c(9, 8, 5);
+        c.zero();
+        auto sc = nb::subspan(c, 4, nb::full_extent, nb::full_extent);
+        nb::assign(nb::seq.with_prefetch_distance(3), sc, sa*2);
+        error_count += check("assign prefetch", nb::sum(c), expected);
+        c.zero();
+        nb::assign(policy.with_prefetch_distance(3), sc, sa*2);
+        error_count += check("assign prefetch parallel", nb::sum(c), expected);
+    }
+
+    if (error_count == 0) {
+        std::cout << "All tests passed!" << std::endl;
+    } else {
+        std::cout << error_count << " tests failed." << std::endl;
+    }
+    return error_count;
+}
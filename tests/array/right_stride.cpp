@@ -0,0 +1,151 @@
+#define MDSPAN_DEBUG
+#define MDSPAN_USE_BRACKET_OPERATOR 0
+
+#include <iostream>
+#include <iterator>
+#include <vector>
+#include "mdspan/mdspan.hpp"
+#include "nabla/nabla.hpp"
+
+namespace nb = nabla;
+
+template <typename TensorT>
+void iota(TensorT& t, float start = 0) {
+    for (auto it = t.begin(); it != t.end(); ++it) {
+        *it = start;
+        start += 1;
+    }
+}
+
+template <typename TensorT, typename F>
+    requires (TensorT::rank() == 3)
+int check(const char* name, const TensorT& t, F&& expected) {
+    for (size_t i = 0; i < t.extent(0); ++i) {
+        for (size_t j = 0; j < t.extent(1); ++j) {
+            for (size_t k = 0; k < t.extent(2); ++k) {
+                if (t(i,j,k) != expected(i,j,k)) {
+                    std::cerr << "Error in " << name << " at (" << i << "," << j << "," << k << "): expected "
+                              << expected(i,j,k) << ", got " << t(i,j,k) << "\n";
+                    return 1;
+                }
+            }
+        }
+    }
+    return 0;
+}
+
+int main() {
+    using Ext = nb::dims<3>;
+    using RightMap = nb::RightStride::mapping<Ext>;
+    using RightArray = nb::TensorArray<float, Ext, nb::RightStride>;
+    using LeftArray = nb::TensorArray<float, Ext, nb::LeftStride>;
+
+    int error_count = 0;
+
+    // default strides, and iteration with the last index fastest
+    {
+        RightMap map(Ext{3, 4, 5});
+        if (map.stride(0) != 20 || map.stride(1) != 5 || map.stride(2) != 1) {
+            std::cerr << "Error in RightStride default strides\n";
+            ++error_count;
+        }
+        static_assert(std::random_access_iterator<RightMap::iterator_type>);
+        size_t expected = 0;
+        for (auto it = map.begin(); it != map.end(); ++it, ++expected) {
+            if (*it != expected) {
+                std::cerr << "Error in RightIterator: " << *it << " != " << expected << "\n";
+                ++error_count;
+                break;
+            }
+        }
+        auto it = map.end();
+        for (std::ptrdiff_t n = 59; n >= 0; --n) {
+            --it;
+            if (*it != static_cast<size_t>(n) || *(map.begin() + n) != static_cast<size_t>(n)) {
+                std::cerr << "Error in RightIterator decrement at " << n << "\n";
+                ++error_count;
+                break;
+            }
+        }
+
+        RightMap padded(Ext{3, 4, 5}, {40, 8, 1});
+        auto result = submdspan_mapping(padded, nb::full_extent, std::pair{1, 3}, std::pair{2, 5});
+        auto sub = result.mapping;
+        static_assert(std::is_same_v<typename decltype(sub)::layout_type, nb::RightStride>);
+        std::vector<size_t> offsets(sub.begin(), sub.end());
+        if (result.offset != 8 + 2 || offsets.size() != 18 || offsets[1] != 1 || offsets[3] != 8 || offsets[6] != 40) {
+            std::cerr << "Error in RightStride submap iteration\n";
+            ++error_count;
+        }
+
+        bool caught = false;
+        try {
+            RightMap bad(Ext{3, 4, 5}, {20, 1, 5});
+        } catch (const std::out_of_range&) {
+            caught = true;
+        }
+        if (!caught) {
+            std::cerr << "Error in RightStride validation: expected std::out_of_range\n";
+            ++error_count;
+        }
+    }
+
+    RightArray a(3, 4, 5);
+    LeftArray b(3, 4, 5);
+    iota(a);
+    iota(b, 1000);
+
+    // row-major arrays fill in memory order
+    if (a.container()[7] != 7 || a(1, 0, 2) != 22) {
+        std::cerr << "Error in RightStride TensorArray layout\n";
+        ++error_count;
+    }
+
+    // expressions over one layout, and mixed layouts in both directions
+    {
+        RightArray r(3, 4, 5);
+        r = a*2 + a;
+        error_count += check("right expression", r, [&](size_t i, size_t j, size_t k) { return a(i,j,k)*3; });
+        r = a - b;
+        error_count += check("mixed into right", r, [&](size_t i, size_t j, size_t k) { return a(i,j,k) - b(i,j,k); });
+        LeftArray l(3, 4, 5);
+        l = b - a;
+        error_count += check("mixed into left", l, [&](size_t i, size_t j, size_t k) { return b(i,j,k) - a(i,j,k); });
+        RightArray c(a);
+        error_count += check("right copy", c, [&](size_t i, size_t j, size_t k) { return a(i,j,k); });
+        RightArray m(a + b);
+        error_count += check("mixed materialization", m, [&](size_t i, size_t j, size_t k) { return a(i,j,k) + b(i,j,k); });
+        r = b;
+        error_count += check("left into right", r, [&](size_t i, size_t j, size_t k) { return b(i,j,k); });
+    }
+
+    // subspans and reductions
+    {
+        auto sa = nb::subspan(a, std::pair{1, 3}, nb::full_extent, std::pair{1, 4});
+        auto sb = nb::subspan(b, std::pair{0, 2}, nb::full_extent, std::pair{2, 5});
+        RightArray r(2, 4, 3);
+        r = sa*sb;
+        error_count += check("subspans", r, [&](size_t i, size_t j, size_t k) { return a(i+1,j,k+1)*b(i,j,k+2); });
+
+        float expected = 0;
+        for (auto it = a.begin(); it != a.end(); ++it) {
+            expected += *it;
+        }
+        if (nb::sum(a) != expected || nb::sum(nb::par, a + 0) != expected) {
+            std::cerr << "Error in RightStride sum\n";
+            ++error_count;
+        }
+        a(2, 1, 3) = 1e6;
+        if (nb::argmax(a) != RightArray::coord_type{2, 1, 3}) {
+            std::cerr << "Error in RightStride argmax\n";
+            ++error_count;
+        }
+    }
+
+    if (error_count == 0) {
+        std::cout << "All tests passed!" << std::endl;
+    } else {
+        std::cout << error_count << " tests failed." << std::endl;
+    }
+    return error_count;
+}
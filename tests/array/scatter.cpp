@@ -0,0 +1,119 @@
+#define MDSPAN_DEBUG
+#define MDSPAN_USE_BRACKET_OPERATOR 0
+
+#include <cmath>
+#include <complex>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <vector>
+#include "mdspan/mdspan.hpp"
+#include "nabla/nabla.hpp"
+
+namespace nb = nabla;
+
+int main() {
+    using Ext = nb::dims<2>;
+    using Array = nb::TensorArray<double, Ext>;
+
+    nb::ThreadPool pool(3);
+    const auto policy = nb::par.on(pool);
+
+    int error_count = 0;
+
+    // particles with integer charges, so that every summation order is exact
+    const size_t num_particles = 400000;
+    std::vector<size_t> ix(num_particles), iy(num_particles);
+    std::vector<double> q(num_particles);
+    std::mt19937 rng(3);
+    for (size_t p = 0; p < num_particles; ++p) {
+        ix[p] = rng() % 64;
+        iy[p] = rng() % 48;
+        q[p] = static_cast<double>(rng() % 7) - 3.0;
+    }
+    auto deposit = [&](size_t p, auto& grid) {
+        nb::atomic_add(grid(ix[p], iy[p]), q[p]);
+    };
+    Array expected(64, 48);
+    expected.zero();
+    nb::scatter_add(expected, num_particles, deposit);
+
+    // atomic_accessor reads and writes the elements of plain memory
+    {
+        Array a(4, 3);
+        a.zero();
+        auto s = a.to_span(nb::atomic_accessor<double>{});
+        static_assert(std::is_same_v<decltype(s)::reference, std::atomic_ref<double>>);
+        static_assert(!nb::detail::IsPointerBacked<decltype(s)>);
+        nb::atomic_add(s(1, 2), 2.5);
+        s(3, 0) = 4.0;
+        s(3, 0).fetch_add(1.0, std::memory_order_relaxed);
+        auto cs = a.to_span(nb::atomic_accessor<const double>{});
+        Array r(4, 3);
+        r = cs*2.0;
+        if (a(1, 2) != 2.5 || a(3, 0) != 5.0 || cs(3, 0) != 5.0 || r(1, 2) != 5.0) {
+            std::cerr << "Error in atomic_accessor: access\n";
+            ++error_count;
+        }
+    }
+
+    // both strategies, forced and chosen, agree with the sequential sums
+    for (auto strategy : {nb::scatter_strategy::atomic, nb::scatter_strategy::privatize, nb::scatter_strategy::automatic}) {
+        Array a(64, 48);
+        a.fill(1.0);
+        nb::scatter_add(policy, a, num_particles, deposit, strategy);
+        size_t mismatches = 0;
+        for (size_t j = 0; j < 48; ++j) {
+            for (size_t i = 0; i < 64; ++i) {
+                mismatches += a(i, j) != expected(i, j) + 1.0;
+            }
+        }
+        if (mismatches != 0) {
+            std::cerr << "Error in scatter_add: strategy " << static_cast<int>(strategy) << ", " << mismatches << " mismatches\n";
+            ++error_count;
+        }
+    }
+
+    // right-strided subspans and element types without fetch_add
+    {
+        using cfloat = std::complex<float>;
+        nb::TensorArray<cfloat, Ext, nb::RightStride> z(80, 60);
+        z.zero();
+        auto s = nb::subspan(z, std::pair<size_t, size_t>{8, 72}, std::pair<size_t, size_t>{6, 54});
+        for (auto strategy : {nb::scatter_strategy::atomic, nb::scatter_strategy::privatize}) {
+            nb::scatter_add(policy, s, num_particles, [&](size_t p, auto& grid) {
+                nb::atomic_add(grid(ix[p], iy[p]), cfloat(static_cast<float>(q[p]), 1.0f));
+            }, strategy);
+        }
+        size_t mismatches = z(7, 6) != 0.0f || z(72, 6) != 0.0f;
+        for (size_t j = 0; j < 48; ++j) {
+            for (size_t i = 0; i < 64; ++i) {
+                mismatches += s(i, j).real() != static_cast<float>(2.0*expected(i, j));
+            }
+        }
+        const cfloat total = nb::sum(z);
+        if (mismatches != 0 || total != cfloat(static_cast<float>(2.0*nb::sum(expected)), 2.0f*num_particles)) {
+            std::cerr << "Error in scatter_add: complex subspan, " << mismatches << " mismatches\n";
+            ++error_count;
+        }
+    }
+
+    // many items on a few elements favor private copies, few items on a
+    // large tensor favor atomics
+    {
+        const size_t threads = nb::max_threads(policy);
+        const bool dense = nb::detail::prefer_privatize<double>(10000000, 16, threads);
+        const bool sparse = nb::detail::prefer_privatize<double>(100000, 100000000, threads);
+        if (!dense || sparse) {
+            std::cerr << "Error in scatter_add: strategy choice\n";
+            ++error_count;
+        }
+    }
+
+    if (error_count == 0) {
+        std::cout << "All tests passed!" << std::endl;
+    } else {
+        std::cout << error_count << " tests failed." << std::endl;
+    }
+    return error_count;
+}
@@ -0,0 +1,120 @@
+#define MDSPAN_DEBUG
+#define MDSPAN_USE_BRACKET_OPERATOR 0
+
+#include <iostream>
+#include <memory>
+#include <vector>
+#include "mdspan/mdspan.hpp"
+#include "nabla/nabla.hpp"
+
+namespace nb = nabla;
+
+// counts the elements its allocator_traits construct writes
+static std::size_t constructed = 0;
+
+template <typename T>
+struct counting_allocator : std::allocator<T> {
+    template <typename U>
+    struct rebind {
+        using other = counting_allocator<U>;
+    };
+
+    counting_allocator() = default;
+
+    template <typename U>
+    counting_allocator(const counting_allocator<U>&) noexcept {}
+
+    template <typename U, typename... Args>
+    void construct(U* p, Args&&... args) {
+        ++constructed;
+        ::new (static_cast<void*>(p)) U(std::forward<Args>(args)...);
+    }
+};
+
+template <typename TensorT>
+void iota(TensorT& t, double start = 0) {
+    for (auto it = t.begin(); it != t.end(); ++it) {
+        *it = start;
+        start += 1;
+    }
+}
+
+int main() {
+    using Ext = nb::dims<2>;
+    using Container = std::vector<double, nb::default_init_allocator<double, counting_allocator<double>>>;
+    using Array = nb::TensorArray<double, Ext, nb::LeftStride, Container>;
+
+    int error_count = 0;
+
+    static_assert(std::is_same_v<nb::TensorArray<float, Ext>::container_type, std::vector<float>>);
+    static_assert(nb::detail::data_alignment<nb::TensorArray<float, Ext, nb::LeftStride,
+                  nb::default_init_vector<float, nb::aligned_allocator<float>>>>() == 64);
+
+    Array a(20, 10);
+    iota(a);
+
+    // materialization writes each element once, by the assignment
+    {
+        constructed = 0;
+        Array e(a*2 + a);
+        Array s(a.to_span());
+        Array p(nb::par, a*a);
+        Array sub(nb::subspan(a, std::pair{2, 8}, nb::full_extent));
+        if (constructed != 0) {
+            std::cerr << "Error in uninitialized: " << constructed << " elements initialized before assignment\n";
+            ++error_count;
+        }
+        if (e(3, 4) != 3*a(3, 4) || s(5, 6) != a(5, 6) || p(7, 8) != a(7, 8)*a(7, 8) || sub(0, 1) != a(2, 1)) {
+            std::cerr << "Error in uninitialized: materialized values\n";
+            ++error_count;
+        }
+    }
+
+    // copies construct each element from the source
+    {
+        constructed = 0;
+        Array c(a);
+        if (constructed != a.size() || c(19, 9) != a(19, 9)) {
+            std::cerr << "Error in uninitialized: copy constructed " << constructed << " elements\n";
+            ++error_count;
+        }
+    }
+
+    // the non-initializing constructors, and containers moved into the array
+    {
+        constructed = 0;
+        Array u(4, 5);
+        Array m(a.mapping());
+        if (constructed != 0 || u.size() != 20 || m.extent(0) != 20) {
+            std::cerr << "Error in uninitialized: extent constructors initialized " << constructed << " elements\n";
+            ++error_count;
+        }
+        std::vector<float> v(12, 2.0f);
+        const float* p = v.data();
+        nb::TensorArray<float, Ext> t(std::move(v), 3, 4);
+        if (t.data() != p || t(2, 3) != 2.0f) {
+            std::cerr << "Error in uninitialized: std::vector not moved into the array\n";
+            ++error_count;
+        }
+    }
+
+    // workspace_allocator default-initializes, construction with a value is kept
+    {
+        nb::Workspace ws;
+        auto scope = ws.scope();
+        using Element = std::vector<double, nb::workspace_allocator<double>>;
+        Element v(8);
+        Element w(8, 1.0);
+        if (w[7] != 1.0 || v.size() != 8) {
+            std::cerr << "Error in uninitialized: workspace_allocator\n";
+            ++error_count;
+        }
+    }
+
+    if (error_count == 0) {
+        std::cout << "All tests passed!" << std::endl;
+    } else {
+        std::cout << error_count << " tests failed." << std::endl;
+    }
+    return error_count;
+}
@@ -0,0 +1,174 @@
+#define MDSPAN_DEBUG
+#define MDSPAN_USE_BRACKET_OPERATOR 0
+
+#include <cstdlib>
+#include <iostream>
+#include <memory_resource>
+#include <new>
+#include "mdspan/mdspan.hpp"
+#include "nabla/nabla.hpp"
+
+namespace nb = nabla;
+
+// counts every heap allocation of the program
+static std::size_t heap_allocations = 0;
+
+void* operator new(std::size_t bytes) {
+    ++heap_allocations;
+    if (void* p = std::malloc(bytes ? bytes : 1)) {
+        return p;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept {
+    std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+    std::free(p);
+}
+
+// upstream resource that counts its allocations
+struct counting_resource : std::pmr::memory_resource {
+    std::size_t allocations = 0;
+
+    void* do_allocate(std::size_t bytes, std::size_t alignment) override {
+        ++allocations;
+        return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+    }
+
+    void do_deallocate(void* p, std::size_t bytes, std::size_t alignment) override {
+        std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+    }
+
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+};
+
+template <typename TensorT>
+void iota(TensorT& t, double start = 0) {
+    for (auto it = t.begin(); it != t.end(); ++it) {
+        *it = start;
+        start += 1;
+    }
+}
+
+int main() {
+    using Ext = nb::dims<2>;
+    using Array = nb::pmr::TensorArray<double, Ext>;
+
+    int error_count = 0;
+
+    Array a(40, 30);
+    Array b(40, 30);
+    Array u(40, 30);
+    iota(a);
+    iota(b, 7);
+    u.zero();
+
+    // temporaries of a time step come from the workspace slab
+    nb::Workspace ws;
+    std::size_t steady_allocations = 0;
+    for (int step = 0; step < 6; ++step) {
+        const std::size_t before = heap_allocations;
+        {
+            auto scope = ws.scope();
+            Array flux(a*b + u);
+            Array grad(flux - a);
+            Array copy(grad);
+            if (flux.container().get_allocator().resource() != &ws ||
+                copy.container().get_allocator().resource() != &ws) {
+                std::cerr << "Error in workspace: temporaries are not in the workspace\n";
+                ++error_count;
+            }
+            {
+                auto inner = ws.scope();
+                Array scratch(grad*2);
+                grad = scratch - grad;
+            }
+            u = u + grad*0.5;
+        }
+        if (step >= 2) {
+            steady_allocations += heap_allocations - before;
+        }
+    }
+    if (steady_allocations != 0) {
+        std::cerr << "Error in workspace: " << steady_allocations << " heap allocations in steady state\n";
+        ++error_count;
+    }
+    if (ws.in_use() != 0 || ws.capacity() < 3*40*30*sizeof(double)) {
+        std::cerr << "Error in workspace: in_use " << ws.in_use() << ", capacity " << ws.capacity() << "\n";
+        ++error_count;
+    }
+    size_t mismatches = 0;
+    for (size_t j = 0; j < 30; ++j) {
+        for (size_t i = 0; i < 40; ++i) {
+            double expected = 0;
+            for (int step = 0; step < 6; ++step) {
+                expected = expected + (a(i,j)*b(i,j) + expected - a(i,j))*0.5;
+            }
+            mismatches += u(i,j) != expected;
+        }
+    }
+    if (mismatches != 0) {
+        std::cerr << "Error in workspace: " << mismatches << " wrong results\n";
+        ++error_count;
+    }
+
+    // ending a scope or the workspace does not allocate, the slab grows on
+    // the next allocation
+    {
+        counting_resource upstream;
+        {
+            nb::Workspace small(64, &upstream);
+            {
+                auto scope = small.scope();
+                Array c(a + b);
+            }
+            const std::size_t after_scope = upstream.allocations;
+            {
+                auto scope = small.scope();
+                Array c(a + b);
+            }
+            if (after_scope != 2 || upstream.allocations != 3 || small.capacity() < 40*30*sizeof(double)) {
+                std::cerr << "Error in workspace: " << after_scope << " and " << upstream.allocations
+                          << " upstream allocations, expected 2 and 3\n";
+                ++error_count;
+            }
+            {
+                auto scope = small.scope();
+                Array c(a + b), d(a - b);
+            }
+        }
+        if (upstream.allocations != 4) {
+            std::cerr << "Error in workspace: " << upstream.allocations << " upstream allocations on destruction, expected 4\n";
+            ++error_count;
+        }
+    }
+
+    // outside of a scope arrays use the default resource, and std::pmr
+    // containers work with an explicit resource
+    {
+        Array c(a + b);
+        if (c.container().get_allocator().resource() != std::pmr::get_default_resource()) {
+            std::cerr << "Error in workspace: expected the default resource outside of a scope\n";
+            ++error_count;
+        }
+        std::pmr::monotonic_buffer_resource arena;
+        nb::TensorArray<double, Ext, nb::LeftStride, std::pmr::vector<double>> p(std::pmr::vector<double>(40*30, &arena), 40, 30);
+        p = a*2;
+        if (p(3, 4) != 2*a(3, 4) || p.container().get_allocator().resource() != &arena) {
+            std::cerr << "Error in workspace: std::pmr container\n";
+            ++error_count;
+        }
+    }
+
+    if (error_count == 0) {
+        std::cout << "All tests passed!" << std::endl;
+    } else {
+        std::cout << error_count << " tests failed." << std::endl;
+    }
+    return error_count;
+}
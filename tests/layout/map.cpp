@@ -97,6 +97,44 @@ int iterator_test(const MapT& map) {
     return 0;
 }
 
+template <typename MapT>
+int random_access_test(const MapT& map) {
+    using iterator = typename MapT::iterator_type;
+    static_assert(std::random_access_iterator<iterator>);
+
+    std::vector<size_t> expected;
+    for (auto it = map.begin(); it != map.end(); ++it) {
+        expected.push_back(*it);
+    }
+    std::ptrdiff_t size = expected.size();
+    if (map.end() - map.begin() != size) {
+        std::cerr << "Error in iterator distance: " << (map.end() - map.begin()) << " != " << size << std::endl;
+        return 1;
+    }
+    for (std::ptrdiff_t n = 0; n < size; ++n) {
+        iterator jumped(&map, n);
+        if (*jumped != expected[n] || map.begin()[n] != expected[n] || *(map.begin() + n) != expected[n]) {
+            std::cerr << "Error in iterator jump to " << n << ": " << *jumped << " != " << expected[n] << std::endl;
+            return 1;
+        }
+        auto it = jumped;
+        ++it;
+        if (it != jumped + 1 || it - jumped != 1) {
+            std::cerr << "Error in iterator increment after jump to " << n << std::endl;
+            return 1;
+        }
+    }
+    auto it = map.end();
+    for (std::ptrdiff_t n = size - 1; n >= 0; --n) {
+        --it;
+        if (*it != expected[n] || it != map.end() - (size - n)) {
+            std::cerr << "Error in iterator decrement at " << n << ": " << *it << " != " << expected[n] << std::endl;
+            return 1;
+        }
+    }
+    return 0;
+}
+
 template <size_t Rank>
 using Ext = nb::dextents<size_t, Rank>;
 
@@ -124,6 +162,7 @@ int main() {
         Mapping<3> map(Ext<3>{3, 4, 5}, Arr<3>{1, 10, 100});
         error_count += access_test(map);
         error_count += iterator_test(map);
+        error_count += random_access_test(map);
 
         //map = map.submap({2, 2, 2}, {1, 1, 1});
         //error_count += access_test(map);
@@ -56,6 +56,10 @@ class shared_ptr_accessor<const T> {
             return p.get()[i];
         }
 
+        constexpr element_type* raw_pointer(const data_handle_type& p) const noexcept {
+            return p.get();
+        }
+
         constexpr data_handle_type offset(data_handle_type p, size_t i) const noexcept {
             return data_handle_type(p, p.get() + i); // aliasing constructor
         }
@@ -81,6 +85,10 @@ class shared_ptr_accessor : public shared_ptr_accessor<const T> {
             return p.get()[i];
         }
 
+        constexpr element_type* raw_pointer(const data_handle_type& p) const noexcept {
+            return p.get();
+        }
+
         constexpr data_handle_type offset(data_handle_type p, size_t i) const noexcept {
             return data_handle_type(p, p.get() + i); // aliasing constructor
         }
@@ -68,7 +68,7 @@ int main() {
 
     std::cout << "a b c" << "\n";
     nb::utility::for_each_in_tuple(inputs, [](const auto& t) {
-        std::cout << *t << "\n";
+        std::cout << t << "\n";
     });
 
     std::cout << c << "\n";
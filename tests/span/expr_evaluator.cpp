@@ -0,0 +1,136 @@
+#define MDSPAN_DEBUG
+#define MDSPAN_USE_BRACKET_OPERATOR 0
+
+#include <memory>
+#include <vector>
+#include <iostream>
+#include "mdspan/mdspan.hpp"
+#include "nabla/nabla.hpp"
+#include "accessors.hpp"
+
+namespace nb = nabla;
+
+template <typename TensorT>
+void iota(TensorT& t, float start = 0) {
+    for (auto it = t.begin(); it != t.end(); ++it) {
+        *it = start;
+        start += 1;
+    }
+}
+
+template <typename TensorT, typename F>
+    requires (TensorT::rank() == 3)
+int check(const char* name, const TensorT& t, F&& expected) {
+    for (size_t k = 0; k < t.extent(2); ++k) {
+        for (size_t j = 0; j < t.extent(1); ++j) {
+            for (size_t i = 0; i < t.extent(0); ++i) {
+                if (t(i,j,k) != expected(i,j,k)) {
+                    std::cerr << "Error in " << name << " at (" << i << "," << j << "," << k << "): expected "
+                              << expected(i,j,k) << ", got " << t(i,j,k) << "\n";
+                    return 1;
+                }
+            }
+        }
+    }
+    return 0;
+}
+
+int main() {
+    using Layout = nb::LeftStride;
+    using Ext = nb::dims<3>;
+    using Map = Layout::mapping<Ext>;
+    using TensorArray = nb::TensorArray<float, Ext, Layout>;
+
+    int error_count = 0;
+
+    TensorArray a(5, 4, 3);
+    TensorArray b(5, 4, 3);
+    TensorArray c(Map({5, 4, 3}, {2, 12, 50}));
+    iota(a);
+    iota(b, 100);
+    iota(c, -50);
+
+    // shared offsets: every leaf has the destination's strides
+    {
+        TensorArray r(5, 4, 3);
+        r = a*2 + b - a*b;
+        error_count += check("shared offsets", r, [&](size_t i, size_t j, size_t k) {
+            return a(i,j,k)*2 + b(i,j,k) - a(i,j,k)*b(i,j,k);
+        });
+    }
+
+    // per-leaf strides, unit stride destination
+    {
+        TensorArray r(5, 4, 3);
+        r = a + c*3;
+        error_count += check("mixed strides", r, [&](size_t i, size_t j, size_t k) {
+            return a(i,j,k) + c(i,j,k)*3;
+        });
+    }
+
+    // strided destination
+    {
+        TensorArray r(Map({5, 4, 3}, {2, 12, 50}));
+        r = a*b;
+        error_count += check("strided destination", r, [&](size_t i, size_t j, size_t k) {
+            return a(i,j,k)*b(i,j,k);
+        });
+    }
+
+    // subspans of different shapes in the same expression
+    {
+        auto sa = nb::subspan(a, std::pair{1, 4}, std::pair{0, 4}, std::pair{1, 3});
+        auto sc = nb::subspan(c, std::pair{2, 5}, std::pair{0, 4}, std::pair{0, 2});
+        TensorArray r(3, 4, 2);
+        r = sa - sc;
+        error_count += check("subspans", r, [&](size_t i, size_t j, size_t k) {
+            return a(i+1,j,k+1) - c(i+2,j,k);
+        });
+        auto sr = nb::subspan(c, std::pair{0, 3}, std::pair{0, 4}, std::pair{1, 3});
+        sr = r + 1;
+        error_count += check("subspan destination", sr, [&](size_t i, size_t j, size_t k) {
+            return r(i,j,k) + 1;
+        });
+    }
+
+    // leaves read through a non-pointer accessor
+    {
+        using ReadOnlySpan = nb::TensorSpan<const float, Ext, Layout, read_only_accessor<const float>>;
+        static_assert(!nb::detail::IsPointerBacked<ReadOnlySpan>);
+        ReadOnlySpan s(b.data(), 5, 4, 3);
+        TensorArray r(5, 4, 3);
+        r = s*a + s;
+        error_count += check("accessor leaves", r, [&](size_t i, size_t j, size_t k) {
+            return b(i,j,k)*a(i,j,k) + b(i,j,k);
+        });
+    }
+
+    // owning handles resolve to a raw pointer, as leaves and destinations
+    {
+        using SharedSpan = nb::TensorSpan<float, Ext, Layout, shared_ptr_accessor<float>>;
+        static_assert(nb::detail::IsPointerBacked<SharedSpan>);
+        auto data = std::shared_ptr<float[]>(new float[60], std::default_delete<float[]>());
+        SharedSpan s(data, 5, 4, 3);
+        iota(s, 7);
+        TensorArray r(5, 4, 3);
+        r = s*a + s;
+        error_count += check("raw pointer leaves", r, [&](size_t i, size_t j, size_t k) {
+            return s(i,j,k)*a(i,j,k) + s(i,j,k);
+        });
+        s = a*2;
+        error_count += check("raw pointer destination", s, [&](size_t i, size_t j, size_t k) {
+            return a(i,j,k)*2;
+        });
+        if (data.use_count() != 2) {
+            std::cerr << "Error in raw pointer leaves: " << data.use_count() << " owners\n";
+            ++error_count;
+        }
+    }
+
+    if (error_count == 0) {
+        std::cout << "All tests passed!" << std::endl;
+    } else {
+        std::cout << error_count << " tests failed." << std::endl;
+    }
+    return error_count;
+}
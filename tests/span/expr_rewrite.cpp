@@ -0,0 +1,186 @@
+#define MDSPAN_DEBUG
+#define MDSPAN_USE_BRACKET_OPERATOR 0
+
+#include <cmath>
+#include <complex>
+#include <iostream>
+#include <limits>
+#include <vector>
+#include "mdspan/mdspan.hpp"
+#include "nabla/nabla.hpp"
+
+namespace nb = nabla;
+
+template <typename T, typename Op>
+constexpr bool is_node_of = std::is_same_v<typename T::operation_type, Op>;
+
+int main() {
+    using Ext = nb::dims<2>;
+    using Span = nb::TensorSpan<double, Ext>;
+    using ISpan = nb::TensorSpan<int, Ext>;
+    constexpr bool fma = nb::detail::contracts_fma<double>;
+    constexpr bool folds = nb::detail::folds_products<double>;
+    static_assert(folds == nb::detail::folds_sums<double>);
+
+    int error_count = 0;
+
+    std::vector<double> da(6*5), db(6*5), dc(6*5);
+    Span a(da.data(), Ext(6, 5));
+    Span b(db.data(), Ext(6, 5));
+    Span c(dc.data(), Ext(6, 5));
+    for (size_t j = 0; j < 5; ++j) {
+        for (size_t i = 0; i < 6; ++i) {
+            a(i, j) = 0.1*(i + 1) + j;
+            b(i, j) = 1.0/(i + j + 1);
+            c(i, j) = 3.0 - 0.7*i*j;
+        }
+    }
+
+    auto check = [&](const char* name, const auto& expr, auto reference) {
+        nb::TensorArray<double, Ext> r(expr);
+        for (size_t j = 0; j < 5; ++j) {
+            for (size_t i = 0; i < 6; ++i) {
+                const double expected = reference(i, j);
+                if (std::abs(r(i, j) - expected) > 1e-12*(1 + std::abs(expected))) {
+                    std::cerr << "Error in " << name << ": expected " << expected << ", got " << r(i, j) << "\n";
+                    ++error_count;
+                    return;
+                }
+            }
+        }
+    };
+
+    // products feeding sums and differences are contracted
+    {
+        auto e1 = a*b + c;
+        auto e2 = c + a*b;
+        auto e3 = a*b - c;
+        auto e4 = c - a*b;
+        auto e5 = a*2.0 + c;
+        auto e6 = c - a*2.0;
+        auto e7 = a*b + 1.0;
+        auto e8 = a*2.0 - 1.0;
+        static_assert(is_node_of<decltype(e1), nb::detail::fused_multiply_add> == fma);
+        static_assert(is_node_of<decltype(e2), nb::detail::fused_multiply_add> == fma);
+        static_assert(is_node_of<decltype(e3), nb::detail::fused_multiply_subtract> == fma);
+        static_assert(is_node_of<decltype(e4), nb::detail::fused_negate_multiply_add> == fma);
+        static_assert(is_node_of<decltype(e5), nb::detail::scalar_fused_multiply_add<double>> == fma);
+        static_assert(is_node_of<decltype(e6), nb::detail::scalar_fused_multiply_add<double>> == fma);
+        static_assert(is_node_of<decltype(e7), nb::detail::fused_multiply_add_scalar<double>> == fma);
+        static_assert(is_node_of<decltype(e8), nb::detail::scalar_multiply_add<double>> == fma);
+        check("a*b + c", e1, [&](size_t i, size_t j) { return a(i, j)*b(i, j) + c(i, j); });
+        check("c + a*b", e2, [&](size_t i, size_t j) { return c(i, j) + a(i, j)*b(i, j); });
+        check("a*b - c", e3, [&](size_t i, size_t j) { return a(i, j)*b(i, j) - c(i, j); });
+        check("c - a*b", e4, [&](size_t i, size_t j) { return c(i, j) - a(i, j)*b(i, j); });
+        check("a*2 + c", e5, [&](size_t i, size_t j) { return a(i, j)*2 + c(i, j); });
+        check("c - a*2", e6, [&](size_t i, size_t j) { return c(i, j) - a(i, j)*2; });
+        check("a*b + 1", e7, [&](size_t i, size_t j) { return a(i, j)*b(i, j) + 1; });
+        check("a*2 - 1", e8, [&](size_t i, size_t j) { return a(i, j)*2 - 1; });
+    }
+
+    // scalar chains fold into one operation
+    {
+        auto e1 = (a*2.0)*3.0;
+        auto e2 = 4.0*(a*0.5);
+        auto e3 = ((a + 1.0) - 3.0) + 0.5;
+        auto e4 = 10.0 - (a + 4.0);
+        auto e5 = (a/2.0)/4.0;
+        static_assert(std::is_same_v<decltype(e1), decltype(a*6.0)> == folds);
+        static_assert(std::is_same_v<decltype(e3), decltype(a + 1.0)> == folds);
+        static_assert(std::is_same_v<decltype(e5), decltype(a/8.0)> == folds);
+        if (folds && (e1.operation().value != 6.0 || e2.operation().value != 2.0 || e3.operation().value != -1.5 ||
+            e4.operation().value != 6.0 || e5.operation().value != 8.0)) {
+            std::cerr << "Error in scalar folding: folded constants\n";
+            ++error_count;
+        }
+        check("4*(a*0.5)", e2, [&](size_t i, size_t j) { return a(i, j)*2; });
+        check("((a + 1) - 3) + 0.5", e3, [&](size_t i, size_t j) { return a(i, j) - 1.5; });
+        check("(a*2)*3", e1, [&](size_t i, size_t j) { return a(i, j)*6; });
+        check("10 - (a + 4)", e4, [&](size_t i, size_t j) { return 6 - a(i, j); });
+        check("(a/2)/4", e5, [&](size_t i, size_t j) { return a(i, j)/8; });
+    }
+
+    // without NABLA_FAST_FP floating point constants are applied one by one,
+    // and overflow as written
+    {
+        auto e = (a*1e300)*1e300*1e-300;
+        nb::TensorArray<double, Ext> r(e);
+        if (!folds && r(1, 1) != std::numeric_limits<double>::infinity()) {
+            std::cerr << "Error in scalar folding: (a*1e300)*1e300*1e-300 gave " << r(1, 1) << "\n";
+            ++error_count;
+        }
+    }
+
+    // negations cancel or are absorbed
+    {
+        auto e1 = -(-(a + b));
+        auto e2 = -(-a);
+        auto e3 = a + (-b);
+        auto e4 = (-a) + b;
+        auto e5 = a - (-b);
+        auto e6 = 2.0 - (-a);
+        auto e7 = (-a)*3.0;
+        auto e8 = -(a*3.0);
+        static_assert(std::is_same_v<decltype(e1), decltype(a + b)>);
+        static_assert(is_node_of<decltype(e2), nb::detail::identity_op>);
+        static_assert(is_node_of<decltype(e3), std::minus<>> && is_node_of<decltype(e4), std::minus<>>);
+        static_assert(is_node_of<decltype(e5), std::plus<>>);
+        static_assert(std::is_same_v<decltype(e6), decltype(a + 2.0)>);
+        static_assert(std::is_same_v<decltype(e7), decltype(a*3.0)> && std::is_same_v<decltype(e8), decltype(a*3.0)>);
+        if (e7.operation().value != -3.0 || e8.operation().value != -3.0) {
+            std::cerr << "Error in negation: absorbed factor\n";
+            ++error_count;
+        }
+        check("-(-(a + b))", e1, [&](size_t i, size_t j) { return a(i, j) + b(i, j); });
+        check("-(-a)", e2, [&](size_t i, size_t j) { return a(i, j); });
+        check("a + (-b)", e3, [&](size_t i, size_t j) { return a(i, j) - b(i, j); });
+        check("(-a) + b", e4, [&](size_t i, size_t j) { return b(i, j) - a(i, j); });
+        check("a - (-b)", e5, [&](size_t i, size_t j) { return a(i, j) + b(i, j); });
+        check("2 - (-a)", e6, [&](size_t i, size_t j) { return 2 + a(i, j); });
+    }
+
+    // integers are folded but never contracted
+    {
+        std::vector<int> di(6*5);
+        ISpan n(di.data(), Ext(6, 5));
+        for (size_t k = 0; k < di.size(); ++k) {
+            di[k] = static_cast<int>(k) - 7;
+        }
+        auto e = (n*n + n)*2*3;
+        static_assert(is_node_of<decltype(e), nb::detail::scalar_multiplies<int>>);
+        nb::TensorArray<int, Ext> r(e);
+        if (e.operation().value != 6 || r(3, 4) != (n(3, 4)*n(3, 4) + n(3, 4))*6) {
+            std::cerr << "Error in integer rewrites\n";
+            ++error_count;
+        }
+        // sums of signed integers are not folded, x + (v + s) could overflow
+        auto f = (n + std::numeric_limits<int>::max()) + 1;
+        static_assert(!std::is_same_v<decltype(f), decltype(n + 1)>);
+        if (f(0, 0) != std::numeric_limits<int>::max() - 6) {
+            std::cerr << "Error in integer sums: got " << f(0, 0) << "\n";
+            ++error_count;
+        }
+    }
+
+    // scalars on the left of a non-arithmetic type keep their side
+    {
+        using cdouble = std::complex<double>;
+        std::vector<cdouble> dz(6*5, cdouble(1, 2));
+        nb::TensorSpan<cdouble, Ext> z(dz.data(), Ext(6, 5));
+        auto e1 = cdouble(3, 0)*z;
+        auto e2 = cdouble(0, 1) + z;
+        static_assert(is_node_of<decltype(e1), nb::detail::scalar_multiplies_left<cdouble>>);
+        static_assert(is_node_of<decltype(e2), nb::detail::scalar_plus_left<cdouble>>);
+        if (e1(2, 3) != cdouble(3, 6) || e2(2, 3) != cdouble(1, 3)) {
+            std::cerr << "Error in left scalars\n";
+            ++error_count;
+        }
+    }
+
+    if (error_count == 0) {
+        std::cout << "All tests passed!" << std::endl;
+    } else {
+        std::cout << error_count << " tests failed." << std::endl;
+    }
+    return error_count;
+}
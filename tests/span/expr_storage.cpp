@@ -0,0 +1,116 @@
+#define MDSPAN_DEBUG
+#define MDSPAN_USE_BRACKET_OPERATOR 0
+
+#include <complex>
+#include <iostream>
+#include <vector>
+#include "mdspan/mdspan.hpp"
+#include "nabla/nabla.hpp"
+
+namespace nb = nabla;
+
+template <typename TensorT>
+void iota(TensorT& t, float start = 0) {
+    for (auto it = t.begin(); it != t.end(); ++it) {
+        *it = start;
+        start += 1;
+    }
+}
+
+int main() {
+    using Ext = nb::dims<3>;
+    using Span = nb::TensorSpan<float, Ext>;
+    using RightSpan = nb::TensorSpan<float, Ext, nb::RightStride>;
+
+    int error_count = 0;
+
+    std::vector<float> da(4*3*2), db(4*3*2), dc(4*3*2);
+    Span a(da.data(), Ext(4, 3, 2));
+    Span b(db.data(), Ext(4, 3, 2));
+    Span c(dc.data(), Ext(4, 3, 2));
+    iota(a);
+    iota(b, 100);
+    iota(c, -50);
+
+    // the extents are stored once, leaves keep a data handle and strides
+    {
+        auto e = (a*b + c)*a - b;
+        using Leaf = nb::detail::ExprLeaf<Span>;
+        static_assert(sizeof(Leaf) == sizeof(float*) + sizeof(Span::coord_type));
+        static_assert(sizeof(e) <= sizeof(Ext) + 5*sizeof(Leaf));
+        static_assert(sizeof(e.begin()) == sizeof(void*) + sizeof(Span::coord_type) + sizeof(std::ptrdiff_t));
+        if (e.extents() != a.extents() || e(3, 2, 1) != (a(3, 2, 1)*b(3, 2, 1) + c(3, 2, 1))*a(3, 2, 1) - b(3, 2, 1)) {
+            std::cerr << "Error in expr storage: element access\n";
+            ++error_count;
+        }
+    }
+
+    // operands and leaves are rebuilt with the shared extents
+    {
+        auto e = (a + b)*c;
+        auto [lhs, rhs] = e.operands();
+        auto [x, y, z] = e.inputs();
+        if (lhs.extents() != a.extents() || lhs(1, 2, 0) != a(1, 2, 0) + b(1, 2, 0) || rhs(1, 2, 0) != c(1, 2, 0) ||
+            x.data_handle() != a.data_handle() || z.data_handle() != c.data_handle() || y.stride(2) != b.stride(2)) {
+            std::cerr << "Error in expr storage: operands\n";
+            ++error_count;
+        }
+    }
+
+    // iterators visit left-major, or right-major for RightStride leaves
+    {
+        std::vector<float> dr(4*3*2);
+        RightSpan r(dr.data(), Ext(4, 3, 2));
+        iota(r);
+        size_t mismatches = 0;
+        auto e = a + a;
+        auto it = e.begin();
+        for (size_t k = 0; k < 2; ++k) {
+            for (size_t j = 0; j < 3; ++j) {
+                for (size_t i = 0; i < 4; ++i, ++it) {
+                    mismatches += *it != 2*a(i, j, k);
+                }
+            }
+        }
+        mismatches += it != e.end();
+        auto f = r*3;
+        auto jt = f.begin();
+        for (size_t i = 0; i < 4; ++i) {
+            for (size_t j = 0; j < 3; ++j) {
+                for (size_t k = 0; k < 2; ++k, ++jt) {
+                    mismatches += *jt != 3*r(i, j, k);
+                }
+            }
+        }
+        mismatches += jt != f.end();
+        if (mismatches != 0) {
+            std::cerr << "Error in expr storage: " << mismatches << " iterator mismatches\n";
+            ++error_count;
+        }
+    }
+
+    // broadcast leaves and accessor leaves
+    {
+        std::vector<float> dv(3);
+        Span v(dv.data(), Ext(1, 3, 1));
+        iota(v, 10);
+        nb::TensorArray<float, Ext> r(a + v);
+        using cfloat = std::complex<float>;
+        nb::TensorArray<cfloat, Ext> z(4, 3, 2);
+        for (auto it = z.begin(); it != z.end(); ++it) {
+            *it = cfloat(1, 2);
+        }
+        nb::TensorArray<cfloat, Ext> w(nb::conj(z)*cfloat(2) + z);
+        if (r(3, 2, 1) != a(3, 2, 1) + v(0, 2, 0) || w(3, 2, 1) != cfloat(3, -2)) {
+            std::cerr << "Error in expr storage: broadcast and accessor leaves\n";
+            ++error_count;
+        }
+    }
+
+    if (error_count == 0) {
+        std::cout << "All tests passed!" << std::endl;
+    } else {
+        std::cout << error_count << " tests failed." << std::endl;
+    }
+    return error_count;
+}
@@ -0,0 +1,173 @@
+#define MDSPAN_DEBUG
+#define MDSPAN_USE_BRACKET_OPERATOR 0
+
+#include <unistd.h>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "mdspan/mdspan.hpp"
+#include "nabla/nabla.hpp"
+
+namespace nb = nabla;
+
+// writes a version 1 .npy file with the given header dict and elements
+template <typename T>
+void write_npy(const std::filesystem::path& path, std::string dict, const std::vector<T>& data) {
+    // the header is padded with spaces and a newline to a multiple of 64 bytes
+    const std::size_t total = (10 + dict.size() + 1 + 63) / 64 * 64;
+    dict.append(total - 10 - dict.size() - 1, ' ');
+    dict.push_back('\n');
+    std::ofstream out(path, std::ios::binary);
+    out.write("\x93NUMPY\x01\x00", 8);
+    const unsigned char length[2] = {static_cast<unsigned char>(dict.size() & 0xff), static_cast<unsigned char>(dict.size() >> 8)};
+    out.write(reinterpret_cast<const char*>(length), 2);
+    out.write(dict.data(), static_cast<std::streamsize>(dict.size()));
+    out.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()*sizeof(T)));
+}
+
+template <typename F>
+bool throws(F&& f) {
+    try {
+        f();
+    } catch (const std::invalid_argument&) {
+        return true;
+    } catch (const std::system_error&) {
+        return true;
+    }
+    return false;
+}
+
+int main() {
+    using Ext = nb::dims<2>;
+    const auto dir = std::filesystem::temp_directory_path() / ("nabla_mmap_" + std::to_string(::getpid()));
+    std::filesystem::create_directories(dir);
+
+    int error_count = 0;
+
+    // 3x4 elements numbered in file order
+    std::vector<double> data(12);
+    for (size_t k = 0; k < data.size(); ++k) {
+        data[k] = static_cast<double>(k);
+    }
+
+    // Fortran order maps onto LeftStride with its default strides
+    {
+        write_npy(dir / "f.npy", "{'descr': '<f8', 'fortran_order': True, 'shape': (3, 4), }", data);
+        auto a = nb::mmap_tensor<const double, Ext>(dir / "f.npy", nb::mmap_advice::sequential);
+        static_assert(std::is_same_v<decltype(a)::accessor_type, nb::shared_accessor<const double>>);
+        size_t mismatches = 0;
+        for (size_t j = 0; j < 4; ++j) {
+            for (size_t i = 0; i < 3; ++i) {
+                mismatches += a(i, j) != static_cast<double>(i + 3*j);
+            }
+        }
+        if (a.extent(0) != 3 || a.extent(1) != 4 || a.stride(0) != 1 || a.stride(1) != 3 || mismatches != 0) {
+            std::cerr << "Error in mmap_tensor: fortran order\n";
+            ++error_count;
+        }
+    }
+
+    // C order gets reversed strides, under LeftStride or RightStride
+    {
+        write_npy(dir / "c.npy", "{'descr': '<f8', 'fortran_order': False, 'shape': (3, 4), }", data);
+        auto a = nb::mmap_tensor<const double, Ext>(dir / "c.npy");
+        auto b = nb::mmap_tensor<const double, Ext, nb::RightStride>(dir / "c.npy", nb::mmap_advice::random);
+        size_t mismatches = 0;
+        for (size_t i = 0; i < 3; ++i) {
+            for (size_t j = 0; j < 4; ++j) {
+                mismatches += a(i, j) != static_cast<double>(4*i + j);
+                mismatches += b(i, j) != a(i, j);
+            }
+        }
+        if (a.stride(0) != 4 || a.stride(1) != 1 || mismatches != 0) {
+            std::cerr << "Error in mmap_tensor: C order\n";
+            ++error_count;
+        }
+    }
+
+    // the mapping outlives the first span and feeds expressions
+    {
+        auto e = [&] {
+            auto a = nb::mmap_tensor<const double, Ext>(dir / "f.npy", nb::mmap_advice::will_need);
+            return a*2.0 + a;
+        }();
+        nb::TensorArray<double, Ext> r(e);
+        if (r(2, 3) != 3*11.0 || r(1, 0) != 3*1.0) {
+            std::cerr << "Error in mmap_tensor: lifetime\n";
+            ++error_count;
+        }
+    }
+
+    // writes through a non-const span reach the file
+    {
+        {
+            auto a = nb::mmap_tensor<double, Ext>(dir / "f.npy");
+            a(1, 2) = -1.0;
+            nb::TensorArray<double, Ext> r(a + 100.0);
+            a = r;
+        }
+        auto b = nb::mmap_tensor<const double, Ext>(dir / "f.npy");
+        if (b(1, 2) != 99.0 || b(0, 0) != 100.0) {
+            std::cerr << "Error in mmap_tensor: writes\n";
+            ++error_count;
+        }
+    }
+
+    // raw files with user extents and a byte offset
+    {
+        std::vector<float> raw(2 + 5*2);
+        for (size_t k = 0; k < raw.size(); ++k) {
+            raw[k] = static_cast<float>(k);
+        }
+        std::ofstream(dir / "raw.bin", std::ios::binary).write(reinterpret_cast<const char*>(raw.data()), raw.size()*sizeof(float));
+        auto a = nb::mmap_tensor<const float>(dir / "raw.bin", Ext(5, 2), 2*sizeof(float));
+        auto b = nb::mmap_tensor<const float, Ext, nb::RightStride>(dir / "raw.bin", Ext(5, 2), 2*sizeof(float));
+        if (a(3, 1) != 2 + 3 + 5.0f || b(3, 1) != 2 + 3*2 + 1.0f) {
+            std::cerr << "Error in mmap_tensor: raw file\n";
+            ++error_count;
+        }
+        if (!throws([&] { nb::mmap_tensor<const float>(dir / "raw.bin", Ext(5, 3)); }) ||
+            !throws([&] { nb::mmap_tensor<const float>(dir / "raw.bin", Ext(5, 2), 1); })) {
+            std::cerr << "Error in mmap_tensor: raw file size and alignment checks\n";
+            ++error_count;
+        }
+    }
+
+    // static extents, 1d shapes and other dtypes
+    {
+        std::vector<int> ints = {5, 6, 7, 8, 9};
+        write_npy(dir / "i.npy", "{'descr': '<i4', 'fortran_order': False, 'shape': (5,), }", ints);
+        auto v = nb::mmap_tensor<const int, nb::extents<size_t, 5>>(dir / "i.npy");
+        if (v(4) != 9) {
+            std::cerr << "Error in mmap_tensor: 1d int\n";
+            ++error_count;
+        }
+    }
+
+    // mismatched files are rejected
+    {
+        bool ok = throws([&] { nb::mmap_tensor<const float, Ext>(dir / "f.npy"); }) &&
+                  throws([&] { nb::mmap_tensor<const double, nb::dims<3>>(dir / "f.npy"); }) &&
+                  throws([&] { nb::mmap_tensor<const double, nb::extents<size_t, 4, std::dynamic_extent>>(dir / "f.npy"); }) &&
+                  throws([&] { nb::mmap_tensor<const double, Ext>(dir / "raw.bin"); }) &&
+                  throws([&] { nb::mmap_tensor<const double, Ext>(dir / "missing.npy"); }) &&
+                  throws([&] { nb::mmap_tensor<const unsigned, nb::dims<1>>(dir / "i.npy"); });
+        write_npy(dir / "short.npy", "{'descr': '<f8', 'fortran_order': True, 'shape': (3, 5), }", data);
+        ok = ok && throws([&] { nb::mmap_tensor<const double, Ext>(dir / "short.npy"); });
+        if (!ok) {
+            std::cerr << "Error in mmap_tensor: validation\n";
+            ++error_count;
+        }
+    }
+
+    std::filesystem::remove_all(dir);
+
+    if (error_count == 0) {
+        std::cout << "All tests passed!" << std::endl;
+    } else {
+        std::cout << error_count << " tests failed." << std::endl;
+    }
+    return error_count;
+}
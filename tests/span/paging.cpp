@@ -0,0 +1,172 @@
+#define MDSPAN_DEBUG
+#define MDSPAN_USE_BRACKET_OPERATOR 0
+
+#include <unistd.h>
+#include <filesystem>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "mdspan/mdspan.hpp"
+#include "nabla/nabla.hpp"
+
+namespace nb = nabla;
+
+template <typename F>
+bool throws(F&& f) {
+    try {
+        f();
+    } catch (const std::invalid_argument&) {
+        return true;
+    } catch (const std::system_error&) {
+        return true;
+    }
+    return false;
+}
+
+template <typename A, typename F>
+size_t mismatches(const A& a, F&& expected) {
+    size_t count = 0;
+    for (size_t k = 0; k < a.extent(2); ++k) {
+        for (size_t j = 0; j < a.extent(1); ++j) {
+            for (size_t i = 0; i < a.extent(0); ++i) {
+                count += a(i, j, k) != expected(i, j, k);
+            }
+        }
+    }
+    return count;
+}
+
+int main() {
+    using Ext = nb::dims<3>;
+    using Array = nb::TensorArray<double, Ext>;
+    const auto dir = std::filesystem::temp_directory_path() / ("nabla_paging_" + std::to_string(::getpid()));
+    std::filesystem::create_directories(dir);
+
+    int error_count = 0;
+
+    // 1 MB in 256 tiles of 4 KB, with room for 16 of them
+    const nb::paging_options options{.tile_size = 4096, .cache_size = 16*4096, .prefetch = 4};
+    Array a(64, 50, 40);
+    auto value = [](size_t i, size_t j, size_t k) { return static_cast<double>(i) + 100.0*j - 0.5*k; };
+    for (size_t k = 0; k < a.extent(2); ++k) {
+        for (size_t j = 0; j < a.extent(1); ++j) {
+            for (size_t i = 0; i < a.extent(0); ++i) {
+                a(i, j, k) = value(i, j, k);
+            }
+        }
+    }
+    nb::write_tensor(dir / "a.nbt", a);
+
+    // element access pages tiles through a bounded cache
+    {
+        auto p = nb::paged_tensor<const double, Ext>(dir / "a.nbt", options);
+        static_assert(std::is_same_v<decltype(p)::reference, double>);
+        const auto& cache = *p.data_handle().cache;
+        size_t errors = mismatches(p, value);
+        // against the traversal order
+        errors += mismatches(nb::permute(p, std::array<size_t, 3>{2, 1, 0}), [&](size_t k, size_t j, size_t i) { return value(i, j, k); });
+        if (errors != 0 || cache.capacity() != 16 || cache.resident() > 16 || cache.tile_elements() != 512) {
+            std::cerr << "Error in paged tensor: element access, " << errors << " mismatches, "
+                      << cache.resident() << " resident tiles\n";
+            ++error_count;
+        }
+    }
+
+    // expressions, subspans and iterators read paged spans unchanged
+    {
+        auto p = nb::paged_tensor<const double, Ext>(dir / "a.nbt", options);
+        Array r(a.extents());
+        r = 2.0*p + a;
+        size_t errors = mismatches(r, [&](size_t i, size_t j, size_t k) { return 3.0*value(i, j, k); });
+        auto s = nb::subspan(p, nb::full_extent, 7, std::pair<size_t, size_t>{10, 30});
+        Array t(a.extents());
+        t.zero();
+        auto u = nb::subspan(t, nb::full_extent, 7, std::pair<size_t, size_t>{10, 30});
+        u = s;
+        errors += t(5, 7, 12) != value(5, 7, 12) || t(5, 8, 12) != 0.0;
+        double sum = 0;
+        for (double x : s) {
+            sum += x;
+        }
+        errors += sum != 20*(63*64/2 + 64*700.0) - 0.5*64*(29*30/2 - 9*10/2);
+        if (errors != 0) {
+            std::cerr << "Error in paged tensor: expressions, " << errors << " mismatches\n";
+            ++error_count;
+        }
+    }
+
+    // assignment into a writable paged span reaches the file through
+    // eviction and flush
+    {
+        {
+            auto w = nb::paged_tensor<double, Ext>(dir / "a.nbt", options);
+            w = a*(-1.0);
+            w(3, 4, 5) += 10.0;
+            w.data_handle().flush();
+            auto q = nb::paged_tensor<const double, Ext>(dir / "a.nbt", options);
+            if (q(3, 4, 5) != 10.0 - value(3, 4, 5) || q(63, 49, 39) != -value(63, 49, 39)) {
+                std::cerr << "Error in paged tensor: flush\n";
+                ++error_count;
+            }
+            w(0, 0, 0) = 42.0;
+        }
+        auto b = nb::read_tensor<Array>(dir / "a.nbt");
+        b(3, 4, 5) -= 10.0;
+        const size_t errors = mismatches(b, [&](size_t i, size_t j, size_t k) { return i + j + k == 0 ? 42.0 : -value(i, j, k); });
+        if (errors != 0) {
+            std::cerr << "Error in paged tensor: write back, " << errors << " mismatches\n";
+            ++error_count;
+        }
+        nb::write_tensor(dir / "a.nbt", a);
+    }
+
+    // parallel readers share the cache; raw files page by the layout's strides
+    {
+        auto p = nb::paged_tensor<const double, Ext>(dir / "a.nbt", options);
+        std::vector<size_t> errors(4, 0);
+        std::vector<std::thread> threads;
+        for (size_t n = 0; n < errors.size(); ++n) {
+            threads.emplace_back([&, n] {
+                for (size_t k = n; k < 40; k += errors.size()) {
+                    for (size_t j = 0; j < 50; ++j) {
+                        for (size_t i = 0; i < 64; ++i) {
+                            errors[n] += p(i, j, k) != value(i, j, k);
+                        }
+                    }
+                }
+            });
+        }
+        for (auto& t : threads) {
+            t.join();
+        }
+        auto raw = nb::paged_tensor<const double, nb::dims<2>>(dir / "a.nbt", nb::dims<2>(64, 2000), 4096, {.tile_size = 1000});
+        const bool ok = errors == std::vector<size_t>(4, 0) && raw(5, 103) == value(5, 3, 2) && raw.data_handle().cache->tile_elements() == 125;
+        if (!ok) {
+            std::cerr << "Error in paged tensor: threads and raw files\n";
+            ++error_count;
+        }
+    }
+
+    // mismatched files are rejected
+    {
+        bool ok = throws([&] { nb::paged_tensor<const float, Ext>(dir / "a.nbt"); }) &&
+                  throws([&] { nb::paged_tensor<const double, nb::dims<2>>(dir / "a.nbt"); }) &&
+                  throws([&] { nb::paged_tensor<const double, nb::extents<size_t, 65, std::dynamic_extent, std::dynamic_extent>>(dir / "a.nbt"); }) &&
+                  throws([&] { nb::paged_tensor<const double, nb::dims<2>>(dir / "a.nbt", nb::dims<2>(64, 3000)); }) &&
+                  throws([&] { nb::paged_tensor<const double, Ext>(dir / "missing.nbt"); });
+        if (!ok) {
+            std::cerr << "Error in paged tensor: validation\n";
+            ++error_count;
+        }
+    }
+
+    std::filesystem::remove_all(dir);
+
+    if (error_count == 0) {
+        std::cout << "All tests passed!" << std::endl;
+    } else {
+        std::cout << error_count << " tests failed." << std::endl;
+    }
+    return error_count;
+}
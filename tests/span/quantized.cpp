@@ -0,0 +1,194 @@
+#define MDSPAN_DEBUG
+#define MDSPAN_USE_BRACKET_OPERATOR 0
+
+#include <cmath>
+#include <cstdint>
+#include <iostream>
+#include <limits>
+#include <vector>
+#include "mdspan/mdspan.hpp"
+#include "nabla/nabla.hpp"
+
+namespace nb = nabla;
+
+template <typename F>
+bool throws(F&& f) {
+    try {
+        f();
+    } catch (const std::invalid_argument&) {
+        return true;
+    }
+    return false;
+}
+
+int main() {
+    using Ext = nb::dims<2>;
+    using Array = nb::TensorArray<float, Ext>;
+    using Map = nb::LeftStride::mapping<Ext>;
+
+    int error_count = 0;
+
+    Array a(37, 11);
+    for (size_t j = 0; j < a.extent(1); ++j) {
+        for (size_t i = 0; i < a.extent(0); ++i) {
+            a(i, j) = std::sin(0.3f * i) * (1.0f + j);
+        }
+    }
+
+    // per tensor: bulk and elementwise quantization agree, reads are within
+    // half a level
+    {
+        const nb::quantization<float> q{0.1f, 3};
+        std::vector<std::int8_t> bulk(a.size()), elementwise(a.size());
+        auto x = nb::quantized_span<float, Ext>(bulk.data(), Map({37, 11}), q);
+        auto y = nb::quantized_span<float, Ext>(elementwise.data(), Map({37, 11}), q);
+        nb::quantize(x, a);
+        y = a;
+        if (bulk != elementwise) {
+            std::cerr << "Error in quantize: bulk and elementwise quantization differ\n";
+            ++error_count;
+        }
+        size_t off = 0;
+        for (size_t j = 0; j < a.extent(1); ++j) {
+            for (size_t i = 0; i < a.extent(0); ++i) {
+                const float level = std::nearbyint(a(i, j) / q.scale) + q.zero_point;
+                const float expected = level > 127 ? (127 - q.zero_point) * q.scale : a(i, j);
+                off += std::abs(x(i, j) - expected) > 0.5f * q.scale + 1e-6f;
+            }
+        }
+        if (off != 0) {
+            std::cerr << "Error in quantize: " << off << " elements off by more than half a level\n";
+            ++error_count;
+        }
+
+        Array b(37, 11), c(37, 11);
+        nb::dequantize(b, x);
+        c = x;
+        if (nb::sum((b - c)*(b - c)) != 0.0f) {
+            std::cerr << "Error in dequantize: bulk and elementwise dequantization differ\n";
+            ++error_count;
+        }
+        if (nb::sum(x * 2.0f) != nb::sum(c * 2.0f)) {
+            std::cerr << "Error in quantized expression\n";
+            ++error_count;
+        }
+    }
+
+    // element writes round to the nearest level and saturate
+    {
+        std::vector<std::int16_t> store(4);
+        auto x = nb::quantized_span<double, nb::dims<1>>(store.data(), nb::LeftStride::mapping<nb::dims<1>>(nb::dims<1>(4)), {0.5, -2});
+        x(0) = 1.2;
+        x(1) = 1e9;
+        x(2) = -1e9;
+        // -0.5 rounds half to even
+        x(3) = 0.75;
+        const auto halfway = store[3];
+        x(3) += 0.5;
+        if (store[0] != 0 || store[1] != 32767 || store[2] != -32768 || halfway != 0 || store[3] != 1) {
+            std::cerr << "Error in element writes: got " << store[0] << " " << store[1] << " " << store[2] << " " << store[3] << "\n";
+            ++error_count;
+        }
+        if (x(0) != 1.0 || x(3) != 1.5) {
+            std::cerr << "Error in element reads: got " << x(0) << " " << x(3) << "\n";
+            ++error_count;
+        }
+    }
+
+    // NaN saturates to the lowest level, in element writes and in bulk
+    {
+        const float nan = std::numeric_limits<float>::quiet_NaN();
+        std::vector<std::int8_t> store(3, 5), bulk(3, 5);
+        auto x = nb::quantized_span<float, nb::dims<1>>(store.data(), nb::LeftStride::mapping<nb::dims<1>>(nb::dims<1>(3)), {0.1f, 0});
+        auto y = nb::quantized_span<float, nb::dims<1>>(bulk.data(), nb::LeftStride::mapping<nb::dims<1>>(nb::dims<1>(3)), {0.1f, 0});
+        x(1) = nan;
+        nb::TensorArray<float, nb::dims<1>> v(3);
+        v(0) = 0.5f;
+        v(1) = nan;
+        v(2) = -0.5f;
+        nb::quantize(y, v);
+        if (store[1] != -128 || bulk[1] != -128 || bulk[0] != 5 || bulk[2] != -5) {
+            std::cerr << "Error in NaN writes: got " << int(store[1]) << " " << int(bulk[0]) << " " << int(bulk[1]) << " " << int(bulk[2]) << "\n";
+            ++error_count;
+        }
+    }
+
+    // per channel along either axis, through subspans
+    for (size_t axis : {0, 1}) {
+        std::vector<nb::quantization<float>> channels;
+        for (size_t c = 0; c < a.extent(axis); ++c) {
+            channels.push_back({0.01f * (1 + c), static_cast<std::int32_t>(c % 5) - 2});
+        }
+        std::vector<std::int8_t> bulk(a.size()), elementwise(a.size());
+        auto x = nb::quantized_span<float, Ext>(bulk.data(), Map({37, 11}), channels, axis);
+        auto y = nb::quantized_span<float, Ext>(elementwise.data(), Map({37, 11}), channels, axis);
+        nb::quantize(x, a);
+        y = a;
+        if (bulk != elementwise) {
+            std::cerr << "Error in quantize per channel " << axis << ": bulk and elementwise quantization differ\n";
+            ++error_count;
+        }
+        size_t off = 0;
+        for (size_t j = 0; j < a.extent(1); ++j) {
+            for (size_t i = 0; i < a.extent(0); ++i) {
+                const auto& q = channels[axis == 0 ? i : j];
+                const float level = std::nearbyint(a(i, j) / q.scale) + q.zero_point;
+                if (level >= -128 && level <= 127) {
+                    off += std::abs(x(i, j) - a(i, j)) > 0.5f * q.scale + 1e-6f;
+                }
+            }
+        }
+        if (off != 0) {
+            std::cerr << "Error in quantize per channel " << axis << ": " << off << " elements off by more than half a level\n";
+            ++error_count;
+        }
+        Array d(37, 11);
+        nb::dequantize(d, x);
+        if (nb::sum(x * 2.0f) != nb::sum(d * 2.0f)) {
+            std::cerr << "Error in quantized expression per channel " << axis << "\n";
+            ++error_count;
+        }
+
+        auto sx = nb::subspan(x, std::pair{3, 20}, std::pair{2, 9});
+        auto sa = nb::subspan(a, std::pair{3, 20}, std::pair{2, 9});
+        Array b(17, 7), c(17, 7);
+        nb::dequantize(b, sx);
+        size_t wrong = 0;
+        for (size_t j = 0; j < sx.extent(1); ++j) {
+            for (size_t i = 0; i < sx.extent(0); ++i) {
+                wrong += b(i, j) != x(i + 3, j + 2);
+            }
+        }
+        if (wrong != 0) {
+            std::cerr << "Error in dequantize subspan per channel " << axis << ": " << wrong << " elements differ\n";
+            ++error_count;
+        }
+        std::vector<std::int8_t> copy = bulk;
+        nb::quantize(sx, sa*1.0f);
+        if (copy != bulk) {
+            std::cerr << "Error in quantize subspan per channel " << axis << ": elements changed\n";
+            ++error_count;
+        }
+    }
+
+    // channels must match the extent of the axis
+    {
+        std::vector<std::int8_t> store(a.size());
+        std::vector<nb::quantization<float>> channels(5);
+        if (!throws([&] { nb::quantized_span<float, Ext>(store.data(), Map({37, 11}), channels, 1); })) {
+            std::cerr << "Error in quantized_span: expected std::invalid_argument for 5 channels\n";
+            ++error_count;
+        }
+        if (!throws([&] { nb::quantized_span<float, Ext>(store.data(), Map({37, 11}), channels, 2); })) {
+            std::cerr << "Error in quantized_span: expected std::invalid_argument for axis 2\n";
+            ++error_count;
+        }
+    }
+
+    if (error_count == 0) {
+        std::cout << "All tests passed!" << std::endl;
+    } else {
+        std::cout << error_count << " tests failed." << std::endl;
+    }
+    return error_count;
+}
@@ -83,6 +83,26 @@ int test_assignment(TensorT& mat1, TensorT& mat2) {
     return 0;
 }
 
+template <typename TensorT>
+int test_random_access(TensorT& mat) {
+    static_assert(std::random_access_iterator<typename TensorT::iterator_type>);
+    auto first = mat.begin();
+    auto last = mat.end();
+    if (last - first != static_cast<std::ptrdiff_t>(mat.size())) {
+        std::cerr << "Error in iterator distance\n";
+        return 1;
+    }
+    auto mid = first + (last - first) / 2;
+    size_t i = 0;
+    for (auto it = first; it != mid; ++it, ++i) {
+        if (&*it != &first[i]) {
+            std::cerr << "Error in iterator subscript at " << i << "\n";
+            return 1;
+        }
+    }
+    return 0;
+}
+
 int main() {
     using Layout = nb::LeftStride;
     using TensorType = nb::TensorSpan<int, nb::dims<2>, Layout>;
@@ -97,6 +117,7 @@ int main() {
     int error_count = 0;
     error_count += test_access(mat1);
     error_count += test_assignment(mat1, mat2);
+    error_count += test_random_access(mat1);
 
     if (error_count == 0) {
         std::cout << "All tests passed!" << std::endl;